@@ -21,4 +21,8 @@ pushd tests
 call .\run.bat
 popd
 
+pushd tools\memtrace
+call .\run.bat
+popd
+
 pause
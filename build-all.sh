@@ -15,3 +15,7 @@ popd
 pushd tests
 ./run.sh
 popd
+
+pushd tools/memtrace
+./run.sh
+popd
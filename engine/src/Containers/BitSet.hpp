@@ -0,0 +1,454 @@
+#ifndef _FLATEARTH_ENGINE_BIT_SET_HPP
+#define _FLATEARTH_ENGINE_BIT_SET_HPP
+
+#include "ContainerAllocator.hpp"
+#include "DArray.hpp"
+#include "Core/Logger.hpp"
+#include "Definitions.hpp"
+#include <bit>
+#include <cstdint>
+
+namespace flatearth {
+namespace containers {
+
+constexpr uint64 BITSET_WORD_BITS = 64;
+// Returned by the Find methods when no bit is set
+constexpr uint64 BITSET_NOT_FOUND = UINT64_MAX;
+
+constexpr uint64 BitSetWordCount(uint64 bits) {
+  return (bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+}
+
+// Scans shared by both bit sets. They work a 64 bit word at a time, popcount
+// and tzcnt do the per bit work when the target has them.
+struct BitSetWords {
+  static constexpr uint64 Count(const uint64 *words, uint64 wordCount) {
+    uint64 count = 0;
+    for (uint64 i = 0; i < wordCount; i++) {
+      count += std::popcount(words[i]);
+    }
+    return count;
+  }
+
+  static constexpr bool Any(const uint64 *words, uint64 wordCount) {
+    uint64 any = 0;
+    for (uint64 i = 0; i < wordCount; i++) {
+      any |= words[i];
+    }
+    return any != 0;
+  }
+
+  static constexpr uint64 FindNextSet(const uint64 *words, uint64 wordCount,
+                                      uint64 from) {
+    uint64 w = from / BITSET_WORD_BITS;
+    if (w >= wordCount) {
+      return BITSET_NOT_FOUND;
+    }
+
+    uint64 word = words[w] & (~0ull << (from % BITSET_WORD_BITS));
+    while (word == 0) {
+      if (++w == wordCount) {
+        return BITSET_NOT_FOUND;
+      }
+      word = words[w];
+    }
+
+    return w * BITSET_WORD_BITS + std::countr_zero(word);
+  }
+
+  template <typename Function>
+  static constexpr void ForEachSetBit(const uint64 *words, uint64 wordCount,
+                                      Function &&function) {
+    for (uint64 w = 0; w < wordCount; w++) {
+      for (uint64 word = words[w]; word != 0; word &= word - 1) {
+        function(w * BITSET_WORD_BITS + std::countr_zero(word));
+      }
+    }
+  }
+
+  // Bits past the size in the last word are kept cleared
+  static constexpr uint64 TailMask(uint64 bits) {
+    uint64 used = bits % BITSET_WORD_BITS;
+    return used == 0 ? ~0ull : (1ull << used) - 1;
+  }
+};
+
+// Fixed size bit set stored inline, it never allocates and is trivially
+// copyable, so it can live in plain state structs.
+template <uint64 Bits> class SBitSet {
+public:
+  STATIC_ASSERT(Bits > 0, "Cannot create 0-sized bit set");
+
+  static constexpr uint64 SBITSET_WORD_COUNT = BitSetWordCount(Bits);
+
+  constexpr uint64 GetSize() const noexcept { return Bits; }
+
+  constexpr bool Test(uint64 index) const;
+  constexpr void Set(uint64 index);
+  constexpr void Set(uint64 index, bool value);
+  constexpr void Reset(uint64 index);
+  constexpr void Flip(uint64 index);
+  constexpr void SetAll();
+  constexpr void ResetAll();
+
+  constexpr uint64 Count() const;
+  constexpr bool Any() const;
+  constexpr bool None() const;
+  constexpr uint64 FindFirstSet() const;
+  // First set bit at or after from
+  constexpr uint64 FindNextSet(uint64 from) const;
+  // Calls function(uint64 index) for every set bit in increasing order
+  template <typename Function>
+  constexpr void ForEachSetBit(Function &&function) const;
+
+  constexpr SBitSet &operator&=(const SBitSet &other);
+  constexpr SBitSet &operator|=(const SBitSet &other);
+  constexpr SBitSet &operator^=(const SBitSet &other);
+  constexpr bool operator==(const SBitSet &other) const = default;
+
+  constexpr const uint64 *Data() const noexcept { return _words; }
+  constexpr uint64 GetWordCount() const noexcept { return SBITSET_WORD_COUNT; }
+
+private:
+  uint64 _words[SBITSET_WORD_COUNT] = {};
+};
+
+// Bit set sized at runtime, its words live in a DArray.
+template <typename Allocator = DArrayDefaultAllocator> class DBitSet {
+public:
+  explicit DBitSet(uint64 size = 0, const Allocator &allocator = Allocator());
+  ~DBitSet() = default;
+
+  DBitSet(const DBitSet &) = delete;
+  DBitSet &operator=(const DBitSet &) = delete;
+
+  uint64 GetSize() const { return _size; }
+  // Bits added are cleared
+  void Resize(uint64 size);
+
+  bool Test(uint64 index) const;
+  void Set(uint64 index);
+  void Set(uint64 index, bool value);
+  void Reset(uint64 index);
+  void Flip(uint64 index);
+  void SetAll();
+  void ResetAll();
+
+  uint64 Count() const;
+  bool Any() const;
+  bool None() const;
+  uint64 FindFirstSet() const;
+  // First set bit at or after from
+  uint64 FindNextSet(uint64 from) const;
+  // Calls function(uint64 index) for every set bit in increasing order
+  template <typename Function> void ForEachSetBit(Function &&function) const;
+
+  // Both sets must have the same size
+  DBitSet &operator&=(const DBitSet &other);
+  DBitSet &operator|=(const DBitSet &other);
+  DBitSet &operator^=(const DBitSet &other);
+  bool operator==(const DBitSet &other) const;
+
+  const uint64 *Data() const noexcept { return _words.Data(); }
+  uint64 GetWordCount() const { return _words.GetLength(); }
+
+private:
+  bool CheckSize(const DBitSet &other, const char *method) const;
+
+  DArray<uint64, Allocator> _words;
+  uint64 _size;
+};
+
+// SBitSet
+
+template <uint64 Bits>
+constexpr bool SBitSet<Bits>::Test(uint64 index) const {
+  if (index >= Bits) {
+    FERROR("SBitSet<Bits>::Test(): index out of bounds");
+    return FeFalse;
+  }
+
+  return (_words[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+}
+
+template <uint64 Bits> constexpr void SBitSet<Bits>::Set(uint64 index) {
+  if (index >= Bits) {
+    FERROR("SBitSet<Bits>::Set(): index out of bounds");
+    return;
+  }
+
+  _words[index / BITSET_WORD_BITS] |= 1ull << (index % BITSET_WORD_BITS);
+}
+
+template <uint64 Bits>
+constexpr void SBitSet<Bits>::Set(uint64 index, bool value) {
+  if (value) {
+    Set(index);
+  } else {
+    Reset(index);
+  }
+}
+
+template <uint64 Bits> constexpr void SBitSet<Bits>::Reset(uint64 index) {
+  if (index >= Bits) {
+    FERROR("SBitSet<Bits>::Reset(): index out of bounds");
+    return;
+  }
+
+  _words[index / BITSET_WORD_BITS] &= ~(1ull << (index % BITSET_WORD_BITS));
+}
+
+template <uint64 Bits> constexpr void SBitSet<Bits>::Flip(uint64 index) {
+  if (index >= Bits) {
+    FERROR("SBitSet<Bits>::Flip(): index out of bounds");
+    return;
+  }
+
+  _words[index / BITSET_WORD_BITS] ^= 1ull << (index % BITSET_WORD_BITS);
+}
+
+template <uint64 Bits> constexpr void SBitSet<Bits>::SetAll() {
+  for (uint64 i = 0; i < SBITSET_WORD_COUNT; i++) {
+    _words[i] = ~0ull;
+  }
+  _words[SBITSET_WORD_COUNT - 1] &= BitSetWords::TailMask(Bits);
+}
+
+template <uint64 Bits> constexpr void SBitSet<Bits>::ResetAll() {
+  for (uint64 i = 0; i < SBITSET_WORD_COUNT; i++) {
+    _words[i] = 0;
+  }
+}
+
+template <uint64 Bits> constexpr uint64 SBitSet<Bits>::Count() const {
+  return BitSetWords::Count(_words, SBITSET_WORD_COUNT);
+}
+
+template <uint64 Bits> constexpr bool SBitSet<Bits>::Any() const {
+  return BitSetWords::Any(_words, SBITSET_WORD_COUNT);
+}
+
+template <uint64 Bits> constexpr bool SBitSet<Bits>::None() const {
+  return !Any();
+}
+
+template <uint64 Bits> constexpr uint64 SBitSet<Bits>::FindFirstSet() const {
+  return BitSetWords::FindNextSet(_words, SBITSET_WORD_COUNT, 0);
+}
+
+template <uint64 Bits>
+constexpr uint64 SBitSet<Bits>::FindNextSet(uint64 from) const {
+  return BitSetWords::FindNextSet(_words, SBITSET_WORD_COUNT, from);
+}
+
+template <uint64 Bits>
+template <typename Function>
+constexpr void SBitSet<Bits>::ForEachSetBit(Function &&function) const {
+  BitSetWords::ForEachSetBit(_words, SBITSET_WORD_COUNT, function);
+}
+
+template <uint64 Bits>
+constexpr SBitSet<Bits> &SBitSet<Bits>::operator&=(const SBitSet &other) {
+  for (uint64 i = 0; i < SBITSET_WORD_COUNT; i++) {
+    _words[i] &= other._words[i];
+  }
+  return *this;
+}
+
+template <uint64 Bits>
+constexpr SBitSet<Bits> &SBitSet<Bits>::operator|=(const SBitSet &other) {
+  for (uint64 i = 0; i < SBITSET_WORD_COUNT; i++) {
+    _words[i] |= other._words[i];
+  }
+  return *this;
+}
+
+template <uint64 Bits>
+constexpr SBitSet<Bits> &SBitSet<Bits>::operator^=(const SBitSet &other) {
+  for (uint64 i = 0; i < SBITSET_WORD_COUNT; i++) {
+    _words[i] ^= other._words[i];
+  }
+  return *this;
+}
+
+// DBitSet
+
+template <typename Allocator>
+DBitSet<Allocator>::DBitSet(uint64 size, const Allocator &allocator)
+    : _words(allocator), _size(0) {
+  Resize(size);
+}
+
+template <typename Allocator> void DBitSet<Allocator>::Resize(uint64 size) {
+  // Clear the bits dropped from the last kept word, growing back must not
+  // bring them back
+  if (size < _size && size % BITSET_WORD_BITS != 0) {
+    _words[size / BITSET_WORD_BITS] &= BitSetWords::TailMask(size);
+  }
+
+  _words.SetLength(BitSetWordCount(size));
+  _size = size;
+}
+
+template <typename Allocator>
+bool DBitSet<Allocator>::Test(uint64 index) const {
+  if (index >= _size) {
+    FERROR("DBitSet::Test(): index out of bounds");
+    return FeFalse;
+  }
+
+  return (_words.Data()[index / BITSET_WORD_BITS] >>
+          (index % BITSET_WORD_BITS)) &
+         1;
+}
+
+template <typename Allocator> void DBitSet<Allocator>::Set(uint64 index) {
+  if (index >= _size) {
+    FERROR("DBitSet::Set(): index out of bounds");
+    return;
+  }
+
+  _words.Data()[index / BITSET_WORD_BITS] |= 1ull
+                                             << (index % BITSET_WORD_BITS);
+}
+
+template <typename Allocator>
+void DBitSet<Allocator>::Set(uint64 index, bool value) {
+  if (value) {
+    Set(index);
+  } else {
+    Reset(index);
+  }
+}
+
+template <typename Allocator> void DBitSet<Allocator>::Reset(uint64 index) {
+  if (index >= _size) {
+    FERROR("DBitSet::Reset(): index out of bounds");
+    return;
+  }
+
+  _words.Data()[index / BITSET_WORD_BITS] &=
+      ~(1ull << (index % BITSET_WORD_BITS));
+}
+
+template <typename Allocator> void DBitSet<Allocator>::Flip(uint64 index) {
+  if (index >= _size) {
+    FERROR("DBitSet::Flip(): index out of bounds");
+    return;
+  }
+
+  _words.Data()[index / BITSET_WORD_BITS] ^= 1ull
+                                             << (index % BITSET_WORD_BITS);
+}
+
+template <typename Allocator> void DBitSet<Allocator>::SetAll() {
+  uint64 wordCount = _words.GetLength();
+  if (wordCount == 0) {
+    return;
+  }
+
+  uint64 *words = _words.Data();
+  for (uint64 i = 0; i < wordCount; i++) {
+    words[i] = ~0ull;
+  }
+  words[wordCount - 1] &= BitSetWords::TailMask(_size);
+}
+
+template <typename Allocator> void DBitSet<Allocator>::ResetAll() {
+  uint64 *words = _words.Data();
+  for (uint64 i = 0; i < _words.GetLength(); i++) {
+    words[i] = 0;
+  }
+}
+
+template <typename Allocator> uint64 DBitSet<Allocator>::Count() const {
+  return BitSetWords::Count(_words.Data(), _words.GetLength());
+}
+
+template <typename Allocator> bool DBitSet<Allocator>::Any() const {
+  return BitSetWords::Any(_words.Data(), _words.GetLength());
+}
+
+template <typename Allocator> bool DBitSet<Allocator>::None() const {
+  return !Any();
+}
+
+template <typename Allocator> uint64 DBitSet<Allocator>::FindFirstSet() const {
+  return BitSetWords::FindNextSet(_words.Data(), _words.GetLength(), 0);
+}
+
+template <typename Allocator>
+uint64 DBitSet<Allocator>::FindNextSet(uint64 from) const {
+  return BitSetWords::FindNextSet(_words.Data(), _words.GetLength(), from);
+}
+
+template <typename Allocator>
+template <typename Function>
+void DBitSet<Allocator>::ForEachSetBit(Function &&function) const {
+  BitSetWords::ForEachSetBit(_words.Data(), _words.GetLength(), function);
+}
+
+template <typename Allocator>
+DBitSet<Allocator> &DBitSet<Allocator>::operator&=(const DBitSet &other) {
+  if (CheckSize(other, "operator&=")) {
+    uint64 *words = _words.Data();
+    for (uint64 i = 0; i < _words.GetLength(); i++) {
+      words[i] &= other._words.Data()[i];
+    }
+  }
+  return *this;
+}
+
+template <typename Allocator>
+DBitSet<Allocator> &DBitSet<Allocator>::operator|=(const DBitSet &other) {
+  if (CheckSize(other, "operator|=")) {
+    uint64 *words = _words.Data();
+    for (uint64 i = 0; i < _words.GetLength(); i++) {
+      words[i] |= other._words.Data()[i];
+    }
+  }
+  return *this;
+}
+
+template <typename Allocator>
+DBitSet<Allocator> &DBitSet<Allocator>::operator^=(const DBitSet &other) {
+  if (CheckSize(other, "operator^=")) {
+    uint64 *words = _words.Data();
+    for (uint64 i = 0; i < _words.GetLength(); i++) {
+      words[i] ^= other._words.Data()[i];
+    }
+  }
+  return *this;
+}
+
+template <typename Allocator>
+bool DBitSet<Allocator>::operator==(const DBitSet &other) const {
+  if (_size != other._size) {
+    return FeFalse;
+  }
+
+  for (uint64 i = 0; i < _words.GetLength(); i++) {
+    if (_words.Data()[i] != other._words.Data()[i]) {
+      return FeFalse;
+    }
+  }
+  return FeTrue;
+}
+
+// PRIVATE
+
+template <typename Allocator>
+bool DBitSet<Allocator>::CheckSize(const DBitSet &other,
+                                   const char *method) const {
+  if (_size != other._size) {
+    FERROR("DBitSet::%s: sizes differ (%llu and %llu bits)", method, _size,
+           other._size);
+    return FeFalse;
+  }
+  return FeTrue;
+}
+
+} // namespace containers
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_BIT_SET_HPP
@@ -0,0 +1,160 @@
+#ifndef _FLATEARTH_ENGINE_CONTAINER_ALLOCATOR_HPP
+#define _FLATEARTH_ENGINE_CONTAINER_ALLOCATOR_HPP
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Definitions.hpp"
+#include "Memory/PoolAllocator.hpp"
+
+namespace flatearth {
+namespace containers {
+
+// Containers get their memory from an allocator policy, a small object copied
+// into every container using it. A policy provides:
+//
+//   void *Allocate(uint64 size, uint64 alignment, uint32 flags);
+//   void *Reallocate(void *block, uint64 size, uint64 newSize,
+//                    uint64 alignment, uint32 flags);
+//   void Free(void *block, uint64 size, uint64 alignment);
+//
+// flags are core::memory::AllocationFlags. Reallocate keeps the first
+// min(size, newSize) bytes and only applies the flags to the added ones. On
+// failure Allocate and Reallocate return nullptr, leaving the block alone.
+
+// Blocks come from the MemoryManager under a tag chosen at compile time
+template <core::memory::MemoryTag Tag> class TaggedAllocator {
+public:
+  static constexpr core::memory::MemoryTag ALLOCATOR_TAG = Tag;
+
+  void *Allocate(uint64 size, uint64 alignment, uint32 flags) {
+    return core::memory::MemoryManager::Allocate(size, alignment, Tag, flags);
+  }
+
+  void *Reallocate(void *block, uint64 size, uint64 newSize, uint64 alignment,
+                   uint32 flags) {
+    return core::memory::MemoryManager::Reallocate(block, size, newSize,
+                                                   alignment, Tag, flags);
+  }
+
+  void Free(void *block, uint64 size, uint64 alignment) {
+    core::memory::MemoryManager::Free(block, size, alignment, Tag);
+  }
+};
+
+// Bumps blocks out of a LinearAllocator, StackAllocator or FrameAllocator.
+// Free does nothing, the memory comes back when the arena is reset, so
+// containers using it must be destroyed before that
+template <typename Arena> class ArenaAllocator {
+public:
+  ArenaAllocator(Arena *arena) : _arena(arena) {}
+
+  void *Allocate(uint64 size, uint64 alignment, uint32 flags) {
+    void *block = _arena->Allocate(size, alignment);
+    core::memory::MemoryManager::InitializeMemory(block, size, flags);
+    return block;
+  }
+
+  // The old block stays in the arena until it is reset
+  void *Reallocate(void *block, uint64 size, uint64 newSize, uint64 alignment,
+                   uint32 flags) {
+    void *newBlock = _arena->Allocate(newSize, alignment);
+    if (!newBlock) {
+      return nullptr;
+    }
+
+    core::memory::MemoryManager::CopyMemory(newBlock, block,
+                                            size < newSize ? size : newSize);
+    if (newSize > size) {
+      core::memory::MemoryManager::InitializeMemory(
+          static_cast<uchar *>(newBlock) + size, newSize - size, flags);
+    }
+
+    return newBlock;
+  }
+
+  void Free([[maybe_unused]] void *block, [[maybe_unused]] uint64 size,
+            [[maybe_unused]] uint64 alignment) {}
+
+  Arena *GetArena() const { return _arena; }
+
+private:
+  Arena *_arena;
+};
+
+// Hands out whole pool blocks, so containers never grow past the pool block
+// size but grow in place up to it. Meant for many short arrays of bounded
+// length
+class PoolBlockAllocator {
+public:
+  PoolBlockAllocator(memory::PoolAllocator *pool) : _pool(pool) {}
+
+  void *Allocate(uint64 size, uint64 alignment, uint32 flags) {
+    if (size > _pool->GetBlockSize() || alignment > _pool->GetAlignment()) {
+      FERROR("PoolBlockAllocator::Allocate(): %lluB aligned to %llu does not "
+             "fit in a %lluB pool block",
+             size, alignment, _pool->GetBlockSize());
+      return nullptr;
+    }
+
+    void *block = _pool->Allocate();
+    core::memory::MemoryManager::InitializeMemory(block, size, flags);
+    return block;
+  }
+
+  void *Reallocate(void *block, uint64 size, uint64 newSize,
+                   [[maybe_unused]] uint64 alignment, uint32 flags) {
+    if (newSize > _pool->GetBlockSize()) {
+      FERROR("PoolBlockAllocator::Reallocate(): %lluB does not fit in a %lluB "
+             "pool block",
+             newSize, _pool->GetBlockSize());
+      return nullptr;
+    }
+
+    if (newSize > size) {
+      core::memory::MemoryManager::InitializeMemory(
+          static_cast<uchar *>(block) + size, newSize - size, flags);
+    }
+
+    return block;
+  }
+
+  void Free(void *block, [[maybe_unused]] uint64 size,
+            [[maybe_unused]] uint64 alignment) {
+    _pool->Free(block);
+  }
+
+  memory::PoolAllocator *GetPool() const { return _pool; }
+
+private:
+  memory::PoolAllocator *_pool;
+};
+
+// Gives a container block back to its allocator. Deriving from the allocator
+// keeps stateless ones from taking any room in the owning pointer
+template <typename Allocator> class AllocatorDeleter : private Allocator {
+public:
+  AllocatorDeleter(const Allocator &allocator, uint64 allocatedSize,
+                   uint64 alignment)
+      : Allocator(allocator),
+        _packed(core::memory::PackAllocation(
+            allocatedSize, core::memory::MEMORY_TAG_UNKNOWN, alignment)) {}
+
+  void operator()(void *ptr) {
+    if (ptr) {
+      Allocator::Free(ptr, core::memory::PackedSize(_packed),
+                      core::memory::PackedAlignment(_packed));
+    }
+  }
+
+  Allocator &GetAllocator() { return *this; }
+  const Allocator &GetAllocator() const { return *this; }
+
+private:
+  // The tag bits are unused, the allocator knows where the block goes
+  uint64 _packed;
+};
+
+} // namespace containers
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_CONTAINER_ALLOCATOR_HPP
@@ -1,21 +1,42 @@
 #ifndef _FLATEARTH_ENGINE_DYNAMIC_ARRAY_HPP
 #define _FLATEARTH_ENGINE_DYNAMIC_ARRAY_HPP
 
+#include "ContainerAllocator.hpp"
 #include "Core/FeMemory.hpp"
 #include "Core/Logger.hpp"
 #include "Definitions.hpp"
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <stdexcept>
+#include <type_traits>
 
 namespace flatearth {
 namespace containers {
 
+// Types whose objects can be moved to a new address with a plain memcpy,
+// without running a move constructor and destructor. Specialize it for types
+// that are relocatable without being trivially copyable.
 template <typename T>
-using unique_darray_ptr =
-    std::unique_ptr<void, core::memory::StatefulCustomDeleter<T>>;
+struct IsTriviallyRelocatable
+    : std::bool_constant<std::is_trivially_copyable_v<T>> {};
 
-template <typename T> class DArray {
+template <typename T>
+constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+using DArrayDefaultAllocator = TaggedAllocator<core::memory::MEMORY_TAG_DARRAY>;
+
+template <typename Allocator = DArrayDefaultAllocator>
+using unique_darray_ptr = std::unique_ptr<void, AllocatorDeleter<Allocator>>;
+
+STATIC_ASSERT(sizeof(unique_darray_ptr<>) == 2 * sizeof(void *),
+              "Expected the default DArray storage to be two words wide");
+
+// Allocator is a container allocator policy (see ContainerAllocator.hpp).
+// Arrays built during a frame can point it at scratch memory, e.g.
+// DArray<T, ArenaAllocator<memory::FrameAllocator>>
+template <typename T, typename Allocator = DArrayDefaultAllocator>
+class DArray {
 public:
   // Constants
   static constexpr uint64 DARRAY_DEFAULT_SIZE = 1;
@@ -24,26 +45,40 @@ public:
 
   DArray(uint64 stride = sizeof(T));
   DArray(uint64 capacity, uint64 stride = sizeof(T));
+  explicit DArray(const Allocator &allocator,
+                  uint64 capacity = DARRAY_DEFAULT_SIZE,
+                  uint64 stride = sizeof(T));
   ~DArray();
 
+  Allocator &GetAllocator();
+
   uint64 GetCapacity() const;
   void SetCapacity(uint64 capacity);
 
   uint64 GetLength() const;
+  // Grows or shrinks the array, new elements are value-initialized
   void SetLength(uint64 length);
 
   uint64 GetStride() const;
   void SetStride(uint64 stride);
 
+  // Only grows the capacity, the length is left untouched
   void Reserve(uint64 numOfElements);
 
   void Resize();
 
   void Push(const T &element);
+  void Push(T &&element);
+  template <typename... Args> T &Emplace(Args &&...args);
   void Pop();
+  // Copies count elements at the end of the array
+  void Append(const T *first, uint64 count);
 
   void InsertAt(const T &element, uint64 index);
   void PopAt(uint64 index);
+  // Removes in O(1) by moving the last element into the hole, does not keep
+  // the order
+  void PopAtSwap(uint64 index);
   void Clear();
 
   T *Data() noexcept;
@@ -58,140 +93,126 @@ public:
 
 private:
   void InitializeMemory();
+  void Grow(uint64 newCapacity);
   T *GetAddressOf(uint64 index) noexcept;
   const T *GetAddressOf(uint64 index) const noexcept;
 
   uint64 _capacity;
   uint64 _length;
   uint64 _stride;
-  unique_darray_ptr<T> _array;
+  unique_darray_ptr<Allocator> _array;
 };
 
-template <typename T>
-DArray<T>::DArray(uint64 stride)
-    : _capacity(DARRAY_DEFAULT_SIZE), _length(0), _stride(stride),
-      _array(nullptr, core::memory::StatefulCustomDeleter<T>(
-                          0, core::memory::MEMORY_TAG_DARRAY)) {
-  InitializeMemory();
-}
+template <typename T, typename Allocator>
+DArray<T, Allocator>::DArray(uint64 stride)
+    : DArray(Allocator(), DARRAY_DEFAULT_SIZE, stride) {}
 
-template <typename T>
-DArray<T>::DArray(uint64 capacity, uint64 stride)
+template <typename T, typename Allocator>
+DArray<T, Allocator>::DArray(uint64 capacity, uint64 stride)
+    : DArray(Allocator(), capacity, stride) {}
+
+template <typename T, typename Allocator>
+DArray<T, Allocator>::DArray(const Allocator &allocator, uint64 capacity,
+                             uint64 stride)
     : _capacity(capacity), _length(0), _stride(stride),
-      _array(nullptr, core::memory::StatefulCustomDeleter<T>(
-                          0, core::memory::MEMORY_TAG_DARRAY)) {
+      _array(nullptr, AllocatorDeleter<Allocator>(allocator, 0, alignof(T))) {
   InitializeMemory();
 }
 
-template <typename T> DArray<T>::~DArray() { Clear(); }
+template <typename T, typename Allocator>
+DArray<T, Allocator>::~DArray() { Clear(); }
 
-template <typename T> uint64 DArray<T>::GetCapacity() const {
+template <typename T, typename Allocator>
+Allocator &DArray<T, Allocator>::GetAllocator() {
+  return _array.get_deleter().GetAllocator();
+}
+
+template <typename T, typename Allocator>
+uint64 DArray<T, Allocator>::GetCapacity() const {
   return _capacity;
 }
 
-template <typename T> void DArray<T>::SetCapacity(uint64 capacity) {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::SetCapacity(uint64 capacity) {
   _capacity = capacity;
 }
 
-template <typename T> uint64 DArray<T>::GetLength() const { return _length; }
+template <typename T, typename Allocator>
+uint64 DArray<T, Allocator>::GetLength() const { return _length; }
+
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::SetLength(uint64 length) {
+  if (length > _capacity) {
+    Grow(length);
+  }
+
+  if (length > _length) {
+    if constexpr (std::is_trivially_default_constructible_v<T>) {
+      core::memory::MemoryManager::ZeroMemory(GetAddressOf(_length),
+                                              (length - _length) * _stride);
+    } else {
+      for (uint64 i = _length; i < length; i++) {
+        new (GetAddressOf(i)) T();
+      }
+    }
+  }
+
+  for (uint64 i = length; i < _length; i++) {
+    GetAddressOf(i)->~T();
+  }
 
-template <typename T> void DArray<T>::SetLength(uint64 length) {
   _length = length;
 }
 
-template <typename T> uint64 DArray<T>::GetStride() const { return _stride; }
+template <typename T, typename Allocator>
+uint64 DArray<T, Allocator>::GetStride() const { return _stride; }
 
-template <typename T> void DArray<T>::SetStride(uint64 stride) {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::SetStride(uint64 stride) {
   _stride = stride;
 }
 
-template <typename T> void DArray<T>::Reserve(uint64 numOfElements) {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Reserve(uint64 numOfElements) {
   if (numOfElements <= _capacity) {
     return;
   }
 
-  _capacity = numOfElements;
-
-  uint64 headerSize = DARRAY_FIELD_LENGTH * sizeof(uint64);
-  uint64 arraySize = _capacity * _stride;
-  uint64 totalSize = headerSize + arraySize;
-
-  // Allocate new memory
-  T *newMemory = reinterpret_cast<T *>(core::memory::MemoryManager::Allocate(
-      totalSize, core::memory::MEMORY_TAG_DARRAY));
-
-  core::memory::MemoryManager::SetMemory(newMemory, 0, totalSize);
-
-  // Move existing elements to the new memory
-  for (uint64 i = 0; i < _length; i++) {
-    T *oldElem = GetAddressOf(i);
-    T *newElem = reinterpret_cast<T *>(reinterpret_cast<char *>(newMemory) +
-                                       i * _stride);
-    new (newElem) T(std::move(*oldElem));
-    oldElem->~T();
-  }
-
-  // Assign new memory to _array with the correct deleter
-  _array = unique_darray_ptr<T>(
-      newMemory, core::memory::StatefulCustomDeleter<T>(
-                     totalSize, core::memory::MEMORY_TAG_DARRAY));
-
-  // Set the lenght equals the capacity if everything went ok
-  _length = _capacity;
+  Grow(numOfElements);
 }
 
-template <typename T> void DArray<T>::Resize() {
-  // Calculate new capacity
-  uint64 newCapacity = _capacity * DARRAY_RESIZE_FACTOR;
-
-  // Determine the total new size to be allocated including header
-  uint64 headerSize = DARRAY_FIELD_LENGTH * sizeof(uint64);
-  uint64 newArraySize = newCapacity * _stride;
-  uint64 totalNewSize = headerSize + newArraySize;
-
-  // Allocate new memory
-  T *newMemory = reinterpret_cast<T *>(core::memory::MemoryManager::Allocate(
-      totalNewSize, core::memory::MEMORY_TAG_DARRAY));
-  core::memory::MemoryManager::SetMemory(newMemory, 0, totalNewSize);
-
-  // Move each existing element from old array to new one
-  for (uint64 i = 0; i < _length; i++) {
-    // Calculate pointers for the current element to old and new arrays
-    T *oldElem = GetAddressOf(i);
-    T *newElem = reinterpret_cast<T *>(reinterpret_cast<char *>(newMemory) +
-                                       i * _stride);
-
-    // Use placement new to move-construct the element into the new memory
-    new (newElem) T(std::move(*oldElem));
-
-    // Explicitly destruct old element
-    oldElem->~T();
-  }
-
-  // Create a new unique_ptr with a stateful deleter using the new total size.
-  unique_darray_ptr<T> newArray(
-      newMemory, core::memory::StatefulCustomDeleter<T>(
-                     totalNewSize, core::memory::MEMORY_TAG_DARRAY));
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Resize() {
+  Grow(_capacity * DARRAY_RESIZE_FACTOR);
+}
 
-  _array = std::move(newArray);
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Push(const T &element) {
+  Emplace(element);
+}
 
-  // Update internal state
-  _capacity = newCapacity;
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Push(T &&element) {
+  Emplace(std::move(element));
 }
 
-template <typename T> void DArray<T>::Push(const T &element) {
+template <typename T, typename Allocator>
+template <typename... Args>
+T &DArray<T, Allocator>::Emplace(Args &&...args) {
   if (_length >= _capacity) {
+    // The arguments may refer to elements of this array, build the new
+    // element before they move
+    T element(std::forward<Args>(args)...);
     Resize();
+    return *new (GetAddressOf(_length++)) T(std::move(element));
   }
 
-  T *dest = GetAddressOf(_length);
-
   // Construct the new element in place
-  new (dest) T(element);
-  _length++;
+  return *new (GetAddressOf(_length++)) T(std::forward<Args>(args)...);
 }
 
-template <typename T> void DArray<T>::Pop() {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Pop() {
   if (_length == 0)
     return;
 
@@ -203,45 +224,109 @@ template <typename T> void DArray<T>::Pop() {
   _length--;
 }
 
-template <typename T> void DArray<T>::InsertAt(const T &element, uint64 index) {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Append(const T *first, uint64 count) {
+  if (count == 0) {
+    return;
+  }
+
+  if (!first) {
+    FERROR("DArray<T>::Append(): attempt to append from a null range");
+    return;
+  }
+
+  if (_length + count > _capacity) {
+    // The range may be part of this array, find it again after growing
+    uintptr_t begin = reinterpret_cast<uintptr_t>(_array.get());
+    uintptr_t source = reinterpret_cast<uintptr_t>(first);
+    bool aliased = source >= begin && source < begin + _length * _stride;
+
+    uint64 grown = _capacity * DARRAY_RESIZE_FACTOR;
+    Grow(grown > _length + count ? grown : _length + count);
+
+    if (aliased) {
+      first = reinterpret_cast<const T *>(
+          reinterpret_cast<uintptr_t>(_array.get()) + (source - begin));
+    }
+  }
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    if (_stride == sizeof(T)) {
+      core::memory::MemoryManager::CopyMemory(GetAddressOf(_length), first,
+                                              count * sizeof(T));
+      _length += count;
+      return;
+    }
+  }
+
+  for (uint64 i = 0; i < count; i++) {
+    new (GetAddressOf(_length)) T(first[i]);
+    _length++;
+  }
+}
+
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::InsertAt(const T &element, uint64 index) {
   if (index > _length) {
     FERROR("DArray<T>::InsertAt(): attempt to insert at invalid index");
     return;
   }
 
-  // Resize if necessary
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    // Taken before growing or shifting, the element may live in this array
+    T value(element);
+    if (_length >= _capacity) {
+      Resize();
+    }
+
+    // Shift the tail with a single move of its bytes
+    std::memmove(GetAddressOf(index + 1), GetAddressOf(index),
+                 (_length - index) * _stride);
+    new (GetAddressOf(index)) T(std::move(value));
+    _length++;
+    return;
+  }
+
+  if (index == _length) {
+    Emplace(element);
+    return;
+  }
+
+  // Taken before growing or shifting, the element may live in this array
+  T value(element);
   if (_length >= _capacity) {
     Resize();
   }
 
-  // Shift elements to the right by moving them. Since the destination slots
-  // (except for the very end) already contain objects, use assignment.
+  // The slot past the end holds no object yet, move-construct into it. The
+  // other destination slots already contain objects, use assignment.
   // Start from the end and go backwards.
-  for (uint64 i = _length; i > index; i--) {
+  new (GetAddressOf(_length)) T(std::move(*GetAddressOf(_length - 1)));
+  for (uint64 i = _length - 1; i > index; i--) {
     T *dest = GetAddressOf(i);
     T *source = GetAddressOf(i - 1);
     *dest = std::move(*source);
   }
 
-  // Now, if index == _length then the slot is uninitialized; otherwise, it is
-  // already constructed. In the latter case, we can assign to it.
-  T *insertLoc = GetAddressOf(index);
-  if (index < _length) {
-    // Use copy assignment.
-    *insertLoc = element;
-  } else {
-    // Placement new if inserting at the end.
-    new (insertLoc) T(element);
-  }
+  *GetAddressOf(index) = std::move(value);
   _length++;
 }
 
-template <typename T> void DArray<T>::PopAt(uint64 index) {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::PopAt(uint64 index) {
   if (index >= _length) {
     FERROR("DArray<T>::PopAt(): attempt to pop at invalid index");
     return;
   }
 
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    GetAddressOf(index)->~T();
+    std::memmove(GetAddressOf(index), GetAddressOf(index + 1),
+                 (_length - index - 1) * _stride);
+    _length--;
+    return;
+  }
+
   // Shift elements to the left.
   for (uint64 i = index; i < _length - 1; i++) {
     T *dest = GetAddressOf(i);
@@ -255,7 +340,24 @@ template <typename T> void DArray<T>::PopAt(uint64 index) {
   _length--;
 }
 
-template <typename T> void DArray<T>::Clear() {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::PopAtSwap(uint64 index) {
+  if (index >= _length) {
+    FERROR("DArray<T>::PopAtSwap(): attempt to pop at invalid index");
+    return;
+  }
+
+  T *last = GetAddressOf(_length - 1);
+  if (index != _length - 1) {
+    *GetAddressOf(index) = std::move(*last);
+  }
+
+  last->~T();
+  _length--;
+}
+
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Clear() {
   for (uint64 i = 0; i < _length; i++) {
     GetAddressOf(i)->~T();
   }
@@ -263,15 +365,18 @@ template <typename T> void DArray<T>::Clear() {
   _length = 0;
 }
 
-template <typename T> T *DArray<T>::Data() noexcept {
+template <typename T, typename Allocator>
+T *DArray<T, Allocator>::Data() noexcept {
   return reinterpret_cast<T *>(_array.get());
 }
 
-template <typename T> const T *DArray<T>::Data() const noexcept {
+template <typename T, typename Allocator>
+const T *DArray<T, Allocator>::Data() const noexcept {
   return reinterpret_cast<T *>(_array.get());
 }
 
-template <typename T> T &DArray<T>::operator[](uint64 index) {
+template <typename T, typename Allocator>
+T &DArray<T, Allocator>::operator[](uint64 index) {
   if (index >= _length) {
     FERROR("DArray<T>::operator[]: index out of bounds");
     throw std::out_of_range("Index out of bounds in DArray");
@@ -281,7 +386,8 @@ template <typename T> T &DArray<T>::operator[](uint64 index) {
                                 (index * _stride));
 }
 
-template <typename T> const T &DArray<T>::operator[](uint64 index) const {
+template <typename T, typename Allocator>
+const T &DArray<T, Allocator>::operator[](uint64 index) const {
   if (index >= _length) {
     FERROR("DArray<T>::operator[]: index out of bounds");
     throw std::out_of_range("Index out of bounds in DArray");
@@ -291,35 +397,86 @@ template <typename T> const T &DArray<T>::operator[](uint64 index) const {
       reinterpret_cast<const char *>(_array.get()) + (index * _stride));
 }
 
-template <typename T> bool DArray<T>::IsEmpty() const { return _length == 0; }
+template <typename T, typename Allocator>
+bool DArray<T, Allocator>::IsEmpty() const { return _length == 0; }
 
 // PRIVATE
 
-template <typename T> void DArray<T>::InitializeMemory() {
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::InitializeMemory() {
   uint64 headerSize = DARRAY_FIELD_LENGTH * sizeof(uint64);
   uint64 arraySize = _capacity * _stride;
   uint64 totalSize = headerSize + arraySize;
 
-  // Allocate memory
-  T *allocatedMemory =
-      reinterpret_cast<T *>(core::memory::MemoryManager::Allocate(
-          totalSize, core::memory::MEMORY_TAG_DARRAY));
+  // Allocate zeroed memory
+  T *allocatedMemory = reinterpret_cast<T *>(GetAllocator().Allocate(
+      totalSize, alignof(T), core::memory::ALLOCATION_FLAG_ZEROED));
+  if (!allocatedMemory) {
+    FERROR("DArray<T>::InitializeMemory(): failed to allocate %llu "
+           "elements",
+           _capacity);
+    throw std::runtime_error("Failed to allocate DArray");
+  }
 
-  _array = unique_darray_ptr<T>(
-      allocatedMemory, core::memory::StatefulCustomDeleter<T>(
-                           totalSize, core::memory::MEMORY_TAG_DARRAY));
+  _array = unique_darray_ptr<Allocator>(
+      allocatedMemory,
+      AllocatorDeleter<Allocator>(GetAllocator(), totalSize, alignof(T)));
+}
 
-  core::memory::MemoryManager::SetMemory(_array.get(), 0,
-                                         headerSize + arraySize);
+template <typename T, typename Allocator>
+void DArray<T, Allocator>::Grow(uint64 newCapacity) {
+  uint64 headerSize = DARRAY_FIELD_LENGTH * sizeof(uint64);
+  uint64 totalSize = headerSize + _capacity * _stride;
+  uint64 totalNewSize = headerSize + newCapacity * _stride;
+
+  T *newMemory = nullptr;
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    // The bytes are the elements, let the allocator move them, in place when
+    // it can
+    newMemory = reinterpret_cast<T *>(GetAllocator().Reallocate(
+        _array.get(), totalSize, totalNewSize, alignof(T),
+        core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+    if (!newMemory) {
+      FERROR("DArray<T>::Grow(): failed to grow to %llu elements", newCapacity);
+      throw std::runtime_error("Failed to grow DArray");
+    }
+
+    // The old block is gone, don't let the old deleter free it again
+    _array.release();
+  } else {
+    newMemory = reinterpret_cast<T *>(GetAllocator().Allocate(
+        totalNewSize, alignof(T), core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+    if (!newMemory) {
+      FERROR("DArray<T>::Grow(): failed to grow to %llu elements", newCapacity);
+      throw std::runtime_error("Failed to grow DArray");
+    }
+
+    // Move each existing element from old array to new one
+    for (uint64 i = 0; i < _length; i++) {
+      T *oldElem = GetAddressOf(i);
+      T *newElem = reinterpret_cast<T *>(reinterpret_cast<char *>(newMemory) +
+                                         i * _stride);
+      new (newElem) T(std::move(*oldElem));
+      oldElem->~T();
+    }
+  }
+
+  // The grown part stays uninitialized, elements are constructed in place
+  // and SetLength() value-initializes the ones it adds
+  _array = unique_darray_ptr<Allocator>(
+      newMemory,
+      AllocatorDeleter<Allocator>(GetAllocator(), totalNewSize, alignof(T)));
+  _capacity = newCapacity;
 }
 
-template <typename T> T *DArray<T>::GetAddressOf(uint64 index) noexcept {
+template <typename T, typename Allocator>
+T *DArray<T, Allocator>::GetAddressOf(uint64 index) noexcept {
   return reinterpret_cast<T *>(reinterpret_cast<char *>(_array.get()) +
                                (index * _stride));
 }
 
-template <typename T>
-const T *DArray<T>::GetAddressOf(uint64 index) const noexcept {
+template <typename T, typename Allocator>
+const T *DArray<T, Allocator>::GetAddressOf(uint64 index) const noexcept {
   return reinterpret_cast<T *>(reinterpret_cast<char *>(_array.get()) +
                                (index * _stride));
 }
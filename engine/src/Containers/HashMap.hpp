@@ -0,0 +1,491 @@
+#ifndef _FLATEARTH_ENGINE_HASH_MAP_HPP
+#define _FLATEARTH_ENGINE_HASH_MAP_HPP
+
+#include "ContainerAllocator.hpp"
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Definitions.hpp"
+#include <bit>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FE_HASH_MAP_SSE2 1
+#include <emmintrin.h>
+#else
+#define FE_HASH_MAP_SSE2 0
+#endif
+
+namespace flatearth {
+namespace containers {
+
+// Number of control bytes matched at once
+constexpr uint64 HASH_MAP_GROUP_WIDTH = 16;
+constexpr uint64 HASH_MAP_MIN_CAPACITY = HASH_MAP_GROUP_WIDTH;
+// Control byte of a free slot, full slots hold the 7 low bits of their hash
+constexpr uchar HASH_MAP_CTRL_EMPTY = 0x80;
+
+// Spreads the bits of weak hashes, std::hash of an integer is the integer
+constexpr uint64 HashMapMix(uint64 hash) {
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+template <typename K> struct HashMapHash {
+  uint64 operator()(const K &key) const {
+    return HashMapMix(std::hash<K>{}(key));
+  }
+};
+
+// Transparent, so string keys can be looked up with a vstring or a literal
+// without building a string first
+template <> struct HashMapHash<string> {
+  using is_transparent = void;
+
+  uint64 operator()(vstring key) const {
+    return HashMapMix(std::hash<vstring>{}(key));
+  }
+};
+
+// HASH_MAP_GROUP_WIDTH control bytes matched in parallel, with SSE2 when
+// available and bit by bit otherwise. Bit i of a mask is control byte i
+class HashMapGroup {
+public:
+  explicit HashMapGroup(const uchar *ctrl) {
+#if FE_HASH_MAP_SSE2
+    _ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+    for (uint64 i = 0; i < HASH_MAP_GROUP_WIDTH; i++) {
+      _ctrl[i] = ctrl[i];
+    }
+#endif
+  }
+
+  uint32 Match(uchar h2) const {
+#if FE_HASH_MAP_SSE2
+    return (uint32)_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_set1_epi8((char)h2), _ctrl));
+#else
+    uint32 mask = 0;
+    for (uint64 i = 0; i < HASH_MAP_GROUP_WIDTH; i++) {
+      mask |= (uint32)(_ctrl[i] == h2) << i;
+    }
+    return mask;
+#endif
+  }
+
+  // Only empty control bytes have their high bit set
+  uint32 MatchEmpty() const {
+#if FE_HASH_MAP_SSE2
+    return (uint32)_mm_movemask_epi8(_ctrl);
+#else
+    return Match(HASH_MAP_CTRL_EMPTY);
+#endif
+  }
+
+private:
+#if FE_HASH_MAP_SSE2
+  __m128i _ctrl;
+#else
+  uchar _ctrl[HASH_MAP_GROUP_WIDTH];
+#endif
+};
+
+// Open addressing hash map in the SwissTable layout: a control byte per
+// slot holds 7 bits of the hash, so a probe compares a whole group of
+// slots in one go and only touches the keys whose bits matched. Slots are
+// probed linearly, which lets Erase() shift the following entries back
+// instead of leaving tombstones behind. Keys and values live inline in a
+// single block, pointers to them are invalidated when the map grows or an
+// entry is erased.
+template <typename K, typename V, typename Hash = HashMapHash<K>,
+          typename KeyEqual = std::equal_to<>,
+          typename Allocator = TaggedAllocator<core::memory::MEMORY_TAG_DICT>>
+class HashMap {
+public:
+  // The map grows once more than 7/8 of the slots are full
+  static constexpr uint64 HASH_MAP_LOAD_NUMERATOR = 7;
+  static constexpr uint64 HASH_MAP_LOAD_DENOMINATOR = 8;
+
+  explicit HashMap(const Allocator &allocator = Allocator());
+  ~HashMap();
+
+  HashMap(const HashMap &) = delete;
+  HashMap &operator=(const HashMap &) = delete;
+
+  uint64 GetLength() const;
+  uint64 GetCapacity() const;
+  bool IsEmpty() const;
+
+  // Makes room for count entries without growing again
+  void Reserve(uint64 count);
+
+  // Returns FeFalse, leaving the current value alone, when the key exists
+  bool Insert(K key, V value);
+  // Inserts or overwrites
+  void Set(K key, V value);
+  // Value of the key, default constructed first when missing
+  V &operator[](const K &key);
+
+  // Lookups accept anything Hash and KeyEqual accept, e.g. a vstring for
+  // string keys. nullptr when missing
+  template <typename Q> V *Find(const Q &key);
+  template <typename Q> const V *Find(const Q &key) const;
+  template <typename Q> bool Contains(const Q &key) const;
+  template <typename Q> bool Erase(const Q &key);
+
+  void Clear();
+
+  // Calls function(const K &, V &) for every entry, in no particular order
+  template <typename Function> void ForEach(Function &&function);
+  template <typename Function> void ForEach(Function &&function) const;
+
+private:
+  struct Slot {
+    K key;
+    V value;
+  };
+
+  static constexpr uint64 NOT_FOUND = UINT64_MAX;
+
+  static uint64 H1(uint64 hash) { return hash >> 7; }
+  static uchar H2(uint64 hash) { return (uchar)(hash & 0x7F); }
+
+  template <typename Q> uint64 FindIndex(const Q &key) const;
+  uint64 FindEmpty(uint64 hash) const;
+  uint64 EmplaceAt(uint64 hash, K &&key, V &&value);
+  void EraseAt(uint64 index);
+  void SetCtrl(uint64 index, uchar value);
+  void Rehash(uint64 newCapacity);
+  static uint64 ControlSize(uint64 capacity);
+  static uint64 BlockSize(uint64 capacity);
+
+  uchar *_ctrl;
+  Slot *_slots;
+  uint64 _length;
+  uint64 _capacity;
+  Allocator _allocator;
+  Hash _hash;
+  KeyEqual _equal;
+};
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashMap<K, V, Hash, KeyEqual, Allocator>::HashMap(const Allocator &allocator)
+    : _ctrl(nullptr), _slots(nullptr), _length(0), _capacity(0),
+      _allocator(allocator), _hash(), _equal() {}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+HashMap<K, V, Hash, KeyEqual, Allocator>::~HashMap() {
+  Clear();
+  if (_ctrl) {
+    _allocator.Free(_ctrl, BlockSize(_capacity), alignof(Slot));
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::GetLength() const {
+  return _length;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::GetCapacity() const {
+  return _capacity;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashMap<K, V, Hash, KeyEqual, Allocator>::IsEmpty() const {
+  return _length == 0;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::Reserve(uint64 count) {
+  uint64 capacity = _capacity ? _capacity : HASH_MAP_MIN_CAPACITY;
+  while (count * HASH_MAP_LOAD_DENOMINATOR >
+         capacity * HASH_MAP_LOAD_NUMERATOR) {
+    capacity *= 2;
+  }
+
+  if (capacity > _capacity) {
+    Rehash(capacity);
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+bool HashMap<K, V, Hash, KeyEqual, Allocator>::Insert(K key, V value) {
+  if (FindIndex(key) != NOT_FOUND) {
+    return FeFalse;
+  }
+
+  EmplaceAt(_hash(key), std::move(key), std::move(value));
+  return FeTrue;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::Set(K key, V value) {
+  uint64 index = FindIndex(key);
+  if (index != NOT_FOUND) {
+    _slots[index].value = std::move(value);
+    return;
+  }
+
+  EmplaceAt(_hash(key), std::move(key), std::move(value));
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+V &HashMap<K, V, Hash, KeyEqual, Allocator>::operator[](const K &key) {
+  uint64 index = FindIndex(key);
+  if (index == NOT_FOUND) {
+    index = EmplaceAt(_hash(key), K(key), V());
+  }
+
+  return _slots[index].value;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Q>
+V *HashMap<K, V, Hash, KeyEqual, Allocator>::Find(const Q &key) {
+  uint64 index = FindIndex(key);
+  return index == NOT_FOUND ? nullptr : &_slots[index].value;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Q>
+const V *HashMap<K, V, Hash, KeyEqual, Allocator>::Find(const Q &key) const {
+  uint64 index = FindIndex(key);
+  return index == NOT_FOUND ? nullptr : &_slots[index].value;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Q>
+bool HashMap<K, V, Hash, KeyEqual, Allocator>::Contains(const Q &key) const {
+  return FindIndex(key) != NOT_FOUND;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Q>
+bool HashMap<K, V, Hash, KeyEqual, Allocator>::Erase(const Q &key) {
+  uint64 index = FindIndex(key);
+  if (index == NOT_FOUND) {
+    return FeFalse;
+  }
+
+  EraseAt(index);
+  return FeTrue;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::Clear() {
+  for (uint64 i = 0; i < _capacity && _length > 0; i++) {
+    if (_ctrl[i] != HASH_MAP_CTRL_EMPTY) {
+      _slots[i].~Slot();
+      SetCtrl(i, HASH_MAP_CTRL_EMPTY);
+      _length--;
+    }
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Function>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::ForEach(Function &&function) {
+  for (uint64 i = 0; i < _capacity; i++) {
+    if (_ctrl[i] != HASH_MAP_CTRL_EMPTY) {
+      function(static_cast<const K &>(_slots[i].key), _slots[i].value);
+    }
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Function>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::ForEach(
+    Function &&function) const {
+  for (uint64 i = 0; i < _capacity; i++) {
+    if (_ctrl[i] != HASH_MAP_CTRL_EMPTY) {
+      function(_slots[i].key, _slots[i].value);
+    }
+  }
+}
+
+// PRIVATE
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+template <typename Q>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::FindIndex(const Q &key) const {
+  if (_length == 0) {
+    return NOT_FOUND;
+  }
+
+  uint64 hash = _hash(key);
+  uint64 mask = _capacity - 1;
+  uint64 position = H1(hash) & mask;
+  uchar h2 = H2(hash);
+
+  // The load factor guarantees an empty slot, which ends the probe
+  while (FeTrue) {
+    HashMapGroup group(_ctrl + position);
+    for (uint32 match = group.Match(h2); match != 0; match &= match - 1) {
+      uint64 index = (position + std::countr_zero(match)) & mask;
+      if (_equal(_slots[index].key, key)) {
+        return index;
+      }
+    }
+
+    if (group.MatchEmpty() != 0) {
+      return NOT_FOUND;
+    }
+
+    position = (position + HASH_MAP_GROUP_WIDTH) & mask;
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::FindEmpty(uint64 hash) const {
+  uint64 mask = _capacity - 1;
+  uint64 position = H1(hash) & mask;
+  while (FeTrue) {
+    uint32 empty = HashMapGroup(_ctrl + position).MatchEmpty();
+    if (empty != 0) {
+      return (position + std::countr_zero(empty)) & mask;
+    }
+
+    position = (position + HASH_MAP_GROUP_WIDTH) & mask;
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::EmplaceAt(uint64 hash,
+                                                           K &&key,
+                                                           V &&value) {
+  if ((_length + 1) * HASH_MAP_LOAD_DENOMINATOR >
+      _capacity * HASH_MAP_LOAD_NUMERATOR) {
+    Rehash(_capacity ? _capacity * 2 : HASH_MAP_MIN_CAPACITY);
+  }
+
+  uint64 index = FindEmpty(hash);
+  new (&_slots[index]) Slot{std::move(key), std::move(value)};
+  SetCtrl(index, H2(hash));
+  _length++;
+  return index;
+}
+
+// Backward shift deletion: entries after the hole that would be found
+// earlier from their home slot move back into it, so probes never have to
+// skip over deleted slots
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::EraseAt(uint64 index) {
+  uint64 mask = _capacity - 1;
+  _slots[index].~Slot();
+  _length--;
+
+  uint64 hole = index;
+  uint64 next = (hole + 1) & mask;
+  while (_ctrl[next] != HASH_MAP_CTRL_EMPTY) {
+    uint64 home = H1(_hash(_slots[next].key)) & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      new (&_slots[hole]) Slot(std::move(_slots[next]));
+      _slots[next].~Slot();
+      SetCtrl(hole, _ctrl[next]);
+      hole = next;
+    }
+
+    next = (next + 1) & mask;
+  }
+
+  SetCtrl(hole, HASH_MAP_CTRL_EMPTY);
+}
+
+// The first GROUP_WIDTH - 1 control bytes are mirrored past the end so a
+// group starting near the end reads the wrapped around slots
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::SetCtrl(uint64 index,
+                                                       uchar value) {
+  _ctrl[index] = value;
+  if (index < HASH_MAP_GROUP_WIDTH - 1) {
+    _ctrl[_capacity + index] = value;
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+void HashMap<K, V, Hash, KeyEqual, Allocator>::Rehash(uint64 newCapacity) {
+  uchar *newBlock = static_cast<uchar *>(
+      _allocator.Allocate(BlockSize(newCapacity), alignof(Slot),
+                          core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+  if (!newBlock) {
+    FERROR("HashMap<K, V>::Rehash(): failed to grow to %llu slots",
+           newCapacity);
+    throw std::runtime_error("Failed to grow HashMap");
+  }
+
+  uchar *oldCtrl = _ctrl;
+  Slot *oldSlots = _slots;
+  uint64 oldCapacity = _capacity;
+
+  _ctrl = newBlock;
+  _slots = reinterpret_cast<Slot *>(newBlock + ControlSize(newCapacity));
+  _capacity = newCapacity;
+  core::memory::MemoryManager::SetMemory(
+      _ctrl, HASH_MAP_CTRL_EMPTY, newCapacity + HASH_MAP_GROUP_WIDTH - 1);
+
+  // Keys are unique already, only an empty slot is needed for each
+  for (uint64 i = 0; i < oldCapacity; i++) {
+    if (oldCtrl[i] == HASH_MAP_CTRL_EMPTY) {
+      continue;
+    }
+
+    uint64 hash = _hash(oldSlots[i].key);
+    uint64 index = FindEmpty(hash);
+    new (&_slots[index]) Slot(std::move(oldSlots[i]));
+    oldSlots[i].~Slot();
+    SetCtrl(index, H2(hash));
+  }
+
+  if (oldCtrl) {
+    _allocator.Free(oldCtrl, BlockSize(oldCapacity), alignof(Slot));
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::ControlSize(uint64 capacity) {
+  uint64 size = capacity + HASH_MAP_GROUP_WIDTH - 1;
+  return (size + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual,
+          typename Allocator>
+uint64 HashMap<K, V, Hash, KeyEqual, Allocator>::BlockSize(uint64 capacity) {
+  return ControlSize(capacity) + capacity * sizeof(Slot);
+}
+
+} // namespace containers
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_HASH_MAP_HPP
@@ -0,0 +1,458 @@
+#ifndef _FLATEARTH_ENGINE_RING_QUEUE_HPP
+#define _FLATEARTH_ENGINE_RING_QUEUE_HPP
+
+#include "ContainerAllocator.hpp"
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Definitions.hpp"
+#include "Math/FeMath.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <utility>
+
+namespace flatearth {
+namespace containers {
+
+using RingQueueDefaultAllocator =
+    TaggedAllocator<core::memory::MEMORY_TAG_RING_QUEUE>;
+
+// Bounded lock free queue between exactly one producer thread and one
+// consumer thread. Each side owns its index on its own cache line and keeps
+// a cached copy of the other one, so it only touches the shared line when
+// the queue looks full or empty. Nothing blocks: pushing to a full queue or
+// popping from an empty one fails and the caller decides what to do.
+template <typename T, typename Allocator = RingQueueDefaultAllocator>
+class SPSCQueue {
+public:
+  // capacity must be a power of 2
+  explicit SPSCQueue(uint64 capacity, const Allocator &allocator = Allocator());
+  ~SPSCQueue();
+
+  SPSCQueue(const SPSCQueue &) = delete;
+  SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+  uint64 GetCapacity() const;
+  // Only a snapshot while the other side is running
+  uint64 GetLength() const;
+  bool IsEmpty() const;
+
+  // Producer side
+  bool TryPush(const T &element);
+  bool TryPush(T &&element);
+  template <typename... Args> bool TryEmplace(Args &&...args);
+  // Copies as many of the count elements as fit, returns how many did
+  uint64 PushBatch(const T *elements, uint64 count);
+
+  // Consumer side
+  bool TryPop(T &element);
+  // Moves up to maxCount elements out, returns how many were popped
+  uint64 PopBatch(T *elements, uint64 maxCount);
+
+private:
+  // Written by the producer, _cachedTail is its view of _tail
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE) std::atomic<uint64> _head;
+  uint64 _cachedTail;
+
+  // Written by the consumer, _cachedHead is its view of _head
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE) std::atomic<uint64> _tail;
+  uint64 _cachedHead;
+
+  // Read only once constructed
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE) T *_slots;
+  uint64 _mask;
+  Allocator _allocator;
+};
+
+// Bounded lock free queue for any number of producers and consumers, after
+// Dmitry Vyukov's design: every slot carries a sequence number telling
+// which lap of the ring it is ready for, so producers and consumers only
+// contend on their own index and never on each other. Batches claim a run
+// of ready slots with a single compare and swap.
+template <typename T, typename Allocator = RingQueueDefaultAllocator>
+class MPMCQueue {
+public:
+  // capacity must be a power of 2
+  explicit MPMCQueue(uint64 capacity, const Allocator &allocator = Allocator());
+  ~MPMCQueue();
+
+  MPMCQueue(const MPMCQueue &) = delete;
+  MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+  uint64 GetCapacity() const;
+  // Only a snapshot while other threads are running
+  uint64 GetLength() const;
+  bool IsEmpty() const;
+
+  bool TryPush(const T &element);
+  bool TryPush(T &&element);
+  template <typename... Args> bool TryEmplace(Args &&...args);
+  // Copies as many of the count elements as fit, returns how many did
+  uint64 PushBatch(const T *elements, uint64 count);
+
+  bool TryPop(T &element);
+  // Moves up to maxCount elements out, returns how many were popped
+  uint64 PopBatch(T *elements, uint64 maxCount);
+
+private:
+  struct Cell {
+    std::atomic<uint64> sequence;
+    alignas(T) uchar storage[sizeof(T)];
+
+    T *Element() { return reinterpret_cast<T *>(storage); }
+  };
+
+  uint64 ClaimPush(uint64 count, uint64 &position);
+  uint64 ClaimPop(uint64 count, uint64 &position);
+
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE)
+      std::atomic<uint64> _enqueuePosition;
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE)
+      std::atomic<uint64> _dequeuePosition;
+
+  // Read only once constructed
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE) Cell *_cells;
+  uint64 _mask;
+  Allocator _allocator;
+};
+
+// SPSCQueue
+
+template <typename T, typename Allocator>
+SPSCQueue<T, Allocator>::SPSCQueue(uint64 capacity, const Allocator &allocator)
+    : _head(0), _cachedTail(0), _tail(0), _cachedHead(0), _slots(nullptr),
+      _mask(capacity - 1), _allocator(allocator) {
+  if (!math::IsPowerOf2(capacity)) {
+    FERROR("SPSCQueue<T>::SPSCQueue(): capacity must be a power of 2 (got "
+           "%llu)",
+           capacity);
+    throw std::invalid_argument("Invalid SPSCQueue capacity");
+  }
+
+  _slots = static_cast<T *>(
+      _allocator.Allocate(capacity * sizeof(T),
+                          core::memory::MEMORY_CACHE_LINE_SIZE,
+                          core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+  if (!_slots) {
+    FERROR("SPSCQueue<T>::SPSCQueue(): failed to allocate %llu slots",
+           capacity);
+    throw std::runtime_error("Failed to allocate SPSCQueue");
+  }
+}
+
+template <typename T, typename Allocator> SPSCQueue<T, Allocator>::~SPSCQueue() {
+  uint64 head = _head.load(std::memory_order_acquire);
+  for (uint64 i = _tail.load(std::memory_order_relaxed); i != head; i++) {
+    _slots[i & _mask].~T();
+  }
+
+  _allocator.Free(_slots, (_mask + 1) * sizeof(T),
+                  core::memory::MEMORY_CACHE_LINE_SIZE);
+}
+
+template <typename T, typename Allocator>
+uint64 SPSCQueue<T, Allocator>::GetCapacity() const {
+  return _mask + 1;
+}
+
+template <typename T, typename Allocator>
+uint64 SPSCQueue<T, Allocator>::GetLength() const {
+  // The tail first, the head can only be further along by then
+  uint64 tail = _tail.load(std::memory_order_acquire);
+  uint64 head = _head.load(std::memory_order_acquire);
+  return head - tail;
+}
+
+template <typename T, typename Allocator>
+bool SPSCQueue<T, Allocator>::IsEmpty() const {
+  return GetLength() == 0;
+}
+
+template <typename T, typename Allocator>
+bool SPSCQueue<T, Allocator>::TryPush(const T &element) {
+  return TryEmplace(element);
+}
+
+template <typename T, typename Allocator>
+bool SPSCQueue<T, Allocator>::TryPush(T &&element) {
+  return TryEmplace(std::move(element));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+bool SPSCQueue<T, Allocator>::TryEmplace(Args &&...args) {
+  uint64 head = _head.load(std::memory_order_relaxed);
+  if (head - _cachedTail > _mask) {
+    _cachedTail = _tail.load(std::memory_order_acquire);
+    if (head - _cachedTail > _mask) {
+      return FeFalse;
+    }
+  }
+
+  new (&_slots[head & _mask]) T(std::forward<Args>(args)...);
+  _head.store(head + 1, std::memory_order_release);
+  return FeTrue;
+}
+
+template <typename T, typename Allocator>
+uint64 SPSCQueue<T, Allocator>::PushBatch(const T *elements, uint64 count) {
+  uint64 head = _head.load(std::memory_order_relaxed);
+  uint64 free = _mask + 1 - (head - _cachedTail);
+  if (free < count) {
+    _cachedTail = _tail.load(std::memory_order_acquire);
+    free = _mask + 1 - (head - _cachedTail);
+  }
+
+  uint64 pushed = count < free ? count : free;
+  for (uint64 i = 0; i < pushed; i++) {
+    new (&_slots[(head + i) & _mask]) T(elements[i]);
+  }
+
+  // Published all at once
+  _head.store(head + pushed, std::memory_order_release);
+  return pushed;
+}
+
+template <typename T, typename Allocator>
+bool SPSCQueue<T, Allocator>::TryPop(T &element) {
+  uint64 tail = _tail.load(std::memory_order_relaxed);
+  if (tail == _cachedHead) {
+    _cachedHead = _head.load(std::memory_order_acquire);
+    if (tail == _cachedHead) {
+      return FeFalse;
+    }
+  }
+
+  T *slot = &_slots[tail & _mask];
+  element = std::move(*slot);
+  slot->~T();
+  _tail.store(tail + 1, std::memory_order_release);
+  return FeTrue;
+}
+
+template <typename T, typename Allocator>
+uint64 SPSCQueue<T, Allocator>::PopBatch(T *elements, uint64 maxCount) {
+  uint64 tail = _tail.load(std::memory_order_relaxed);
+  uint64 available = _cachedHead - tail;
+  if (available < maxCount) {
+    _cachedHead = _head.load(std::memory_order_acquire);
+    available = _cachedHead - tail;
+  }
+
+  uint64 popped = maxCount < available ? maxCount : available;
+  for (uint64 i = 0; i < popped; i++) {
+    T *slot = &_slots[(tail + i) & _mask];
+    elements[i] = std::move(*slot);
+    slot->~T();
+  }
+
+  _tail.store(tail + popped, std::memory_order_release);
+  return popped;
+}
+
+// MPMCQueue
+
+template <typename T, typename Allocator>
+MPMCQueue<T, Allocator>::MPMCQueue(uint64 capacity, const Allocator &allocator)
+    : _enqueuePosition(0), _dequeuePosition(0), _cells(nullptr),
+      _mask(capacity - 1), _allocator(allocator) {
+  if (!math::IsPowerOf2(capacity)) {
+    FERROR("MPMCQueue<T>::MPMCQueue(): capacity must be a power of 2 (got "
+           "%llu)",
+           capacity);
+    throw std::invalid_argument("Invalid MPMCQueue capacity");
+  }
+
+  _cells = static_cast<Cell *>(
+      _allocator.Allocate(capacity * sizeof(Cell),
+                          core::memory::MEMORY_CACHE_LINE_SIZE,
+                          core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+  if (!_cells) {
+    FERROR("MPMCQueue<T>::MPMCQueue(): failed to allocate %llu cells",
+           capacity);
+    throw std::runtime_error("Failed to allocate MPMCQueue");
+  }
+
+  // Cell i is ready for the producer of position i
+  for (uint64 i = 0; i < capacity; i++) {
+    new (&_cells[i].sequence) std::atomic<uint64>(i);
+  }
+}
+
+template <typename T, typename Allocator> MPMCQueue<T, Allocator>::~MPMCQueue() {
+  uint64 end = _enqueuePosition.load(std::memory_order_acquire);
+  for (uint64 i = _dequeuePosition.load(std::memory_order_relaxed); i != end;
+       i++) {
+    _cells[i & _mask].Element()->~T();
+  }
+
+  for (uint64 i = 0; i <= _mask; i++) {
+    _cells[i].sequence.~atomic();
+  }
+
+  _allocator.Free(_cells, (_mask + 1) * sizeof(Cell),
+                  core::memory::MEMORY_CACHE_LINE_SIZE);
+}
+
+template <typename T, typename Allocator>
+uint64 MPMCQueue<T, Allocator>::GetCapacity() const {
+  return _mask + 1;
+}
+
+template <typename T, typename Allocator>
+uint64 MPMCQueue<T, Allocator>::GetLength() const {
+  // Positions are claimed before the cells are filled or emptied, so this
+  // counts elements still being written or read
+  uint64 dequeue = _dequeuePosition.load(std::memory_order_acquire);
+  uint64 enqueue = _enqueuePosition.load(std::memory_order_acquire);
+  uint64 length = enqueue - dequeue;
+  return length > _mask + 1 ? _mask + 1 : length;
+}
+
+template <typename T, typename Allocator>
+bool MPMCQueue<T, Allocator>::IsEmpty() const {
+  return GetLength() == 0;
+}
+
+template <typename T, typename Allocator>
+bool MPMCQueue<T, Allocator>::TryPush(const T &element) {
+  return TryEmplace(element);
+}
+
+template <typename T, typename Allocator>
+bool MPMCQueue<T, Allocator>::TryPush(T &&element) {
+  return TryEmplace(std::move(element));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+bool MPMCQueue<T, Allocator>::TryEmplace(Args &&...args) {
+  uint64 position = 0;
+  if (ClaimPush(1, position) == 0) {
+    return FeFalse;
+  }
+
+  Cell &cell = _cells[position & _mask];
+  new (cell.Element()) T(std::forward<Args>(args)...);
+  cell.sequence.store(position + 1, std::memory_order_release);
+  return FeTrue;
+}
+
+template <typename T, typename Allocator>
+uint64 MPMCQueue<T, Allocator>::PushBatch(const T *elements, uint64 count) {
+  uint64 position = 0;
+  uint64 pushed = ClaimPush(count, position);
+  for (uint64 i = 0; i < pushed; i++) {
+    Cell &cell = _cells[(position + i) & _mask];
+    new (cell.Element()) T(elements[i]);
+    cell.sequence.store(position + i + 1, std::memory_order_release);
+  }
+
+  return pushed;
+}
+
+template <typename T, typename Allocator>
+bool MPMCQueue<T, Allocator>::TryPop(T &element) {
+  return PopBatch(&element, 1) == 1;
+}
+
+template <typename T, typename Allocator>
+uint64 MPMCQueue<T, Allocator>::PopBatch(T *elements, uint64 maxCount) {
+  uint64 position = 0;
+  uint64 popped = ClaimPop(maxCount, position);
+  for (uint64 i = 0; i < popped; i++) {
+    Cell &cell = _cells[(position + i) & _mask];
+    elements[i] = std::move(*cell.Element());
+    cell.Element()->~T();
+    // Ready for the producer one lap later
+    cell.sequence.store(position + i + _mask + 1, std::memory_order_release);
+  }
+
+  return popped;
+}
+
+// PRIVATE
+
+// Claims the run of consecutive free cells starting at the enqueue position,
+// at most count long. A cell whose sequence equals its position was emptied
+// on the previous lap and only the producer claiming it writes it again, so
+// the run checked before the compare and swap is still free after it.
+template <typename T, typename Allocator>
+uint64 MPMCQueue<T, Allocator>::ClaimPush(uint64 count, uint64 &position) {
+  if (count == 0) {
+    return 0;
+  }
+
+  position = _enqueuePosition.load(std::memory_order_relaxed);
+  while (FeTrue) {
+    uint64 ready = 0;
+    while (ready < count) {
+      uint64 sequence = _cells[(position + ready) & _mask].sequence.load(
+          std::memory_order_acquire);
+      if (sequence != position + ready) {
+        break;
+      }
+      ready++;
+    }
+
+    if (ready == 0) {
+      uint64 sequence =
+          _cells[position & _mask].sequence.load(std::memory_order_acquire);
+      // Still holding the element of the previous lap, the queue is full
+      if ((sint64)(sequence - position) < 0) {
+        return 0;
+      }
+
+      position = _enqueuePosition.load(std::memory_order_relaxed);
+      continue;
+    }
+
+    if (_enqueuePosition.compare_exchange_weak(position, position + ready,
+                                               std::memory_order_relaxed)) {
+      return ready;
+    }
+  }
+}
+
+// Same as ClaimPush() for filled cells, whose sequence is one past their
+// position
+template <typename T, typename Allocator>
+uint64 MPMCQueue<T, Allocator>::ClaimPop(uint64 count, uint64 &position) {
+  if (count == 0) {
+    return 0;
+  }
+
+  position = _dequeuePosition.load(std::memory_order_relaxed);
+  while (FeTrue) {
+    uint64 ready = 0;
+    while (ready < count) {
+      uint64 sequence = _cells[(position + ready) & _mask].sequence.load(
+          std::memory_order_acquire);
+      if (sequence != position + ready + 1) {
+        break;
+      }
+      ready++;
+    }
+
+    if (ready == 0) {
+      uint64 sequence =
+          _cells[position & _mask].sequence.load(std::memory_order_acquire);
+      // Not written yet, the queue is empty
+      if ((sint64)(sequence - (position + 1)) < 0) {
+        return 0;
+      }
+
+      position = _dequeuePosition.load(std::memory_order_relaxed);
+      continue;
+    }
+
+    if (_dequeuePosition.compare_exchange_weak(position, position + ready,
+                                               std::memory_order_relaxed)) {
+      return ready;
+    }
+  }
+}
+
+} // namespace containers
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_RING_QUEUE_HPP
@@ -1,82 +1,45 @@
 #ifndef _FLATEARTH_ENGINE_STATIC_ARRAY_HPP
 #define _FLATEARTH_ENGINE_STATIC_ARRAY_HPP
 
-#include "Core/FeMemory.hpp"
 #include "Core/Logger.hpp"
 #include "Definitions.hpp"
-#include <memory>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 namespace flatearth {
 namespace containers {
 
-template <typename T, uint64 Size> class SArray {
-public:
-  static constexpr uint64 SARRAY_FIELD_LENGTH = 0;
-
-  SArray();
-  ~SArray();
+// Fixed size array stored inline, it never allocates. It is an aggregate so
+// it can be brace initialized and used in constant expressions:
+//   constexpr SArray<uint32, 3> sizes = {1, 2, 4};
+// Elements without an initializer are value initialized.
+template <typename T, uint64 Size> struct SArray {
+  STATIC_ASSERT(Size > 0, "Cannot create 0-sized static array");
 
   constexpr uint64 GetSize() const noexcept;
   constexpr bool IsEmpty() const noexcept;
 
-  void Swap(SArray &other) noexcept;
-
-  T &At(uint64 index);
-  const T &At(uint64 index) const;
+  constexpr void Swap(SArray &other) noexcept(std::is_nothrow_swappable_v<T>);
 
-  T *Begin() noexcept;
-  const T *Begin() const noexcept;
-  T *End() noexcept;
-  const T *End() const noexcept;
-
-  // Operators
-  T &operator[](uint64 index);
-  const T &operator[](uint64 index) const;
-
-private:
-  bool _initialized;
-  T *GetAddressOf(uint64 index) noexcept;
-  const T *GetAddressOf(uint64 index) const noexcept;
-  static constexpr uint64 _stride = sizeof(T);
-  std::unique_ptr<T[], core::memory::StatelessCustomDeleter<
-                           T, Size, core::memory::MEMORY_TAG_ARRAY>>
-      _array;
-};
+  constexpr T &At(uint64 index);
+  constexpr const T &At(uint64 index) const;
 
-template <typename T, uint64 Size> SArray<T, Size>::SArray() {
-  if (Size == 0) {
-    FERROR("SArray<T, Size>::SArray(): attempt to create a 0 size array");
-    throw std::runtime_error("Cannot create 0-sized static array");
-  }
-  uint64 headerSize = SARRAY_FIELD_LENGTH * sizeof(T);
-  uint64 arraySize = _stride * Size;
-  _array = std::unique_ptr<T[], core::memory::StatelessCustomDeleter<
-                                    T, Size, core::memory::MEMORY_TAG_ARRAY>>(
-      reinterpret_cast<T *>(core::memory::MemoryManager::Allocate(
-          headerSize + arraySize, core::memory::MEMORY_TAG_ARRAY)),
-      core::memory::StatelessCustomDeleter<T, Size,
-                                           core::memory::MEMORY_TAG_ARRAY>());
-
-  core::memory::MemoryManager::SetMemory(_array.get(), 0,
-                                         headerSize + arraySize);
+  constexpr T *Data() noexcept;
+  constexpr const T *Data() const noexcept;
 
-  for (uint64 i = 0; i < Size; i++) {
-    new (GetAddressOf(i)) T();
-  }
+  constexpr T *Begin() noexcept;
+  constexpr const T *Begin() const noexcept;
+  constexpr T *End() noexcept;
+  constexpr const T *End() const noexcept;
 
-  _initialized = FeTrue;
-}
+  // Operators
+  constexpr T &operator[](uint64 index);
+  constexpr const T &operator[](uint64 index) const;
 
-template <typename T, uint64 Size> SArray<T, Size>::~SArray() {
-  if (_initialized) {
-    for (uint64 i = 0; i < Size; i++) {
-      GetAddressOf(i)->~T();
-    }
-  }
-  _initialized = FeFalse;
-}
+  // Public only so the array stays an aggregate, go through the accessors
+  T _elements[Size]{};
+};
 
 template <typename T, uint64 Size>
 constexpr uint64 SArray<T, Size>::GetSize() const noexcept {
@@ -85,85 +48,84 @@ constexpr uint64 SArray<T, Size>::GetSize() const noexcept {
 
 template <typename T, uint64 Size>
 constexpr bool SArray<T, Size>::IsEmpty() const noexcept {
-  return !_initialized;
+  return FeFalse;
 }
 
 template <typename T, uint64 Size>
-void SArray<T, Size>::Swap(SArray &other) noexcept {
-  bool tempInit = _initialized;
-  _initialized = other._initialized;
-  other._initialized = tempInit;
-  std::swap(_array, other._array);
+constexpr void SArray<T, Size>::Swap(SArray &other) noexcept(
+    std::is_nothrow_swappable_v<T>) {
+  for (uint64 i = 0; i < Size; i++) {
+    std::swap(_elements[i], other._elements[i]);
+  }
 }
 
-template <typename T, uint64 Size> T &SArray<T, Size>::At(uint64 index) {
+template <typename T, uint64 Size>
+constexpr T &SArray<T, Size>::At(uint64 index) {
   if (index >= Size) {
     FERROR("SArray<T, Size>::At(): index out of bounds");
     throw std::out_of_range("Index out of bounds in SArray");
   }
 
-  return *GetAddressOf(index);
+  return _elements[index];
 }
 
 template <typename T, uint64 Size>
-const T &SArray<T, Size>::At(uint64 index) const {
+constexpr const T &SArray<T, Size>::At(uint64 index) const {
   if (index >= Size) {
     FERROR("SArray<T, Size>::At(): index out of bounds");
     throw std::out_of_range("Index out of bounds in SArray");
   }
 
-  return *GetAddressOf(index);
+  return _elements[index];
+}
+
+template <typename T, uint64 Size>
+constexpr T *SArray<T, Size>::Data() noexcept {
+  return _elements;
+}
+
+template <typename T, uint64 Size>
+constexpr const T *SArray<T, Size>::Data() const noexcept {
+  return _elements;
 }
 
-template <typename T, uint64 Size> T *SArray<T, Size>::Begin() noexcept {
-  return _array.get();
+template <typename T, uint64 Size>
+constexpr T *SArray<T, Size>::Begin() noexcept {
+  return _elements;
 }
 
 template <typename T, uint64 Size>
-const T *SArray<T, Size>::Begin() const noexcept {
-  return _array.get();
+constexpr const T *SArray<T, Size>::Begin() const noexcept {
+  return _elements;
 }
 
-template <typename T, uint64 Size> T *SArray<T, Size>::End() noexcept {
-  return GetAddressOf(Size);
+template <typename T, uint64 Size> constexpr T *SArray<T, Size>::End() noexcept {
+  return _elements + Size;
 }
 
 template <typename T, uint64 Size>
-const T *SArray<T, Size>::End() const noexcept {
-  return GetAddressOf(Size);
+constexpr const T *SArray<T, Size>::End() const noexcept {
+  return _elements + Size;
 }
 
 template <typename T, uint64 Size>
-T &SArray<T, Size>::operator[](uint64 index) {
+constexpr T &SArray<T, Size>::operator[](uint64 index) {
   if (index >= Size) {
     FERROR("SArray<T, Size>::At(): index out of bounds");
     throw std::out_of_range("Index out of bounds in SArray");
   }
 
-  return *GetAddressOf(index);
+  return _elements[index];
 }
 
 template <typename T, uint64 Size>
-const T &SArray<T, Size>::operator[](uint64 index) const {
+constexpr const T &SArray<T, Size>::operator[](uint64 index) const {
   if (index >= Size) {
     FERROR("SArray<T, Size>::At(): index out of bounds");
     throw std::out_of_range("Index out of bounds in SArray");
   }
 
-  return *GetAddressOf(index);
-}
-
-// Private members
-template <typename T, uint64 Size>
-T *SArray<T, Size>::GetAddressOf(uint64 index) noexcept {
-  return reinterpret_cast<T *>(reinterpret_cast<char *>(_array.get()) +
-                               (index * _stride));
-}
-
-template <typename T, uint64 Size>
-const T *SArray<T, Size>::GetAddressOf(uint64 index) const noexcept {
-  return reinterpret_cast<T *>(reinterpret_cast<char *>(_array.get()) +
-                               (index * _stride));
+  return _elements[index];
 }
 
 } // namespace containers
@@ -0,0 +1,249 @@
+#ifndef _FLATEARTH_ENGINE_SLOT_MAP_HPP
+#define _FLATEARTH_ENGINE_SLOT_MAP_HPP
+
+#include "ContainerAllocator.hpp"
+#include "DArray.hpp"
+#include "Core/Logger.hpp"
+#include "Definitions.hpp"
+#include <cstdint>
+#include <utility>
+
+namespace flatearth {
+namespace containers {
+
+// Reference to an element of a SlotMap. The generation makes handles to
+// removed elements stale instead of dangling. Live slots carry odd
+// generations, so generation 0 is never handed out.
+struct SlotHandle {
+  uint32 index;
+  uint32 generation;
+
+  bool IsValid() const { return generation != 0; }
+  bool operator==(const SlotHandle &other) const = default;
+};
+
+constexpr SlotHandle INVALID_SLOT_HANDLE = {0, 0};
+
+// Elements packed in a dense array and reached through stable handles. A
+// sparse table maps each handle to the element's current dense index, and
+// removal moves the last element into the hole, so insert, remove and lookup
+// are O(1) and the live elements are always contiguous. Element addresses
+// change on insert and remove, handles do not. Data(), GetLength() and
+// GetHandle() walk the elements in dense order, which parallel arrays kept
+// by the caller can follow.
+template <typename T, typename Allocator = DArrayDefaultAllocator>
+class SlotMap {
+public:
+  explicit SlotMap(const Allocator &allocator = Allocator());
+  ~SlotMap() = default;
+
+  SlotMap(const SlotMap &) = delete;
+  SlotMap &operator=(const SlotMap &) = delete;
+
+  uint64 GetLength() const;
+  bool IsEmpty() const;
+  // Makes room for count elements, handles included
+  void Reserve(uint64 count);
+
+  SlotHandle Insert(const T &element);
+  SlotHandle Insert(T &&element);
+  template <typename... Args> SlotHandle Emplace(Args &&...args);
+  // FeFalse for stale or invalid handles
+  bool Remove(SlotHandle handle);
+  // Stales every handle
+  void Clear();
+
+  // nullptr for stale or invalid handles
+  T *Get(SlotHandle handle);
+  const T *Get(SlotHandle handle) const;
+  bool Contains(SlotHandle handle) const;
+
+  // Dense access, index < GetLength()
+  T *Data() noexcept;
+  const T *Data() const noexcept;
+  SlotHandle GetHandle(uint64 denseIndex) const;
+
+  // Calls function(SlotHandle, T &) for every element in dense order
+  template <typename Function> void ForEach(Function &&function);
+
+private:
+  // Dense index of a live slot, next free slot of a free one. The generation
+  // is odd while the slot is live and even while it is free
+  struct SlotEntry {
+    uint32 dense;
+    uint32 generation;
+  };
+
+  static constexpr uint32 SLOT_MAP_NO_FREE_SLOT = UINT32_MAX;
+
+  uint32 AcquireSlot();
+  const SlotEntry *LookUp(SlotHandle handle) const;
+
+  DArray<T, Allocator> _dense;
+  // Slot of each dense element, to fix it up when the element moves
+  DArray<uint32, Allocator> _denseToSlot;
+  DArray<SlotEntry, Allocator> _slots;
+  uint32 _freeHead;
+};
+
+template <typename T, typename Allocator>
+SlotMap<T, Allocator>::SlotMap(const Allocator &allocator)
+    : _dense(allocator), _denseToSlot(allocator), _slots(allocator),
+      _freeHead(SLOT_MAP_NO_FREE_SLOT) {}
+
+template <typename T, typename Allocator>
+uint64 SlotMap<T, Allocator>::GetLength() const {
+  return _dense.GetLength();
+}
+
+template <typename T, typename Allocator>
+bool SlotMap<T, Allocator>::IsEmpty() const {
+  return _dense.IsEmpty();
+}
+
+template <typename T, typename Allocator>
+void SlotMap<T, Allocator>::Reserve(uint64 count) {
+  _dense.Reserve(count);
+  _denseToSlot.Reserve(count);
+  _slots.Reserve(count);
+}
+
+template <typename T, typename Allocator>
+SlotHandle SlotMap<T, Allocator>::Insert(const T &element) {
+  return Emplace(element);
+}
+
+template <typename T, typename Allocator>
+SlotHandle SlotMap<T, Allocator>::Insert(T &&element) {
+  return Emplace(std::move(element));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+SlotHandle SlotMap<T, Allocator>::Emplace(Args &&...args) {
+  if (_dense.GetLength() >= UINT32_MAX) {
+    FERROR("SlotMap<T>::Emplace(): out of slots");
+    return INVALID_SLOT_HANDLE;
+  }
+
+  _dense.Emplace(std::forward<Args>(args)...);
+
+  uint32 index = AcquireSlot();
+  SlotEntry &entry = _slots[index];
+  entry.dense = (uint32)(_dense.GetLength() - 1);
+  _denseToSlot.Push(index);
+
+  return {index, entry.generation};
+}
+
+template <typename T, typename Allocator>
+bool SlotMap<T, Allocator>::Remove(SlotHandle handle) {
+  if (!LookUp(handle)) {
+    return FeFalse;
+  }
+
+  SlotEntry &entry = _slots[handle.index];
+  uint64 dense = entry.dense;
+  _dense.PopAtSwap(dense);
+  _denseToSlot.PopAtSwap(dense);
+  if (dense < _denseToSlot.GetLength()) {
+    _slots[_denseToSlot[dense]].dense = (uint32)dense;
+  }
+
+  // Stale every handle to this slot, the even generation marks it free
+  entry.generation++;
+  entry.dense = _freeHead;
+  _freeHead = handle.index;
+
+  return FeTrue;
+}
+
+template <typename T, typename Allocator> void SlotMap<T, Allocator>::Clear() {
+  // From the back, so nothing has to move
+  while (!_denseToSlot.IsEmpty()) {
+    Remove(GetHandle(_denseToSlot.GetLength() - 1));
+  }
+}
+
+template <typename T, typename Allocator>
+T *SlotMap<T, Allocator>::Get(SlotHandle handle) {
+  const SlotEntry *entry = LookUp(handle);
+  return entry ? _dense.Data() + entry->dense : nullptr;
+}
+
+template <typename T, typename Allocator>
+const T *SlotMap<T, Allocator>::Get(SlotHandle handle) const {
+  const SlotEntry *entry = LookUp(handle);
+  return entry ? _dense.Data() + entry->dense : nullptr;
+}
+
+template <typename T, typename Allocator>
+bool SlotMap<T, Allocator>::Contains(SlotHandle handle) const {
+  return LookUp(handle) != nullptr;
+}
+
+template <typename T, typename Allocator>
+T *SlotMap<T, Allocator>::Data() noexcept {
+  return _dense.Data();
+}
+
+template <typename T, typename Allocator>
+const T *SlotMap<T, Allocator>::Data() const noexcept {
+  return _dense.Data();
+}
+
+template <typename T, typename Allocator>
+SlotHandle SlotMap<T, Allocator>::GetHandle(uint64 denseIndex) const {
+  if (denseIndex >= _denseToSlot.GetLength()) {
+    FERROR("SlotMap<T>::GetHandle(): index out of bounds");
+    return INVALID_SLOT_HANDLE;
+  }
+
+  uint32 index = _denseToSlot[denseIndex];
+  return {index, _slots[index].generation};
+}
+
+template <typename T, typename Allocator>
+template <typename Function>
+void SlotMap<T, Allocator>::ForEach(Function &&function) {
+  T *data = _dense.Data();
+  for (uint64 i = 0; i < _dense.GetLength(); i++) {
+    uint32 index = _denseToSlot[i];
+    function(SlotHandle{index, _slots[index].generation}, data[i]);
+  }
+}
+
+// PRIVATE
+
+template <typename T, typename Allocator>
+uint32 SlotMap<T, Allocator>::AcquireSlot() {
+  if (_freeHead != SLOT_MAP_NO_FREE_SLOT) {
+    uint32 index = _freeHead;
+    SlotEntry &entry = _slots[index];
+    _freeHead = entry.dense;
+    // Back to odd, wrapping from UINT32_MAX through 0 to 1
+    entry.generation++;
+    return index;
+  }
+
+  _slots.Push({0, 1});
+  return (uint32)(_slots.GetLength() - 1);
+}
+
+template <typename T, typename Allocator>
+const typename SlotMap<T, Allocator>::SlotEntry *
+SlotMap<T, Allocator>::LookUp(SlotHandle handle) const {
+  if (!handle.IsValid() || handle.index >= _slots.GetLength()) {
+    return nullptr;
+  }
+
+  // Free slots never match, even a handle carrying their generation
+  const SlotEntry &entry = _slots[handle.index];
+  bool live = entry.generation & 1;
+  return live && entry.generation == handle.generation ? &entry : nullptr;
+}
+
+} // namespace containers
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_SLOT_MAP_HPP
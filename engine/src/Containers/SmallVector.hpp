@@ -0,0 +1,393 @@
+#ifndef _FLATEARTH_ENGINE_SMALL_VECTOR_HPP
+#define _FLATEARTH_ENGINE_SMALL_VECTOR_HPP
+
+#include "ContainerAllocator.hpp"
+#include "DArray.hpp"
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Definitions.hpp"
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace flatearth {
+namespace containers {
+
+// Dynamic array keeping its first N elements inline, it only allocates once
+// it outgrows them and from then on behaves like a DArray. Pointers to the
+// elements are invalidated when it grows, just like with a DArray.
+template <typename T, uint64 N, typename Allocator = DArrayDefaultAllocator>
+class SmallVector {
+public:
+  STATIC_ASSERT(N > 0, "Use a DArray for arrays without inline elements");
+
+  static constexpr uchar SMALL_VECTOR_RESIZE_FACTOR = 2;
+
+  explicit SmallVector(const Allocator &allocator = Allocator());
+  ~SmallVector();
+
+  SmallVector(const SmallVector &) = delete;
+  SmallVector &operator=(const SmallVector &) = delete;
+
+  Allocator &GetAllocator();
+
+  uint64 GetCapacity() const;
+  uint64 GetLength() const;
+  // Grows or shrinks the array, new elements are value-initialized
+  void SetLength(uint64 length);
+  constexpr uint64 GetStride() const;
+
+  // Only grows the capacity, the length is left untouched
+  void Reserve(uint64 numOfElements);
+
+  void Push(const T &element);
+  void Push(T &&element);
+  template <typename... Args> T &Emplace(Args &&...args);
+  void Pop();
+  // Copies count elements at the end of the array
+  void Append(const T *first, uint64 count);
+
+  void InsertAt(const T &element, uint64 index);
+  void PopAt(uint64 index);
+  // Removes in O(1) by moving the last element into the hole, does not keep
+  // the order
+  void PopAtSwap(uint64 index);
+  void Clear();
+
+  T *Data() noexcept;
+  const T *Data() const noexcept;
+
+  // Operators
+  T &operator[](uint64 index);
+  const T &operator[](uint64 index) const;
+
+  // Checkers
+  bool IsEmpty() const;
+  // False once the elements spilled to the heap
+  bool IsInline() const;
+
+private:
+  void Grow(uint64 newCapacity);
+  T *InlineData() noexcept;
+  void FreeHeap();
+
+  T *_data;
+  uint64 _length;
+  uint64 _capacity;
+  Allocator _allocator;
+  alignas(T) uchar _inline[N * sizeof(T)];
+};
+
+template <typename T, uint64 N, typename Allocator>
+SmallVector<T, N, Allocator>::SmallVector(const Allocator &allocator)
+    : _data(InlineData()), _length(0), _capacity(N), _allocator(allocator) {}
+
+template <typename T, uint64 N, typename Allocator>
+SmallVector<T, N, Allocator>::~SmallVector() {
+  Clear();
+  FreeHeap();
+}
+
+template <typename T, uint64 N, typename Allocator>
+Allocator &SmallVector<T, N, Allocator>::GetAllocator() {
+  return _allocator;
+}
+
+template <typename T, uint64 N, typename Allocator>
+uint64 SmallVector<T, N, Allocator>::GetCapacity() const {
+  return _capacity;
+}
+
+template <typename T, uint64 N, typename Allocator>
+uint64 SmallVector<T, N, Allocator>::GetLength() const {
+  return _length;
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::SetLength(uint64 length) {
+  Reserve(length);
+
+  if (length > _length) {
+    if constexpr (std::is_trivially_default_constructible_v<T>) {
+      core::memory::MemoryManager::ZeroMemory(_data + _length,
+                                              (length - _length) * sizeof(T));
+    } else {
+      for (uint64 i = _length; i < length; i++) {
+        new (_data + i) T();
+      }
+    }
+  }
+
+  for (uint64 i = length; i < _length; i++) {
+    _data[i].~T();
+  }
+
+  _length = length;
+}
+
+template <typename T, uint64 N, typename Allocator>
+constexpr uint64 SmallVector<T, N, Allocator>::GetStride() const {
+  return sizeof(T);
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Reserve(uint64 numOfElements) {
+  if (numOfElements <= _capacity) {
+    return;
+  }
+
+  Grow(numOfElements);
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Push(const T &element) {
+  Emplace(element);
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Push(T &&element) {
+  Emplace(std::move(element));
+}
+
+template <typename T, uint64 N, typename Allocator>
+template <typename... Args>
+T &SmallVector<T, N, Allocator>::Emplace(Args &&...args) {
+  if (_length >= _capacity) {
+    // The arguments may refer to elements of this array, build the new
+    // element before they move
+    T element(std::forward<Args>(args)...);
+    Grow(_capacity * SMALL_VECTOR_RESIZE_FACTOR);
+    return *new (_data + _length++) T(std::move(element));
+  }
+
+  return *new (_data + _length++) T(std::forward<Args>(args)...);
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Pop() {
+  if (_length == 0) {
+    return;
+  }
+
+  _data[--_length].~T();
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Append(const T *first, uint64 count) {
+  if (count == 0) {
+    return;
+  }
+
+  if (!first) {
+    FERROR("SmallVector<T, N>::Append(): attempt to append from a null range");
+    return;
+  }
+
+  if (_length + count > _capacity) {
+    // The range may be part of this array, find it again after growing
+    bool aliased = first >= _data && first < _data + _length;
+    uint64 offset = aliased ? first - _data : 0;
+
+    uint64 grown = _capacity * SMALL_VECTOR_RESIZE_FACTOR;
+    Grow(grown > _length + count ? grown : _length + count);
+
+    if (aliased) {
+      first = _data + offset;
+    }
+  }
+
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    core::memory::MemoryManager::CopyMemory(_data + _length, first,
+                                            count * sizeof(T));
+    _length += count;
+  } else {
+    for (uint64 i = 0; i < count; i++) {
+      new (_data + _length) T(first[i]);
+      _length++;
+    }
+  }
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::InsertAt(const T &element, uint64 index) {
+  if (index > _length) {
+    FERROR("SmallVector<T, N>::InsertAt(): attempt to insert at invalid index");
+    return;
+  }
+
+  if (index == _length) {
+    Emplace(element);
+    return;
+  }
+
+  // Taken before growing or shifting, the element may live in this array
+  T value(element);
+  if (_length >= _capacity) {
+    Grow(_capacity * SMALL_VECTOR_RESIZE_FACTOR);
+  }
+
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    std::memmove(static_cast<void *>(_data + index + 1), _data + index,
+                 (_length - index) * sizeof(T));
+    new (_data + index) T(std::move(value));
+  } else {
+    // The slot past the end holds no object yet, move-construct into it
+    new (_data + _length) T(std::move(_data[_length - 1]));
+    for (uint64 i = _length - 1; i > index; i--) {
+      _data[i] = std::move(_data[i - 1]);
+    }
+    _data[index] = std::move(value);
+  }
+
+  _length++;
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::PopAt(uint64 index) {
+  if (index >= _length) {
+    FERROR("SmallVector<T, N>::PopAt(): attempt to pop at invalid index");
+    return;
+  }
+
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    _data[index].~T();
+    std::memmove(static_cast<void *>(_data + index), _data + index + 1,
+                 (_length - index - 1) * sizeof(T));
+  } else {
+    for (uint64 i = index; i < _length - 1; i++) {
+      _data[i] = std::move(_data[i + 1]);
+    }
+    _data[_length - 1].~T();
+  }
+
+  _length--;
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::PopAtSwap(uint64 index) {
+  if (index >= _length) {
+    FERROR("SmallVector<T, N>::PopAtSwap(): attempt to pop at invalid index");
+    return;
+  }
+
+  if (index != _length - 1) {
+    _data[index] = std::move(_data[_length - 1]);
+  }
+
+  _data[--_length].~T();
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Clear() {
+  for (uint64 i = 0; i < _length; i++) {
+    _data[i].~T();
+  }
+
+  _length = 0;
+}
+
+template <typename T, uint64 N, typename Allocator>
+T *SmallVector<T, N, Allocator>::Data() noexcept {
+  return _data;
+}
+
+template <typename T, uint64 N, typename Allocator>
+const T *SmallVector<T, N, Allocator>::Data() const noexcept {
+  return _data;
+}
+
+template <typename T, uint64 N, typename Allocator>
+T &SmallVector<T, N, Allocator>::operator[](uint64 index) {
+  if (index >= _length) {
+    FERROR("SmallVector<T, N>::operator[]: index out of bounds");
+    throw std::out_of_range("Index out of bounds in SmallVector");
+  }
+
+  return _data[index];
+}
+
+template <typename T, uint64 N, typename Allocator>
+const T &SmallVector<T, N, Allocator>::operator[](uint64 index) const {
+  if (index >= _length) {
+    FERROR("SmallVector<T, N>::operator[]: index out of bounds");
+    throw std::out_of_range("Index out of bounds in SmallVector");
+  }
+
+  return _data[index];
+}
+
+template <typename T, uint64 N, typename Allocator>
+bool SmallVector<T, N, Allocator>::IsEmpty() const {
+  return _length == 0;
+}
+
+template <typename T, uint64 N, typename Allocator>
+bool SmallVector<T, N, Allocator>::IsInline() const {
+  return _capacity == N;
+}
+
+// PRIVATE
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::Grow(uint64 newCapacity) {
+  T *newData = nullptr;
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    if (!IsInline()) {
+      // Already on the heap, the allocator can move it in place
+      newData = reinterpret_cast<T *>(_allocator.Reallocate(
+          _data, _capacity * sizeof(T), newCapacity * sizeof(T), alignof(T),
+          core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+      if (!newData) {
+        FERROR("SmallVector<T, N>::Grow(): failed to grow to %llu elements",
+               newCapacity);
+        throw std::runtime_error("Failed to grow SmallVector");
+      }
+
+      _data = newData;
+      _capacity = newCapacity;
+      return;
+    }
+  }
+
+  newData = reinterpret_cast<T *>(
+      _allocator.Allocate(newCapacity * sizeof(T), alignof(T),
+                          core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+  if (!newData) {
+    FERROR("SmallVector<T, N>::Grow(): failed to grow to %llu elements",
+           newCapacity);
+    throw std::runtime_error("Failed to grow SmallVector");
+  }
+
+  if constexpr (IsTriviallyRelocatableV<T>) {
+    core::memory::MemoryManager::CopyMemory(newData, _data,
+                                            _length * sizeof(T));
+  } else {
+    for (uint64 i = 0; i < _length; i++) {
+      new (newData + i) T(std::move(_data[i]));
+      _data[i].~T();
+    }
+  }
+
+  FreeHeap();
+  _data = newData;
+  _capacity = newCapacity;
+}
+
+template <typename T, uint64 N, typename Allocator>
+T *SmallVector<T, N, Allocator>::InlineData() noexcept {
+  return reinterpret_cast<T *>(_inline);
+}
+
+template <typename T, uint64 N, typename Allocator>
+void SmallVector<T, N, Allocator>::FreeHeap() {
+  if (!IsInline()) {
+    _allocator.Free(_data, _capacity * sizeof(T), alignof(T));
+  }
+}
+
+} // namespace containers
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_SMALL_VECTOR_HPP
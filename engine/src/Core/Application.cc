@@ -3,7 +3,9 @@
 #include "Core/FeMemory.hpp"
 #include "Core/Logger.hpp"
 #include "GameTypes.hpp"
+#include "Memory/FrameAllocator.hpp"
 #include "Memory/LinearAllocator.hpp"
+#include "Memory/VirtualArena.hpp"
 #include "Platform/Platform.hpp"
 #include "Renderer/RendererFrontend.hpp"
 #include "Renderer/RendererTypes.inl"
@@ -28,7 +30,8 @@ void App::Preload(struct gametypes::Game *gameInstance) {
   }
 
   gameInstance->applicationState = core::memory::MemoryManager::Allocate(
-      sizeof(ApplicationState), core::memory::MEMORY_TAG_APPLICATION);
+      sizeof(ApplicationState), alignof(ApplicationState),
+      core::memory::MEMORY_TAG_APPLICATION);
   _appState =
       reinterpret_cast<ApplicationState *>(gameInstance->applicationState);
   _appState->gameInstance = gameInstance;
@@ -128,6 +131,12 @@ bool App::Run() {
       continue;
     }
 
+    // Releases everything allocated two frames ago
+    _appState->frameAllocator.BeginFrame();
+
+    // Samples peaks and checks budgets
+    memory::MemoryManager::Update();
+
     _appState->clock.Update();
     float64 currentTime = _appState->clock.elapsed;
     float64 deltaTime = (currentTime - _appState->lastTime);
@@ -177,6 +186,9 @@ bool App::Run() {
 
   _appState->isRunning = FeFalse;
 
+  // Writes out whatever is still buffered
+  memory::MemoryManager::StopTracing();
+
   return FeTrue;
 }
 
@@ -185,6 +197,10 @@ void App::GetFrameBufferSize(uint32 *width, uint32 *height) {
   *height = _appState->height;
 }
 
+flatearth::memory::FrameAllocator &App::GetFrameAllocator() {
+  return _appState->frameAllocator;
+}
+
 void App::ShutDown() {
   if (!_appState->gameInstance->applicationState) {
     return;
@@ -287,19 +303,40 @@ bool App::OnResized(events::SystemEventCode code, void *sender, void *listener,
 }
 
 bool App::AllocateAll() {
-  // Setup linear allocator
-  uint64 systemAllocatorTotalSize = 64 * 1024 * 1024;
-  new (&_appState->systemAllocator)
-      flatearth::memory::LinearAllocator(systemAllocatorTotalSize, nullptr);
+  // Setup system allocator, reserving address space is cheap so be generous.
+  // Engine systems scan it linearly, so ask for huge pages to cut TLB misses
+  uint64 systemAllocatorReserveSize = 1024ull * 1024 * 1024;
+  try {
+    new (&_appState->systemAllocator) flatearth::memory::VirtualArena(
+        systemAllocatorReserveSize,
+        flatearth::memory::VirtualArena::VIRTUAL_ARENA_DEFAULT_COMMIT_SIZE,
+        memory::ALLOCATION_FLAG_ZEROED | memory::ALLOCATION_FLAG_LARGE_PAGES);
+  } catch (const std::exception &e) {
+    FFATAL("App::AllocateAll(): failed to create system allocator: %s",
+           e.what());
+    return FeFalse;
+  }
+
+  // Setup per-frame allocator
+  try {
+    new (&_appState->frameAllocator) flatearth::memory::FrameAllocator(
+        _appState->gameInstance->appConfig.frameAllocatorSize, nullptr);
+  } catch (const std::exception &e) {
+    FFATAL("App::AllocateAll(): failed to create frame allocator: %s",
+           e.what());
+    return FeFalse;
+  }
 
   // Allocate memory for Logger
   void *mem = memory::MemoryManager::Allocate(sizeof(core::logger::Logger),
+                                              alignof(core::logger::Logger),
                                               memory::MEMORY_TAG_APPLICATION);
   auto *logger = new (mem) core::logger::Logger();
   _logger = unique_logger_ptr(
       logger,
       memory::StatefulCustomDeleter<core::logger::Logger>(
-          sizeof(core::logger::Logger), memory::MEMORY_TAG_APPLICATION));
+          sizeof(core::logger::Logger), memory::MEMORY_TAG_APPLICATION,
+          alignof(core::logger::Logger)));
 
   // Init with nullptr makes logger obj to own its memory
   uint64 loggerSystemMemSize = 0;
@@ -311,6 +348,7 @@ bool App::AllocateAll() {
   try {
     // Allocate memory for platform
     void *mem = memory::MemoryManager::Allocate(sizeof(platform::Platform),
+                                                alignof(platform::Platform),
                                                 memory::MEMORY_TAG_APPLICATION);
     auto *platform = new (mem)
         platform::Platform(_appState->gameInstance->appConfig.name,
@@ -321,7 +359,8 @@ bool App::AllocateAll() {
     _platform = unique_platform_ptr(
         platform,
         memory::StatefulCustomDeleter<platform::Platform>(
-            sizeof(platform::Platform), memory::MEMORY_TAG_APPLICATION));
+            sizeof(platform::Platform), memory::MEMORY_TAG_APPLICATION,
+            alignof(platform::Platform)));
     // _appState platform must point to _platform obj
     _appState->platform = _platform->GetState();
   } catch (const std::exception &e) {
@@ -332,14 +371,16 @@ bool App::AllocateAll() {
   try {
     // Allocate memory for the frontend renderer
     void *mem = core::memory::MemoryManager::Allocate(
-        sizeof(renderer::FrontendRenderer), memory::MEMORY_TAG_APPLICATION);
+        sizeof(renderer::FrontendRenderer), alignof(renderer::FrontendRenderer),
+        memory::MEMORY_TAG_APPLICATION);
     auto *frontendRenderer = new (mem) renderer::FrontendRenderer(
         _appState->gameInstance->appConfig.name, _appState->platform);
     _frontendRenderer = unique_frontend_renderer_ptr(
         frontendRenderer,
         core::memory::StatefulCustomDeleter<renderer::FrontendRenderer>(
             sizeof(renderer::FrontendRenderer),
-            core::memory::MEMORY_TAG_APPLICATION));
+            core::memory::MEMORY_TAG_APPLICATION,
+            alignof(renderer::FrontendRenderer)));
   } catch (const std::exception &e) {
     FFATAL("App::AllocateAll(): failed to create frontend renderer: %s",
            e.what());
@@ -7,7 +7,9 @@
 #include "Core/Input.hpp"
 #include "Definitions.hpp"
 #include "Logger.hpp"
+#include "Memory/FrameAllocator.hpp"
 #include "Memory/LinearAllocator.hpp"
+#include "Memory/VirtualArena.hpp"
 #include "Platform/Platform.hpp"
 #include "Renderer/RendererFrontend.hpp"
 
@@ -49,6 +51,21 @@ struct AppConfig {
 
   // Application name
   string name;
+
+  // Size of the engine heap backing MemoryManager. When 0, every allocation
+  // goes straight to the platform allocator
+  uint64 heapSize = 0;
+
+  // Size of each of the two per-frame scratch arenas
+  uint64 frameAllocatorSize = 8 * 1024 * 1024;
+
+  // Per-tag memory budgets in bytes, 0 means unlimited. Checked once per
+  // frame, see MemoryManager::Update()
+  std::array<uint64, core::memory::MEMORY_TAG_MAX_TAGS> memoryBudgets = {};
+
+  // When set, every allocation is traced into this file until shutdown, see
+  // MemoryManager::StartTracing()
+  string memoryTracePath;
 };
 
 struct ApplicationState {
@@ -61,7 +78,11 @@ struct ApplicationState {
   float64 lastTime;
   core::clock::Clock clock;
 
-  flatearth::memory::LinearAllocator systemAllocator;
+  // Only the pages actually used by engine systems are committed
+  flatearth::memory::VirtualArena systemAllocator;
+
+  // Reset at the top of every Run() iteration
+  flatearth::memory::FrameAllocator frameAllocator;
 };
 
 class App {
@@ -75,6 +96,9 @@ public:
 
   static void GetFrameBufferSize(uint32 *width, uint32 *height);
 
+  // Scratch memory valid for the current and the next frame
+  FEAPI static flatearth::memory::FrameAllocator &GetFrameAllocator();
+
   void ShutDown();
 
 private:
@@ -40,8 +40,7 @@ bool EventManager::RegisterEvent(SystemEventCode code, void *listener,
                                  EventCallback callback) {
   ushort ccode = ToUnderlying(code);
   if (_state.registered[ccode].events == nullptr) {
-    _state.registered[ccode].events =
-        std::make_unique<containers::DArray<RegisteredEvent>>();
+    _state.registered[ccode].events = std::make_unique<EventListeners>();
   }
 
   uint64 registeredCount = _state.registered[ccode].events->GetLength();
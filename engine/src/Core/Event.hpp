@@ -3,6 +3,7 @@
 
 #include "Containers/DArray.hpp"
 #include "Containers/SArray.hpp"
+#include "Containers/SmallVector.hpp"
 #include "Definitions.hpp"
 #include <array>
 #include <functional>
@@ -127,8 +128,14 @@ struct RegisteredEvent {
   }
 };
 
+// Most codes only have a handful of listeners, they are kept inline
+constexpr uint64 EVENT_INLINE_LISTENERS = 4;
+
+using EventListeners =
+    containers::SmallVector<RegisteredEvent, EVENT_INLINE_LISTENERS>;
+
 struct EventCodeEntry {
-  std::unique_ptr<containers::DArray<RegisteredEvent>> events;
+  std::unique_ptr<EventListeners> events;
 };
 
 struct EventSystemState {
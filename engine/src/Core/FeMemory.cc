@@ -2,7 +2,12 @@
 
 #include "GameTypes.hpp"
 #include "Logger.hpp"
+#include "Math/FeMath.hpp"
+#include "Memory/AllocationTracer.hpp"
+#include "Memory/FreeListAllocator.hpp"
 #include "Platform/Platform.hpp"
+#include <algorithm>
+#include <fstream>
 #include <ostream>
 #include <print>
 #include <sstream>
@@ -13,6 +18,8 @@ namespace memory {
 
 MemorySystemState *MemoryManager::_memoryState;
 bool MemoryManager::_initialized = FeFalse;
+const uchar *MemoryManager::_heapStart = nullptr;
+const uchar *MemoryManager::_heapEnd = nullptr;
 
 static constexpr std::array<vstring, MEMORY_TAG_MAX_TAGS> memTagNames = {
     "UNKNOWN",     "ARRAY",       "DARRAY",
@@ -21,7 +28,8 @@ static constexpr std::array<vstring, MEMORY_TAG_MAX_TAGS> memTagNames = {
     "TEXTURE",     "MAT_INST",    "RENDERER",
     "GAME",        "TRANSFORM",   "ENTITY",
     "ENTITY_NODE", "SCENE",       "LINEAR_ALLOCATOR",
-    "MEMORY_MGR"};
+    "FREELIST_ALLOC", "POOL_ALLOC", "STACK_ALLOC",
+    "FRAME_ALLOC", "VIRTUAL_ARENA", "RELOC_HEAP", "MEMORY_MGR"};
 
 MemoryManager &MemoryManager::GetInstance() {
   static MemoryManager instance = MemoryManager();
@@ -35,17 +43,23 @@ void MemoryManager::Preload(struct gametypes::Game *gameInstance) {
     return;
   }
 
-  // Bootstrap memory manager allocation directly from platform
-  void *raw =
-      platform::Platform::PAllocateMemory(sizeof(MemorySystemState), FeFalse);
-  platform::Platform::PZeroMemory(raw, sizeof(MemorySystemState));
-  _memoryState = reinterpret_cast<MemorySystemState *>(raw);
+  CreateState();
   gameInstance->memoryState = _memoryState;
 
-  // Manual tracking since Allocate() was bypassed
-  _memoryState->stats.totalAllocated += sizeof(MemorySystemState);
-  _memoryState->stats.taggedAllocations[MEMORY_TAG_MEMORY_MGR] +=
-      sizeof(MemorySystemState);
+  for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+    SetBudget((MemoryTag)i, gameInstance->appConfig.memoryBudgets[i]);
+  }
+
+  uint64 heapSize = gameInstance->appConfig.heapSize;
+  if (heapSize > 0 && !InitializeHeap(heapSize)) {
+    FWARN("MemoryManager::Preload(): failed to create the engine heap, "
+          "falling back to platform allocations");
+  }
+
+  const string &tracePath = gameInstance->appConfig.memoryTracePath;
+  if (!tracePath.empty()) {
+    StartTracing(tracePath);
+  }
 }
 
 void MemoryManager::TestPreload() {
@@ -54,46 +68,80 @@ void MemoryManager::TestPreload() {
 
   // This is for testing purposes (otherwise we won't be able to preload
   // the memory manager)
-  void *raw =
-      platform::Platform::PAllocateMemory(sizeof(MemorySystemState), FeFalse);
-  platform::Platform::PZeroMemory(raw, sizeof(MemorySystemState));
-  _memoryState = reinterpret_cast<MemorySystemState *>(raw);
-  _memoryState->stats.totalAllocated += sizeof(MemorySystemState);
-  _memoryState->stats.taggedAllocations[MEMORY_TAG_MEMORY_MGR] +=
-      sizeof(MemorySystemState);
+  CreateState();
   _initialized = FeTrue;
 }
 
 MemoryManager::~MemoryManager() {
   FINFO("MemoryManager::~MemoryManager(): shutting down memory manager...");
+  StopTracing();
   _memoryState = nullptr;
   _initialized = FeFalse;
 }
 
 void *MemoryManager::Allocate(uint64 size, MemoryTag tag) {
-  CheckTag(tag, "MemoryManager::Allocate()");
+  return AllocateBlock(size, MEMORY_DEFAULT_ALIGNMENT, tag,
+                       ALLOCATION_FLAG_ZEROED, FE_RETURN_ADDRESS());
+}
 
-  // Track how much memory used by category
-  if (_memoryState) {
-    _memoryState->stats.totalAllocated += size;
-    _memoryState->stats.taggedAllocations[tag] += size;
-    _memoryState->allocCount++;
-  }
-  // TODO: memory alignment
-  bool aligned = FeFalse;
-  void *block = platform::Platform::PAllocateMemory(size, aligned);
-  platform::Platform::PZeroMemory(block, size);
-  return block;
+void *MemoryManager::Allocate(uint64 size, uint64 alignment, MemoryTag tag,
+                              uint32 flags) {
+  return AllocateBlock(size, alignment, tag, flags, FE_RETURN_ADDRESS());
 }
 
 void MemoryManager::Free(void *block, uint64 size, MemoryTag tag) {
-  CheckTag(tag, "MemoryManager::Free()");
+  FreeBlock(block, size, MEMORY_DEFAULT_ALIGNMENT, tag, FE_RETURN_ADDRESS());
+}
+
+void MemoryManager::Free(void *block, uint64 size, uint64 alignment,
+                         MemoryTag tag) {
+  FreeBlock(block, size, alignment, tag, FE_RETURN_ADDRESS());
+}
+
+void MemoryManager::FreePacked(void *block, uint64 packed) {
+  FreeBlock(block, PackedSize(packed), PackedAlignment(packed),
+            PackedTag(packed), FE_RETURN_ADDRESS());
+}
+
+void *MemoryManager::Reallocate(void *block, uint64 size, uint64 newSize,
+                                uint64 alignment, MemoryTag tag,
+                                uint32 flags) {
+  const void *callsite = FE_RETURN_ADDRESS();
+  if (!block) {
+    return AllocateBlock(newSize, alignment, tag, flags, callsite);
+  }
+
+  CheckTag(tag, "MemoryManager::Reallocate()");
+  if (newSize == 0) {
+    FERROR("MemoryManager::Reallocate(): new size must be greater than 0");
+    return nullptr;
+  }
+
+  void *newBlock = nullptr;
+  if (!InHeap(block)) {
+    newBlock = platform::Platform::PReallocateMemory(block, newSize, alignment);
+  }
+
+  if (newBlock) {
+    RecordFree(size, tag, block, callsite);
+    RecordAllocation(newSize, tag, newBlock, callsite);
+  } else {
+    newBlock = AllocateBlock(newSize, alignment, tag,
+                             ALLOCATION_FLAG_UNINITIALIZED, callsite);
+    if (!newBlock) {
+      return nullptr;
+    }
+
+    CopyMemory(newBlock, block, size < newSize ? size : newSize);
+    FreeBlock(block, size, alignment, tag, callsite);
+  }
 
-  _memoryState->stats.totalAllocated -= size;
-  _memoryState->stats.taggedAllocations[tag] -= size;
+  if (newSize > size) {
+    InitializeMemory(static_cast<uchar *>(newBlock) + size, newSize - size,
+                     flags);
+  }
 
-  bool aligned = FeFalse;
-  platform::Platform::PFreeMemory(block, aligned);
+  return newBlock;
 }
 
 void *MemoryManager::ZeroMemory(void *block, uint64 size) {
@@ -108,18 +156,263 @@ void *MemoryManager::SetMemory(void *dest, sint32 value, uint64 size) {
   return platform::Platform::PSetMemory(dest, value, size);
 }
 
+void MemoryManager::InitializeMemory(void *block, uint64 size, uint32 flags) {
+  if (!block || size == 0) {
+    return;
+  }
+
+  if (flags & ALLOCATION_FLAG_ZEROED) {
+    platform::Platform::PZeroMemory(block, size);
+  } else if (MEMORY_POISON_ENABLED && (flags & ALLOCATION_FLAG_POISONED)) {
+    platform::Platform::PSetMemory(block, MEMORY_POISON_PATTERN, size);
+  }
+}
+
+void MemoryManager::TrackAllocation(uint64 size, MemoryTag tag) {
+  CheckTag(tag, "MemoryManager::TrackAllocation()");
+  RecordAllocation(size, tag);
+}
+
+void MemoryManager::TrackFree(uint64 size, MemoryTag tag) {
+  CheckTag(tag, "MemoryManager::TrackFree()");
+  RecordFree(size, tag);
+}
+
+void MemoryManager::TrackReclaimed(uint64 size, MemoryTag tag) {
+  CheckTag(tag, "MemoryManager::TrackReclaimed()");
+  if (!_memoryState) {
+    return;
+  }
+
+  _memoryState->taggedReclaimed[tag].fetch_add(size, std::memory_order_relaxed);
+}
+
+void *MemoryManager::AllocateLargePages(uint64 size, MemoryTag tag,
+                                        uint32 flags,
+                                        platform::LargePageKind *kind) {
+  CheckTag(tag, "MemoryManager::AllocateLargePages()");
+
+  void *block = platform::Platform::PAllocateLargePages(size, kind);
+  if (!block) {
+    FERROR("MemoryManager::AllocateLargePages(): failed to allocate %lluB",
+           size);
+    return nullptr;
+  }
+
+  if (*kind == platform::LARGE_PAGE_NONE) {
+    FWARN("MemoryManager::AllocateLargePages(): huge pages unavailable for "
+          "%lluB, using regular pages",
+          size);
+  }
+
+  RecordAllocation(size, tag, block, FE_RETURN_ADDRESS());
+  TrackLargePages(size, *kind, FeTrue);
+
+  if (flags & ALLOCATION_FLAG_POISONED) {
+    InitializeMemory(block, size, ALLOCATION_FLAG_POISONED);
+  }
+
+  return block;
+}
+
+void MemoryManager::FreeLargePages(void *block, uint64 size, MemoryTag tag,
+                                   platform::LargePageKind kind) {
+  if (!block) {
+    return;
+  }
+
+  CheckTag(tag, "MemoryManager::FreeLargePages()");
+  RecordFree(size, tag, block, FE_RETURN_ADDRESS());
+  TrackLargePages(size, kind, FeFalse);
+  platform::Platform::PFreeLargePages(block, size);
+}
+
+void MemoryManager::TrackLargePages(uint64 size, platform::LargePageKind kind,
+                                    bool allocated) {
+  if (!_memoryState || kind >= platform::LARGE_PAGE_MAX_KINDS) {
+    return;
+  }
+
+  if (allocated) {
+    _memoryState->largePageAllocations[kind].fetch_add(
+        size, std::memory_order_relaxed);
+  } else {
+    _memoryState->largePageAllocations[kind].fetch_sub(
+        size, std::memory_order_relaxed);
+  }
+}
+
+MemoryBlock MemoryManager::GetStats() {
+  MemoryBlock stats = {};
+  if (!_memoryState) {
+    return stats;
+  }
+
+  for (const MemoryStatShard &shard : _memoryState->statShards) {
+    stats.totalAllocated +=
+        shard.totalAllocated.load(std::memory_order_relaxed);
+    stats.allocCount += shard.allocCount.load(std::memory_order_relaxed);
+    stats.freeCount += shard.freeCount.load(std::memory_order_relaxed);
+    for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+      stats.taggedAllocations[i] +=
+          shard.taggedAllocations[i].load(std::memory_order_relaxed);
+      stats.taggedAllocCounts[i] +=
+          shard.taggedAllocCounts[i].load(std::memory_order_relaxed);
+      stats.taggedFreeCounts[i] +=
+          shard.taggedFreeCounts[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+    uint64 peak = _memoryState->taggedPeaks[i].load(std::memory_order_relaxed);
+    stats.taggedPeaks[i] = std::max(peak, stats.taggedAllocations[i]);
+    stats.taggedBudgets[i] =
+        _memoryState->taggedBudgets[i].load(std::memory_order_relaxed);
+    stats.taggedReclaimed[i] =
+        _memoryState->taggedReclaimed[i].load(std::memory_order_relaxed);
+  }
+
+  return stats;
+}
+
+void MemoryManager::SetBudget(MemoryTag tag, uint64 budget) {
+  CheckTag(tag, "MemoryManager::SetBudget()");
+  if (!_memoryState) {
+    return;
+  }
+
+  _memoryState->taggedBudgets[tag].store(budget, std::memory_order_relaxed);
+  _memoryState->overBudget[tag].store(FeFalse, std::memory_order_relaxed);
+}
+
+uint64 MemoryManager::GetBudget(MemoryTag tag) {
+  if (!_memoryState) {
+    return 0;
+  }
+
+  return _memoryState->taggedBudgets[tag].load(std::memory_order_relaxed);
+}
+
+void MemoryManager::SetBudgetCallback(MemoryBudgetCallback callback) {
+  if (!_memoryState) {
+    return;
+  }
+
+  _memoryState->budgetCallback = std::move(callback);
+}
+
+void MemoryManager::Update() {
+  if (!_memoryState) {
+    return;
+  }
+
+  const MemoryBlock stats = GetStats();
+  for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+    uint64 allocated = stats.taggedAllocations[i];
+
+    std::atomic<uint64> &peak = _memoryState->taggedPeaks[i];
+    uint64 currentPeak = peak.load(std::memory_order_relaxed);
+    while (allocated > currentPeak &&
+           !peak.compare_exchange_weak(currentPeak, allocated,
+                                       std::memory_order_relaxed)) {
+    }
+
+    uint64 budget = stats.taggedBudgets[i];
+    if (budget == 0) {
+      continue;
+    }
+
+    // Only report when crossing the budget, not on every sample above it
+    bool over = allocated > budget;
+    bool wasOver = _memoryState->overBudget[i].exchange(
+        over, std::memory_order_relaxed);
+    if (!over || wasOver) {
+      continue;
+    }
+
+    if (_memoryState->budgetCallback) {
+      _memoryState->budgetCallback((MemoryTag)i, allocated, budget);
+    } else {
+      FWARN("MemoryManager::Update(): %s is over budget (%lluB of %lluB)",
+            memTagNames[i].data(), allocated, budget);
+    }
+  }
+}
+
+bool MemoryManager::StartTracing(const string &path, bool captureCallsites) {
+  if (!_memoryState) {
+    FERROR("MemoryManager::StartTracing(): memory manager not preloaded");
+    return FeFalse;
+  }
+
+  std::lock_guard<std::mutex> lock(_memoryState->tracerMutex);
+  flatearth::memory::AllocationTracer *tracer =
+      _memoryState->tracer.load(std::memory_order_relaxed);
+  if (!tracer) {
+    // Bootstrapped from the platform, the tracer is not part of the trace
+    void *raw = platform::Platform::PAllocateMemory(
+        sizeof(flatearth::memory::AllocationTracer),
+        alignof(flatearth::memory::AllocationTracer));
+    if (!raw) {
+      FERROR("MemoryManager::StartTracing(): failed to allocate the tracer");
+      return FeFalse;
+    }
+
+    tracer = new (raw) flatearth::memory::AllocationTracer();
+    _memoryState->tracer.store(tracer, std::memory_order_release);
+  }
+
+  if (!tracer->Start(path, memTagNames.data(), MEMORY_TAG_MAX_TAGS,
+                     captureCallsites)) {
+    return FeFalse;
+  }
+
+  FINFO("MemoryManager::StartTracing(): tracing allocations into '%s'",
+        path.c_str());
+  return FeTrue;
+}
+
+void MemoryManager::StopTracing() {
+  if (!_memoryState) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(_memoryState->tracerMutex);
+  flatearth::memory::AllocationTracer *tracer =
+      _memoryState->tracer.load(std::memory_order_relaxed);
+  if (!tracer || !tracer->IsRunning()) {
+    return;
+  }
+
+  tracer->Stop();
+  FINFO("MemoryManager::StopTracing(): %llu allocation events written",
+        tracer->GetWrittenCount());
+}
+
+bool MemoryManager::IsTracing() {
+  if (!_memoryState) {
+    return FeFalse;
+  }
+
+  flatearth::memory::AllocationTracer *tracer =
+      _memoryState->tracer.load(std::memory_order_acquire);
+  return tracer && tracer->IsRunning();
+}
+
 string MemoryManager::PrintMemoryUsage() const {
   constexpr uint64 kib = 1024;
   constexpr uint64 mib = 1024 * kib;
   constexpr uint64 gib = 1024 * mib;
 
+  const MemoryBlock stats = GetStats();
+
   std::ostringstream oss;
   oss << "System memory usage (tagged):\n";
   std::print("{}", oss.str());
   for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
     string unit = "XiB";
     float32 amount = 1.0f;
-    const uint64 &taggedAlloc = _memoryState->stats.taggedAllocations[i];
+    const uint64 &taggedAlloc = stats.taggedAllocations[i];
     if (taggedAlloc >= gib) {
       unit[0] = 'G';
       amount = taggedAlloc / (float32)gib;
@@ -140,9 +433,83 @@ string MemoryManager::PrintMemoryUsage() const {
     std::print("{}", out);
   }
 
+  if (_memoryState->heap) {
+    const flatearth::memory::FreeListAllocator *heap = _memoryState->heap;
+    const string &out =
+        std::format("Heap: {:.2f} MiB used of {:.2f} MiB\n",
+                    heap->GetAllocatedSize() / (float32)mib,
+                    heap->GetTotalSize() / (float32)mib);
+    oss << out;
+    std::print("{}", out);
+  }
+
+  std::array<uint64, platform::LARGE_PAGE_MAX_KINDS> largePages;
+  for (uint64 i = 0; i < platform::LARGE_PAGE_MAX_KINDS; i++) {
+    largePages[i] =
+        _memoryState->largePageAllocations[i].load(std::memory_order_relaxed);
+  }
+
+  if (largePages[platform::LARGE_PAGE_NONE] > 0 ||
+      largePages[platform::LARGE_PAGE_TRANSPARENT] > 0 ||
+      largePages[platform::LARGE_PAGE_EXPLICIT] > 0) {
+    const string &out = std::format(
+        "Large pages: {:.2f} MiB explicit, {:.2f} MiB transparent, {:.2f} "
+        "MiB unavailable\n",
+        largePages[platform::LARGE_PAGE_EXPLICIT] / (float32)mib,
+        largePages[platform::LARGE_PAGE_TRANSPARENT] / (float32)mib,
+        largePages[platform::LARGE_PAGE_NONE] / (float32)mib);
+    oss << out;
+    std::print("{}", out);
+  }
+
+  return oss.str();
+}
+
+string MemoryManager::DumpMemoryUsage(MemoryReportFormat format) {
+  const MemoryBlock stats = GetStats();
+  std::ostringstream oss;
+
+  if (format == MEMORY_REPORT_CSV) {
+    oss << "tag,allocated,peak,budget,alloc_count,free_count,reclaimed\n";
+    for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+      oss << std::format("{},{},{},{},{},{},{}\n", memTagNames[i],
+                         stats.taggedAllocations[i], stats.taggedPeaks[i],
+                         stats.taggedBudgets[i], stats.taggedAllocCounts[i],
+                         stats.taggedFreeCounts[i], stats.taggedReclaimed[i]);
+    }
+    return oss.str();
+  }
+
+  oss << std::format("{{\"totalAllocated\":{},\"allocCount\":{},"
+                     "\"freeCount\":{},\"tags\":[",
+                     stats.totalAllocated, stats.allocCount, stats.freeCount);
+  for (uint64 i = 0; i < MEMORY_TAG_MAX_TAGS; i++) {
+    oss << std::format(
+        "{}{{\"tag\":\"{}\",\"allocated\":{},\"peak\":{},\"budget\":{},"
+        "\"allocCount\":{},\"freeCount\":{},\"reclaimed\":{}}}",
+        i > 0 ? "," : "", memTagNames[i], stats.taggedAllocations[i],
+        stats.taggedPeaks[i], stats.taggedBudgets[i],
+        stats.taggedAllocCounts[i], stats.taggedFreeCounts[i],
+        stats.taggedReclaimed[i]);
+  }
+  oss << "]}\n";
+
   return oss.str();
 }
 
+bool MemoryManager::WriteMemoryUsage(const string &path,
+                                     MemoryReportFormat format) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    FERROR("MemoryManager::WriteMemoryUsage(): could not open '%s'",
+           path.c_str());
+    return FeFalse;
+  }
+
+  file << DumpMemoryUsage(format);
+  return file.good();
+}
+
 // Private members
 
 MemoryManager::MemoryManager() {
@@ -155,6 +522,153 @@ MemoryManager::MemoryManager() {
   FINFO("MemoryManager::MemoryManager(): memory manager correctly initialized");
 }
 
+bool MemoryManager::InitializeHeap(uint64 heapSize) {
+  // Bootstrapped from the platform as well, the heap cannot allocate itself
+  void *heapMemory =
+      platform::Platform::PAllocateMemory(heapSize, MEMORY_CACHE_LINE_SIZE);
+  void *heapObject = platform::Platform::PAllocateMemory(
+      sizeof(flatearth::memory::FreeListAllocator),
+      alignof(flatearth::memory::FreeListAllocator));
+  if (!heapMemory || !heapObject) {
+    platform::Platform::PFreeMemory(heapMemory, MEMORY_CACHE_LINE_SIZE);
+    platform::Platform::PFreeMemory(
+        heapObject, alignof(flatearth::memory::FreeListAllocator));
+    return FeFalse;
+  }
+
+  _memoryState->heap = new (heapObject)
+      flatearth::memory::FreeListAllocator(heapSize, heapMemory);
+  _heapStart = static_cast<const uchar *>(heapMemory);
+  _heapEnd = _heapStart + heapSize;
+  RecordAllocation(sizeof(flatearth::memory::FreeListAllocator),
+                   MEMORY_TAG_MEMORY_MGR);
+
+  FINFO("MemoryManager::InitializeHeap(): engine heap of %lluB created",
+        heapSize);
+  return FeTrue;
+}
+
+void MemoryManager::CreateState() {
+  // Bootstrap memory manager allocation directly from platform
+  void *raw = platform::Platform::PAllocateMemory(sizeof(MemorySystemState),
+                                                  alignof(MemorySystemState));
+  _memoryState = new (raw) MemorySystemState();
+
+  // Manual tracking since Allocate() was bypassed
+  RecordAllocation(sizeof(MemorySystemState), MEMORY_TAG_MEMORY_MGR);
+}
+
+void *MemoryManager::AllocateBlock(uint64 size, uint64 alignment,
+                                   MemoryTag tag, uint32 flags,
+                                   const void *callsite) {
+  CheckTag(tag, "MemoryManager::Allocate()");
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("MemoryManager::Allocate(): alignment must be a power of 2 (got "
+           "%llu)",
+           alignment);
+    return nullptr;
+  }
+
+  void *block = nullptr;
+  if (_memoryState && _memoryState->heap && size > 0) {
+    std::lock_guard<std::mutex> lock(_memoryState->heapMutex);
+    block = _memoryState->heap->Allocate(size, alignment);
+  }
+
+  // Heap exhausted or disabled
+  if (!block) {
+    block = platform::Platform::PAllocateMemory(size, alignment);
+  }
+
+  if (!block) {
+    FERROR("MemoryManager::Allocate(): failed to allocate %lluB", size);
+    return nullptr;
+  }
+
+  // Track how much memory used by category
+  RecordAllocation(size, tag, block, callsite);
+
+  InitializeMemory(block, size, flags);
+  return block;
+}
+
+void MemoryManager::FreeBlock(void *block, uint64 size, uint64 alignment,
+                              MemoryTag tag, const void *callsite) {
+  CheckTag(tag, "MemoryManager::Free()");
+
+  RecordFree(size, tag, block, callsite);
+
+  if (!InHeap(block)) {
+    platform::Platform::PFreeMemory(block, alignment);
+    return;
+  }
+
+  // Heap blocks freed after shutdown (e.g. by a function local static) are
+  // dropped, the heap memory itself is released with the process
+  if (_memoryState && _memoryState->heap) {
+    std::lock_guard<std::mutex> lock(_memoryState->heapMutex);
+    _memoryState->heap->Free(block);
+  }
+}
+
+// Heap bounds never change, no lock needed
+bool MemoryManager::InHeap(const void *block) {
+  const uchar *ptr = static_cast<const uchar *>(block);
+  return ptr >= _heapStart && ptr < _heapEnd;
+}
+
+MemoryStatShard &MemoryManager::LocalStatShard() {
+  // Threads pick a shard the first time they allocate
+  static std::atomic<uint64> nextShard = 0;
+  thread_local uint64 shardIndex =
+      nextShard.fetch_add(1, std::memory_order_relaxed) %
+      MEMORY_STAT_SHARD_COUNT;
+  return _memoryState->statShards[shardIndex];
+}
+
+// Shards are only shared when there are more threads than shards, so these
+// atomics stay uncontended in practice
+void MemoryManager::RecordAllocation(uint64 size, MemoryTag tag,
+                                     const void *block, const void *callsite) {
+  if (!_memoryState) {
+    return;
+  }
+
+  flatearth::memory::AllocationTracer *tracer =
+      _memoryState->tracer.load(std::memory_order_acquire);
+  if (tracer) {
+    tracer->Record(flatearth::memory::ALLOCATION_TRACE_ALLOCATE, block, size,
+                   tag, callsite);
+  }
+
+  MemoryStatShard &shard = LocalStatShard();
+  shard.totalAllocated.fetch_add(size, std::memory_order_relaxed);
+  shard.taggedAllocations[tag].fetch_add(size, std::memory_order_relaxed);
+  shard.allocCount.fetch_add(1, std::memory_order_relaxed);
+  shard.taggedAllocCounts[tag].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryManager::RecordFree(uint64 size, MemoryTag tag, const void *block,
+                               const void *callsite) {
+  if (!_memoryState) {
+    return;
+  }
+
+  flatearth::memory::AllocationTracer *tracer =
+      _memoryState->tracer.load(std::memory_order_acquire);
+  if (tracer) {
+    tracer->Record(flatearth::memory::ALLOCATION_TRACE_FREE, block, size, tag,
+                   callsite);
+  }
+
+  MemoryStatShard &shard = LocalStatShard();
+  shard.totalAllocated.fetch_sub(size, std::memory_order_relaxed);
+  shard.taggedAllocations[tag].fetch_sub(size, std::memory_order_relaxed);
+  shard.freeCount.fetch_add(1, std::memory_order_relaxed);
+  shard.taggedFreeCounts[tag].fetch_add(1, std::memory_order_relaxed);
+}
+
 void MemoryManager::CheckTag(MemoryTag tag, const string &from) {
   if (tag < 0 || tag >= MEMORY_TAG_MAX_TAGS) {
     FERROR("%s: Invalid memory tag index (%d)", from.c_str(), tag);
@@ -3,8 +3,22 @@
 
 #include "Definitions.hpp"
 #include "Core/Logger.hpp"
+#include "Platform/Platform.hpp"
 
 #include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+// Debug poisoning of uninitialized memory, disabled for releases
+#define MEMORY_POISON_ENABLED 1
+
+#if FERELEASE == 1
+#undef MEMORY_POISON_ENABLED
+#define MEMORY_POISON_ENABLED 0
+#endif
 
 namespace flatearth {
 
@@ -12,6 +26,11 @@ namespace gametypes {
   struct Game;
 }
 
+namespace memory {
+  class FreeListAllocator;
+  class AllocationTracer;
+}
+
 namespace core {
 namespace memory {
 
@@ -34,34 +53,131 @@ enum MemoryTag {
   MEMORY_TAG_ENTITY_NODE,
   MEMORY_TAG_SCENE,
   MEMORY_TAG_LINEAR_ALLOCATOR,
+  MEMORY_TAG_FREELIST_ALLOCATOR,
+  MEMORY_TAG_POOL_ALLOCATOR,
+  MEMORY_TAG_STACK_ALLOCATOR,
+  MEMORY_TAG_FRAME_ALLOCATOR,
+  MEMORY_TAG_VIRTUAL_ARENA,
+  MEMORY_TAG_RELOCATABLE_HEAP,
   MEMORY_TAG_MEMORY_MGR,
   MEMORY_TAG_MAX_TAGS,
 };
 
-template <typename T> auto make_unique_void(T *ptr) -> unique_void_ptr {
-  return unique_void_ptr(ptr, [](void const *data) {
-    T const *p = static_cast<T const *>(data);
-    delete p;
-  });
+// Alignment guaranteed by a plain platform allocation. Requests at or below
+// this value take the unaligned path
+constexpr uint64 MEMORY_DEFAULT_ALIGNMENT = alignof(std::max_align_t);
+
+// Cache line size assumed for padding hot structures
+constexpr uint64 MEMORY_CACHE_LINE_SIZE = 64;
+
+// Byte written over poisoned memory, easy to spot in a debugger
+constexpr uchar MEMORY_POISON_PATTERN = 0xCD;
+
+// A block's size, tag and alignment packed in one word, so deleters stay a
+// single word wide: the size takes the low 48 bits, then the tag and the
+// log2 of the alignment take a byte each
+constexpr uint64 MEMORY_PACKED_SIZE_BITS = 48;
+constexpr uint64 MEMORY_PACKED_SIZE_MASK = (1ull << MEMORY_PACKED_SIZE_BITS) - 1;
+
+constexpr uint64 PackAllocation(uint64 size, MemoryTag tag,
+                                uint64 alignment = MEMORY_DEFAULT_ALIGNMENT) {
+  return (size & MEMORY_PACKED_SIZE_MASK) |
+         ((uint64)(tag & 0xFF) << MEMORY_PACKED_SIZE_BITS) |
+         ((uint64)std::countr_zero(alignment) << (MEMORY_PACKED_SIZE_BITS + 8));
 }
 
-template <typename T>
-T* get_unique_void_ptr(const unique_void_ptr& ptr) {
-  if (!ptr) {
-    FFATAL("get_unique_void_ptr<T>(): ptr is null");
-    return nullptr;
-  }
-  return reinterpret_cast<T*>(ptr.get());
+constexpr uint64 PackedSize(uint64 packed) {
+  return packed & MEMORY_PACKED_SIZE_MASK;
+}
+
+constexpr MemoryTag PackedTag(uint64 packed) {
+  return (MemoryTag)((packed >> MEMORY_PACKED_SIZE_BITS) & 0xFF);
 }
 
+constexpr uint64 PackedAlignment(uint64 packed) {
+  return 1ull << (packed >> (MEMORY_PACKED_SIZE_BITS + 8));
+}
+
+// How a block handed out by an allocator is initialized
+enum AllocationFlags : uint32 {
+  // Contents are left as they are, the caller writes every byte it reads
+  ALLOCATION_FLAG_UNINITIALIZED = 0,
+  ALLOCATION_FLAG_ZEROED = 1 << 0,
+  // Filled with MEMORY_POISON_PATTERN when MEMORY_POISON_ENABLED, otherwise
+  // the same as ALLOCATION_FLAG_UNINITIALIZED
+  ALLOCATION_FLAG_POISONED = 1 << 1,
+  // Arenas owning their memory back it with huge pages when possible, see
+  // MemoryManager::AllocateLargePages()
+  ALLOCATION_FLAG_LARGE_PAGES = 1 << 2,
+};
+
+// Number of statistic shards, threads beyond this count share shards
+constexpr uint64 MEMORY_STAT_SHARD_COUNT = 64;
+
+// Merged view of the statistics, see MemoryManager::GetStats()
 struct MemoryBlock {
   uint64 totalAllocated;
+  uint64 allocCount;
+  uint64 freeCount;
   std::array<uint64, MEMORY_TAG_MAX_TAGS> taggedAllocations;
+  std::array<uint64, MEMORY_TAG_MAX_TAGS> taggedAllocCounts;
+  std::array<uint64, MEMORY_TAG_MAX_TAGS> taggedFreeCounts;
+  // High-water marks, as of the last MemoryManager::Update() or this query
+  std::array<uint64, MEMORY_TAG_MAX_TAGS> taggedPeaks;
+  // 0 means no budget
+  std::array<uint64, MEMORY_TAG_MAX_TAGS> taggedBudgets;
+  // Bytes of freed blocks compacted away by defragmentation
+  std::array<uint64, MEMORY_TAG_MAX_TAGS> taggedReclaimed;
+};
+
+// Statistics written by the threads mapped to this shard. Padded to a cache
+// line so threads never contend on each other's counters. A block freed on
+// another thread than the one that allocated it makes the shards drift apart
+// (wrapping around), only their sum is meaningful.
+struct alignas(MEMORY_CACHE_LINE_SIZE) MemoryStatShard {
+  std::atomic<uint64> totalAllocated;
+  std::atomic<uint64> allocCount;
+  std::atomic<uint64> freeCount;
+  std::array<std::atomic<uint64>, MEMORY_TAG_MAX_TAGS> taggedAllocations;
+  std::array<std::atomic<uint64>, MEMORY_TAG_MAX_TAGS> taggedAllocCounts;
+  std::array<std::atomic<uint64>, MEMORY_TAG_MAX_TAGS> taggedFreeCounts;
+};
+
+// Called once each time a tag goes over its budget
+using MemoryBudgetCallback =
+    std::function<void(MemoryTag tag, uint64 allocated, uint64 budget)>;
+
+enum MemoryReportFormat {
+  MEMORY_REPORT_JSON,
+  MEMORY_REPORT_CSV,
 };
 
 struct MemorySystemState {
-  MemoryBlock stats;
-  uint64 allocCount;
+  std::array<MemoryStatShard, MEMORY_STAT_SHARD_COUNT> statShards;
+
+  // Heap serving all tagged allocations, nullptr when disabled. Not thread
+  // safe on its own, guarded by heapMutex
+  flatearth::memory::FreeListAllocator *heap;
+  std::mutex heapMutex;
+
+  // Bytes requested with large pages, by what the platform delivered
+  std::array<std::atomic<uint64>, platform::LARGE_PAGE_MAX_KINDS>
+      largePageAllocations;
+
+  // Budgets are checked and peaks sampled on the merged statistics, see
+  // MemoryManager::Update()
+  std::array<std::atomic<uint64>, MEMORY_TAG_MAX_TAGS> taggedPeaks;
+  std::array<std::atomic<uint64>, MEMORY_TAG_MAX_TAGS> taggedBudgets;
+  std::array<std::atomic<bool>, MEMORY_TAG_MAX_TAGS> overBudget;
+  MemoryBudgetCallback budgetCallback;
+
+  // Only written by defragmentation passes, rare enough to share
+  std::array<std::atomic<uint64>, MEMORY_TAG_MAX_TAGS> taggedReclaimed;
+
+  // Created by the first MemoryManager::StartTracing() and kept alive until
+  // exit, since other threads may still be recording into it
+  std::atomic<flatearth::memory::AllocationTracer *> tracer;
+  std::mutex tracerMutex;
 };
 
 class MemoryManager {
@@ -72,18 +188,96 @@ public:
   FEAPI ~MemoryManager();
 
   FEAPI static void *Allocate(uint64 size, MemoryTag tag);
+  FEAPI static void *Allocate(uint64 size, uint64 alignment, MemoryTag tag,
+                              uint32 flags = ALLOCATION_FLAG_ZEROED);
   FEAPI static void Free(void *block, uint64 size, MemoryTag tag);
+  FEAPI static void Free(void *block, uint64 size, uint64 alignment,
+                         MemoryTag tag);
+  // Frees a block described by PackAllocation(), usable as a VoidDeleter
+  FEAPI static void FreePacked(void *block, uint64 packed);
+  // Resizes a block keeping its first min(size, newSize) bytes, only the
+  // added bytes are initialized with the flags. Blocks outside the engine
+  // heap are resized in place by the platform when possible, others are
+  // copied. Returns nullptr and leaves the block untouched on failure
+  FEAPI static void *Reallocate(void *block, uint64 size, uint64 newSize,
+                                uint64 alignment, MemoryTag tag,
+                                uint32 flags = ALLOCATION_FLAG_ZEROED);
   FEAPI static void *ZeroMemory(void *block, uint64 size);
   FEAPI static void *CopyMemory(void *dest, const void *source, uint64 size);
   FEAPI static void *SetMemory(void *dest, sint32 value, uint64 size);
+
+  // Applies the given AllocationFlags to an existing block, used by
+  // allocators when recycling memory
+  FEAPI static void InitializeMemory(void *block, uint64 size, uint32 flags);
+
+  // Keeps the tagged stats in sync for memory that does not come from
+  // Allocate(), e.g. pages committed from a virtual memory reservation
+  FEAPI static void TrackAllocation(uint64 size, MemoryTag tag);
+  FEAPI static void TrackFree(uint64 size, MemoryTag tag);
+  // Reports bytes of dead blocks a compacting allocator got back
+  FEAPI static void TrackReclaimed(uint64 size, MemoryTag tag);
+
+  // Huge page backed blocks for big arenas, bypassing the heap. Only the
+  // ALLOCATION_FLAG_POISONED flag matters since fresh pages are zeroed
+  FEAPI static void *AllocateLargePages(uint64 size, MemoryTag tag,
+                                        uint32 flags,
+                                        platform::LargePageKind *kind);
+  FEAPI static void FreeLargePages(void *block, uint64 size, MemoryTag tag,
+                                   platform::LargePageKind kind);
+  // Accounts for large pages obtained outside of AllocateLargePages()
+  FEAPI static void TrackLargePages(uint64 size, platform::LargePageKind kind,
+                                    bool allocated);
   FEAPI string PrintMemoryUsage() const;
+  // Machine readable report with per-tag usage, peaks, budgets and counts
+  FEAPI static string DumpMemoryUsage(MemoryReportFormat format);
+  FEAPI static bool WriteMemoryUsage(const string &path,
+                                     MemoryReportFormat format);
+
+  // Sums every statistic shard, safe to call from any thread
+  FEAPI static MemoryBlock GetStats();
+
+  // Budgets in bytes, 0 disables the budget of a tag. When no callback is
+  // set, exceeding a budget logs a warning
+  FEAPI static void SetBudget(MemoryTag tag, uint64 budget);
+  FEAPI static uint64 GetBudget(MemoryTag tag);
+  FEAPI static void SetBudgetCallback(MemoryBudgetCallback callback);
+
+  // Samples the merged statistics: updates the per-tag peaks and reports
+  // tags over budget. The application calls it once per frame, spikes that
+  // start and end within a frame are not seen.
+  FEAPI static void Update();
+
+  // Opt-in tracing of every Allocate() and Free() into a binary file, see
+  // Memory/AllocationTracer.hpp for the format. Callsites are the return
+  // addresses of the MemoryManager callers
+  FEAPI static bool StartTracing(const string &path,
+                                 bool captureCallsites = FeTrue);
+  FEAPI static void StopTracing();
+  FEAPI static bool IsTracing();
 
 private:
   MemoryManager();
   static void CheckTag(MemoryTag tag, const string &from);
+  static void *AllocateBlock(uint64 size, uint64 alignment, MemoryTag tag,
+                             uint32 flags, const void *callsite);
+  static void FreeBlock(void *block, uint64 size, uint64 alignment,
+                        MemoryTag tag, const void *callsite);
+  static MemoryStatShard &LocalStatShard();
+  static void RecordAllocation(uint64 size, MemoryTag tag,
+                               const void *block = nullptr,
+                               const void *callsite = nullptr);
+  static void RecordFree(uint64 size, MemoryTag tag,
+                         const void *block = nullptr,
+                         const void *callsite = nullptr);
+  static void CreateState();
+  static bool InitializeHeap(uint64 heapSize);
+  static bool InHeap(const void *block);
 
   static MemorySystemState *_memoryState;
   static bool _initialized;
+  // Heap bounds outlive the state so late frees can still be recognized
+  static const uchar *_heapStart;
+  static const uchar *_heapEnd;
 };
 
 // Stateless custom deleter structure to manage memory inside std::unique_ptr
@@ -92,31 +286,36 @@ template <typename T, uint64 Size, MemoryTag Tag>
 struct StatelessCustomDeleter {
   void operator()(T *ptr) const {
     if (ptr) {
-      MemoryManager::Free(ptr, Size * sizeof(T), Tag);
+      MemoryManager::Free(ptr, Size * sizeof(T), alignof(T), Tag);
     }
   };
 };
 
-template <typename T>
-class StatefulCustomDeleter {
+// Frees through the MemoryManager without running any destructor. Size, tag
+// and alignment are packed in one word, so an owning std::unique_ptr using it
+// is two words wide
+template <typename T> class StatefulCustomDeleter {
 public:
   StatefulCustomDeleter() = default;
 
-  StatefulCustomDeleter(uint64 allocatedSize, MemoryTag tag)
-      : _allocatedSize(allocatedSize), _tag(tag) {}
+  StatefulCustomDeleter(uint64 allocatedSize, MemoryTag tag,
+                        uint64 alignment = MEMORY_DEFAULT_ALIGNMENT)
+      : _packed(PackAllocation(allocatedSize, tag, alignment)) {}
 
-  void operator()(void* ptr) const {
+  void operator()(void *ptr) const {
     if (ptr) {
-      core::memory::MemoryManager::Free(ptr, _allocatedSize, _tag);
+      MemoryManager::Free(ptr, PackedSize(_packed), PackedAlignment(_packed),
+                          PackedTag(_packed));
     }
   }
 
 private:
-  uint64 _allocatedSize = 0;
-  MemoryTag _tag = MEMORY_TAG_UNKNOWN;
+  uint64 _packed = PackAllocation(0, MEMORY_TAG_UNKNOWN);
 };
 
-
+STATIC_ASSERT(sizeof(std::unique_ptr<void, StatefulCustomDeleter<void>>) ==
+                  2 * sizeof(void *),
+              "Expected owning pointers to be two words wide");
 
 template <typename T>
 using unique_renderer_ptr =
@@ -126,18 +325,29 @@ template <typename T>
 using unique_stateful_renderer_ptr =
     std::unique_ptr<T, core::memory::StatefulCustomDeleter<T>>;
 
-inline auto make_unique_void(void* ptr, uint64 size, MemoryTag tag, bool ownsMemory) -> unique_void_ptr {
-  if (ownsMemory) {
-    return unique_void_ptr(ptr, [=](void const* data) {
-      if (data) {
-        core::memory::MemoryManager::Free(const_cast<void*>(data), size, tag);
-      }
-    });
-  } else {
-    return unique_void_ptr(ptr, [](void const*) {
-      // do nothing, not owner
-    });
+template <typename T> auto make_unique_void(T *ptr) -> unique_void_ptr {
+  return unique_void_ptr(
+      ptr, VoidDeleter{[](void *data, uint64) { delete static_cast<T *>(data); },
+                       0});
+}
+
+template <typename T> T *get_unique_void_ptr(const unique_void_ptr &ptr) {
+  if (!ptr) {
+    FFATAL("get_unique_void_ptr<T>(): ptr is null");
+    return nullptr;
+  }
+  return reinterpret_cast<T *>(ptr.get());
+}
+
+inline auto make_unique_void(void *ptr, uint64 size, MemoryTag tag,
+                             bool ownsMemory) -> unique_void_ptr {
+  // Not owning, nothing to do on release
+  if (!ownsMemory) {
+    return unique_void_ptr(ptr, VoidDeleter{});
   }
+
+  return unique_void_ptr(
+      ptr, VoidDeleter{MemoryManager::FreePacked, PackAllocation(size, tag)});
 }
 
 } // namespace memory
@@ -1,26 +1,75 @@
 #include "FeString.hpp"
 
-#include <Containers/DArray.hpp>
+#include <cstdio>
+#include <cstring>
 
 namespace flatearth {
 namespace core {
 
+// Most strings fit here, the rest are formatted again straight into the
+// result
+constexpr uint64 SPRINTF_STACK_BUFFER_SIZE = 256;
+
 string Sprintf(string arg, ...) {
   va_list args1;
   va_start(args1, arg);
 
   va_list args2;
   va_copy(args2, args1);
-  uint32 size = std::vsnprintf(nullptr, 0, arg.c_str(), args2);
+  char stackBuffer[SPRINTF_STACK_BUFFER_SIZE];
+  sint32 size =
+      std::vsnprintf(stackBuffer, sizeof(stackBuffer), arg.c_str(), args1);
+  va_end(args1);
+
+  if (size < 0) {
+    va_end(args2);
+    FERROR("Sprintf(): invalid format '%s'", arg.c_str());
+    return string();
+  }
+
+  if ((uint64)size < sizeof(stackBuffer)) {
+    va_end(args2);
+    return string(stackBuffer, size);
+  }
+
+  // Writing the terminator over result[size] is allowed
+  string result(size, '\0');
+  std::vsnprintf(result.data(), size + 1, arg.c_str(), args2);
   va_end(args2);
 
-  containers::DArray<char> buffer;
-  buffer.Reserve(size + 1);
-  std::vsnprintf(buffer.Data(), buffer.GetLength(), arg.c_str(), args1);
-  va_end(args1);
+  return result;
+}
+
+bool AppendTo(char *buffer, uint64 capacity, uint64 &length, vstring str) {
+  uint64 room = capacity - 1 - length;
+  uint64 copied = str.size() < room ? str.size() : room;
+  std::memcpy(buffer + length, str.data(), copied);
+  length += copied;
+  buffer[length] = '\0';
+  return copied == str.size();
+}
 
-  return string(buffer.Data(), size);
+StringBuilder::StringBuilder(char *buffer, uint64 capacity)
+    : _buffer(buffer), _capacity(capacity), _length(0), _truncated(FeFalse) {
+  if (!buffer || capacity == 0) {
+    FERROR("StringBuilder::StringBuilder(): needs a buffer with room for at "
+           "least the null terminator");
+    throw std::invalid_argument("Invalid StringBuilder buffer");
+  }
+
+  _buffer[0] = '\0';
 }
 
+StringBuilder &StringBuilder::Append(vstring str) {
+  _truncated |= !AppendTo(_buffer, _capacity, _length, str);
+  return *this;
 }
+
+void StringBuilder::Clear() {
+  _length = 0;
+  _truncated = FeFalse;
+  _buffer[0] = '\0';
 }
+
+} // namespace core
+} // namespace flatearth
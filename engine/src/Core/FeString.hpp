@@ -1,15 +1,118 @@
 #ifndef _FLATEARTH_FE_STRING_HPP
 #define _FLATEARTH_FE_STRING_HPP
 
+#include "Core/Logger.hpp"
 #include "Definitions.hpp"
 #include <cstdarg>
+#include <format>
+#include <stdexcept>
+#include <utility>
 
 namespace flatearth {
 namespace core {
 
 string Sprintf(string arg, ...);
 
+// Appends str after the length characters already in buffer, cutting it to
+// fit capacity - 1 characters and keeping the buffer null terminated.
+// FeFalse when something was cut
+bool AppendTo(char *buffer, uint64 capacity, uint64 &length, vstring str);
+
+// AppendTo() for std::format output, the format string is checked at compile
+// time and nothing is allocated
+template <typename... Args>
+bool FormatTo(char *buffer, uint64 capacity, uint64 &length,
+              std::format_string<Args...> format, Args &&...args) {
+  uint64 room = capacity - 1 - length;
+  std::format_to_n_result<char *> result =
+      std::format_to_n(buffer + length, (sint64)room, format,
+                       std::forward<Args>(args)...);
+  length += result.out - (buffer + length);
+  buffer[length] = '\0';
+  return (uint64)result.size <= room;
 }
+
+// Builds text in memory it does not own: a caller provided buffer or a block
+// taken from an arena, e.g. the FrameAllocator for text rebuilt every frame.
+// Output that does not fit is cut, IsTruncated() tells when that happened.
+class StringBuilder {
+public:
+  // capacity counts the null terminator
+  StringBuilder(char *buffer, uint64 capacity);
+  // The text stays in the arena until it is reset
+  template <typename Arena> StringBuilder(Arena *arena, uint64 capacity);
+
+  StringBuilder &Append(vstring str);
+  template <typename... Args>
+  StringBuilder &Format(std::format_string<Args...> format, Args &&...args);
+  void Clear();
+
+  const char *CStr() const { return _buffer; }
+  vstring View() const { return vstring(_buffer, _length); }
+  uint64 GetLength() const { return _length; }
+  uint64 GetCapacity() const { return _capacity - 1; }
+  bool IsTruncated() const { return _truncated; }
+
+private:
+  char *_buffer;
+  uint64 _capacity;
+  uint64 _length;
+  bool _truncated;
+};
+
+// Inline string of up to N - 1 characters, it never allocates. Output that
+// does not fit is cut, IsTruncated() tells when that happened.
+template <uint64 N> class FixedString {
+public:
+  STATIC_ASSERT(N > 1, "FixedString needs room for a null terminator");
+
+  FixedString() : _length(0), _truncated(FeFalse) { _buffer[0] = '\0'; }
+  explicit FixedString(vstring str) : FixedString() { Append(str); }
+
+  FixedString &Append(vstring str) {
+    _truncated |= !AppendTo(_buffer, N, _length, str);
+    return *this;
+  }
+
+  template <typename... Args>
+  FixedString &Format(std::format_string<Args...> format, Args &&...args) {
+    _truncated |= !FormatTo(_buffer, N, _length, format,
+                            std::forward<Args>(args)...);
+    return *this;
+  }
+
+  void Clear() {
+    _length = 0;
+    _truncated = FeFalse;
+    _buffer[0] = '\0';
+  }
+
+  const char *CStr() const { return _buffer; }
+  vstring View() const { return vstring(_buffer, _length); }
+  uint64 GetLength() const { return _length; }
+  constexpr uint64 GetCapacity() const { return N - 1; }
+  bool IsTruncated() const { return _truncated; }
+
+private:
+  char _buffer[N];
+  uint64 _length;
+  bool _truncated;
+};
+
+template <typename Arena>
+StringBuilder::StringBuilder(Arena *arena, uint64 capacity)
+    : StringBuilder(static_cast<char *>(arena->Allocate(capacity, 1)),
+                    capacity) {}
+
+template <typename... Args>
+StringBuilder &StringBuilder::Format(std::format_string<Args...> format,
+                                     Args &&...args) {
+  _truncated |= !FormatTo(_buffer, _capacity, _length, format,
+                          std::forward<Args>(args)...);
+  return *this;
 }
 
+} // namespace core
+} // namespace flatearth
+
 #endif // _FLATEARTH_FE_STRING_HPP
@@ -41,10 +41,10 @@ void InputManager::ProcessKey(Keys key, bool pressed) {
   }
 
   // Only handle this if the states actually changed
-  if (_state.keyboardCurrent.keys[key] == pressed)
+  if (_state.keyboardCurrent.keys.Test(key) == pressed)
     return;
 
-  _state.keyboardCurrent.keys[key] = pressed;
+  _state.keyboardCurrent.keys.Set(key, pressed);
   events::EventContext context;
   context.set(std::array<ushort, 8>{});
   context.set<std::array<ushort, 8>>(0, static_cast<ushort>(key));
@@ -61,10 +61,10 @@ void InputManager::ProcessButton(Buttons button, bool pressed) {
     return;
   }
 
-  if (_state.mouseCurrent.buttons[button] == pressed)
+  if (_state.mouseCurrent.buttons.Test(button) == pressed)
     return;
 
-  _state.mouseCurrent.buttons[button] = pressed;
+  _state.mouseCurrent.buttons.Set(button, pressed);
   events::EventContext context;
   context.set(std::array<ushort, 8>{});
   context.set<std::array<ushort, 8>>(0, static_cast<ushort>(button));
@@ -118,56 +118,56 @@ bool InputManager::IsKeyDown(Keys key) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.keyboardCurrent.keys[key] == FeTrue;
+  return _state.keyboardCurrent.keys.Test(key);
 }
 
 bool InputManager::IsKeyUp(Keys key) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.keyboardCurrent.keys[key] == FeFalse;
+  return !_state.keyboardCurrent.keys.Test(key);
 }
 
 bool InputManager::WasKeyDown(Keys key) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.keyboardPrevious.keys[key] == FeTrue;
+  return _state.keyboardPrevious.keys.Test(key);
 }
 
 bool InputManager::WasKeyUp(Keys key) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.keyboardPrevious.keys[key] == FeFalse;
+  return !_state.keyboardPrevious.keys.Test(key);
 }
 
 bool InputManager::IsButtonDown(Buttons button) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.mouseCurrent.buttons[button] == FeTrue;
+  return _state.mouseCurrent.buttons.Test(button);
 }
 
 bool InputManager::IsButtonUp(Buttons button) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.mouseCurrent.buttons[button] == FeFalse;
+  return !_state.mouseCurrent.buttons.Test(button);
 }
 
 bool InputManager::WasButtonDown(Buttons button) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.mousePrevious.buttons[button] == FeTrue;
+  return _state.mousePrevious.buttons.Test(button);
 }
 
 bool InputManager::WasButtonUp(Buttons button) {
   if (!_isInitialized)
     return FeFalse;
 
-  return _state.mousePrevious.buttons[button] == FeFalse;
+  return !_state.mousePrevious.buttons.Test(button);
 }
 
 InputState &InputManager::GetState() { return _state; }
@@ -1,6 +1,7 @@
 #ifndef _FLATEARTH_ENGINE_INPUT_HPP
 #define _FLATEARTH_ENGINE_INPUT_HPP
 
+#include "Containers/BitSet.hpp"
 #include "Core/Event.hpp"
 #include "Definitions.hpp"
 
@@ -141,14 +142,16 @@ enum Keys : ushort {
   KEYS_MAX_KEYS
 };
 
+// One bit per key and button, so a whole state is a few words to copy and
+// scan
 struct KeyboardState {
-  std::array<bool, 256> keys;
+  containers::SBitSet<256> keys;
 };
 
 struct MouseState {
   sshort x;
   sshort y;
-  std::array<uchar, BUTTON_MAX_BUTTONS> buttons;
+  containers::SBitSet<BUTTON_MAX_BUTTONS> buttons;
 };
 
 struct InputState {
@@ -3,6 +3,7 @@
 #include "Core/FeMemory.hpp"
 #include "Platform/Platform.hpp"
 
+#include <algorithm>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
@@ -56,20 +57,29 @@ bool Logger::Init(uint64 *memoryRequirement, void *state) {
 }
 
 FEAPI void LogOutput(LogLevel level, const char *message, ...) {
-  const string levelStrings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ",
-                                  "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
+  static constexpr vstring levelStrings[6] = {
+      "[FATAL]: ", "[ERROR]: ", "[WARN]:  ",
+      "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
 
   bool isError = (level < LOG_LEVEL_WARN);
 
-  char out_message[LOGGER_BUFFER_SIZE];
-  memset(out_message, 0, sizeof(out_message));
+  // The whole line is built on the stack instead of in temporary strings
+  char outMessage[LOGGER_BUFFER_SIZE];
+  uint64 prefix = levelStrings[level].size();
+  std::memcpy(outMessage, levelStrings[level].data(), prefix);
 
   std::va_list argPtr;
   va_start(argPtr, message);
-  std::vsnprintf(out_message, sizeof(out_message), message, argPtr);
+  sint32 written = std::vsnprintf(outMessage + prefix,
+                                  sizeof(outMessage) - prefix, message, argPtr);
   va_end(argPtr);
 
-  string sOut = string(levelStrings[level]) + string(out_message);
+  uint64 length = prefix;
+  if (written > 0) {
+    length += std::min<uint64>(written, sizeof(outMessage) - prefix - 1);
+  }
+
+  vstring sOut(outMessage, length);
   if (isError) {
     platform::Platform::ConsoleError(sOut, level);
   } else {
@@ -0,0 +1,58 @@
+#include "StringId.hpp"
+
+#include "Containers/HashMap.hpp"
+#include "Core/FeMemory.hpp"
+#include "Logger.hpp"
+
+#include <mutex>
+
+namespace flatearth {
+namespace core {
+
+#if STRING_ID_REVERSE_LOOKUP
+using StringIdTable = containers::HashMap<
+    uint64, string, containers::HashMapHash<uint64>, std::equal_to<>,
+    containers::TaggedAllocator<memory::MEMORY_TAG_STRING>>;
+
+// Built on first use, after the memory manager, so it is also torn down
+// before it
+static StringIdTable &InternTable() {
+  static StringIdTable table;
+  return table;
+}
+
+static std::mutex internMutex;
+#endif
+
+StringId StringId::Intern(vstring str) {
+  StringId id(str);
+
+#if STRING_ID_REVERSE_LOOKUP
+  std::lock_guard<std::mutex> lock(internMutex);
+  StringIdTable &table = InternTable();
+  const string *known = table.Find(id._hash);
+  if (!known) {
+    table.Insert(id._hash, string(str));
+  } else if (*known != str) {
+    FERROR("StringId::Intern(): '%s' and '%.*s' hash to the same id",
+           known->c_str(), (sint32)str.size(), str.data());
+  }
+#endif
+
+  return id;
+}
+
+string StringId::GetString() const {
+#if STRING_ID_REVERSE_LOOKUP
+  std::lock_guard<std::mutex> lock(internMutex);
+  const string *known = InternTable().Find(_hash);
+  if (known) {
+    return *known;
+  }
+#endif
+
+  return string();
+}
+
+} // namespace core
+} // namespace flatearth
@@ -0,0 +1,75 @@
+#ifndef _FLATEARTH_ENGINE_STRING_ID_HPP
+#define _FLATEARTH_ENGINE_STRING_ID_HPP
+
+#include "Definitions.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+
+// Keep the strings behind runtime ids so they can be looked up again,
+// disabled for releases
+#define STRING_ID_REVERSE_LOOKUP 1
+
+#if FERELEASE == 1
+#undef STRING_ID_REVERSE_LOOKUP
+#define STRING_ID_REVERSE_LOOKUP 0
+#endif
+
+namespace flatearth {
+namespace core {
+
+constexpr uint64 STRING_ID_FNV_OFFSET = 0xCBF29CE484222325ull;
+constexpr uint64 STRING_ID_FNV_PRIME = 0x100000001B3ull;
+
+// 64 bit FNV-1a, usable at compile time
+constexpr uint64 HashString(vstring str) {
+  uint64 hash = STRING_ID_FNV_OFFSET;
+  for (char c : str) {
+    hash ^= static_cast<uchar>(c);
+    hash *= STRING_ID_FNV_PRIME;
+  }
+  return hash;
+}
+
+// Name reduced to its 64 bit hash, compared, ordered and hashed as an
+// integer. Literals are hashed at compile time with "name"_sid, runtime
+// strings go through Intern(), which also remembers the string behind the
+// id (when STRING_ID_REVERSE_LOOKUP is on) so GetString() can give it back.
+// A default constructed id names nothing and is not valid.
+class StringId {
+public:
+  constexpr StringId() : _hash(0) {}
+  constexpr explicit StringId(vstring str) : _hash(HashString(str)) {}
+
+  // Thread safe, reports two strings hashing to the same id
+  FEAPI static StringId Intern(vstring str);
+
+  constexpr uint64 GetHash() const { return _hash; }
+  constexpr bool IsValid() const { return _hash != 0; }
+
+  // The interned string, empty for ids Intern() never saw or when reverse
+  // lookup is disabled. Meant for logs and tools, not hot paths
+  FEAPI string GetString() const;
+
+  constexpr bool operator==(const StringId &other) const = default;
+  constexpr auto operator<=>(const StringId &other) const = default;
+
+private:
+  uint64 _hash;
+};
+
+consteval StringId operator""_sid(const char *str, std::size_t length) {
+  return StringId(vstring(str, length));
+}
+
+} // namespace core
+} // namespace flatearth
+
+template <> struct std::hash<flatearth::core::StringId> {
+  std::size_t operator()(const flatearth::core::StringId &id) const noexcept {
+    return id.GetHash();
+  }
+};
+
+#endif // _FLATEARTH_ENGINE_STRING_ID_HPP
@@ -6,8 +6,6 @@
 #include <sstream>
 #include <string>
 
-using unique_void_ptr = std::unique_ptr<void, std::function<void(void const*)>>;
-
 namespace flatearth {
 namespace core {
 namespace memory {} // namespace memory
@@ -59,6 +57,24 @@ STATIC_ASSERT(sizeof(sint64) == 8, "Expected sint64 to be 8 bytes");
 STATIC_ASSERT(sizeof(float32) == 4, "Expected float32 to be 4 bytes");
 STATIC_ASSERT(sizeof(float64) == 8, "Expected float64 to be 8 bytes");
 
+// Deleter of type erased owning pointers: a plain function pointer plus one
+// word of context for it, e.g. a block packed with
+// core::memory::PackAllocation(). Never allocates, unlike std::function
+struct VoidDeleter {
+  using DeleteFunction = void (*)(void *ptr, uint64 context);
+
+  DeleteFunction function = nullptr;
+  uint64 context = 0;
+
+  void operator()(void *ptr) const {
+    if (ptr && function) {
+      function(ptr, context);
+    }
+  }
+};
+
+using unique_void_ptr = std::unique_ptr<void, VoidDeleter>;
+
 #define FeTrue true
 #define FeFalse false
 
@@ -22,6 +22,11 @@ FINLINE bool IsPowerOf2(uint64 val) {
   return (val != 0) && ((val & (val - 1)) == 0);
 }
 
+// Rounds value up to the next multiple of alignment, a power of 2
+FINLINE uint64 AlignUp(uint64 value, uint64 alignment) {
+  return (value + (alignment - 1)) & ~(alignment - 1);
+}
+
 FEAPI sint32 GetRandomInt();
 FEAPI sint32 GetRandomInt(sint32 min, sint32 max);
 
@@ -0,0 +1,282 @@
+#include "AllocationTracer.hpp"
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+#include "Platform/Platform.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace flatearth {
+namespace memory {
+
+// Single producer, single consumer ring. The owning thread only moves head,
+// the flush thread only moves tail. Owned by both the tracer and the thread
+// that fills it, whoever lets go last frees it.
+struct AllocationTraceRing {
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE) std::atomic<uint64> head;
+  alignas(core::memory::MEMORY_CACHE_LINE_SIZE) std::atomic<uint64> tail;
+  std::atomic<uint32> references;
+  uint32 threadId;
+  uint64 mask;
+  AllocationTraceEvent *events;
+};
+
+FINLINE void ReleaseRing(AllocationTraceRing *ring) {
+  if (ring->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  ring->~AllocationTraceRing();
+  platform::Platform::PFreeMemory(ring, alignof(AllocationTraceRing));
+}
+
+// Ring of the calling thread, tied to the tracer that created it
+struct ThreadTraceRing {
+  uint64 tracerId = 0;
+  AllocationTraceRing *ring = nullptr;
+
+  ~ThreadTraceRing() {
+    if (ring) {
+      ReleaseRing(ring);
+    }
+  }
+};
+
+static std::atomic<uint64> nextTracerId = 1;
+thread_local ThreadTraceRing threadRing;
+
+AllocationTracer::AllocationTracer(uint64 ringSize, uint64 flushIntervalMs)
+    : _ringSize(ringSize), _flushInterval(flushIntervalMs), _running(FeFalse),
+      _captureCallsites(FeFalse), _nextThreadId(0), _stopRequested(FeFalse),
+      _written(0), _dropped(0),
+      _id(nextTracerId.fetch_add(1, std::memory_order_relaxed)) {
+  if (!math::IsPowerOf2(ringSize)) {
+    FERROR("AllocationTracer::AllocationTracer(): ring size must be a power "
+           "of 2 (got %llu)",
+           ringSize);
+    throw std::invalid_argument("Invalid allocation tracer ring size");
+  }
+}
+
+AllocationTracer::~AllocationTracer() {
+  Stop();
+
+  std::lock_guard<std::mutex> lock(_ringsMutex);
+  for (AllocationTraceRing *ring : _rings) {
+    ReleaseRing(ring);
+  }
+  _rings.clear();
+}
+
+bool AllocationTracer::Start(const string &path, const vstring *tagNames,
+                             uint32 tagCount, bool captureCallsites) {
+  if (_running.load(std::memory_order_relaxed)) {
+    FWARN("AllocationTracer::Start(): already tracing");
+    return FeFalse;
+  }
+
+  _file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!_file) {
+    FERROR("AllocationTracer::Start(): could not open '%s'", path.c_str());
+    return FeFalse;
+  }
+
+  AllocationTraceHeader header = {};
+  std::memcpy(header.magic, ALLOCATION_TRACE_MAGIC, sizeof(header.magic));
+  header.version = ALLOCATION_TRACE_VERSION;
+  header.eventSize = sizeof(AllocationTraceEvent);
+  header.tagCount = tagCount;
+  header.tagNameSize = ALLOCATION_TRACE_TAG_NAME_SIZE;
+  _file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  for (uint32 i = 0; i < tagCount; i++) {
+    char name[ALLOCATION_TRACE_TAG_NAME_SIZE] = {};
+    std::memcpy(name, tagNames[i].data(),
+                std::min<uint64>(tagNames[i].size(), sizeof(name) - 1));
+    _file.write(name, sizeof(name));
+  }
+
+  // Events left over from a previous session are skipped
+  {
+    std::lock_guard<std::mutex> lock(_ringsMutex);
+    for (AllocationTraceRing *ring : _rings) {
+      ring->tail.store(ring->head.load(std::memory_order_acquire),
+                       std::memory_order_release);
+    }
+  }
+
+  _captureCallsites = captureCallsites;
+  _startTime = std::chrono::steady_clock::now();
+  _written.store(0, std::memory_order_relaxed);
+  _dropped.store(0, std::memory_order_relaxed);
+  _stopRequested = FeFalse;
+  _running.store(FeTrue, std::memory_order_release);
+
+  _flushThread = std::thread(&AllocationTracer::FlushLoop, this);
+  return FeTrue;
+}
+
+void AllocationTracer::Stop() {
+  if (!_running.exchange(FeFalse, std::memory_order_acq_rel)) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_flushMutex);
+    _stopRequested = FeTrue;
+  }
+  _flushSignal.notify_one();
+  _flushThread.join();
+
+  uint64 dropped = _dropped.load(std::memory_order_relaxed);
+  if (dropped > 0) {
+    FWARN("AllocationTracer::Stop(): %llu events dropped, consider a larger "
+          "ring or a shorter flush interval",
+          dropped);
+  }
+
+  _file.close();
+}
+
+void AllocationTracer::Record(AllocationTraceEventType type,
+                              const void *address, uint64 size, uchar tag,
+                              const void *callsite) {
+  if (!_running.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  AllocationTraceRing *ring = LocalRing();
+  if (!ring) {
+    return;
+  }
+
+  uint64 head = ring->head.load(std::memory_order_relaxed);
+  if (head - ring->tail.load(std::memory_order_acquire) > ring->mask) {
+    _dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  AllocationTraceEvent &event = ring->events[head & ring->mask];
+  event.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - _startTime)
+                        .count();
+  event.address = reinterpret_cast<uint64>(address);
+  event.size = size;
+  event.callsite = _captureCallsites ? reinterpret_cast<uint64>(callsite) : 0;
+  event.threadId = ring->threadId;
+  event.tag = tag;
+  event.type = type;
+  event.padding[0] = 0;
+  event.padding[1] = 0;
+
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+bool AllocationTracer::IsRunning() const {
+  return _running.load(std::memory_order_relaxed);
+}
+
+uint64 AllocationTracer::GetWrittenCount() const {
+  return _written.load(std::memory_order_relaxed);
+}
+
+uint64 AllocationTracer::GetDroppedCount() const {
+  return _dropped.load(std::memory_order_relaxed);
+}
+
+// Private members
+
+AllocationTraceRing *AllocationTracer::LocalRing() {
+  if (threadRing.tracerId == _id) {
+    return threadRing.ring;
+  }
+
+  // The thread moved on to another tracer, let go of the old ring
+  if (threadRing.ring) {
+    ReleaseRing(threadRing.ring);
+  }
+
+  threadRing.tracerId = _id;
+  threadRing.ring = CreateRing();
+  return threadRing.ring;
+}
+
+AllocationTraceRing *AllocationTracer::CreateRing() {
+  uint64 headerSize = sizeof(AllocationTraceRing);
+  void *memory = platform::Platform::PAllocateMemory(
+      headerSize + _ringSize * sizeof(AllocationTraceEvent),
+      alignof(AllocationTraceRing));
+  if (!memory) {
+    FERROR("AllocationTracer::CreateRing(): failed to allocate a ring of %llu "
+           "events",
+           _ringSize);
+    return nullptr;
+  }
+
+  AllocationTraceRing *ring = new (memory) AllocationTraceRing();
+  ring->head.store(0, std::memory_order_relaxed);
+  ring->tail.store(0, std::memory_order_relaxed);
+  // One reference for the thread, one for the tracer
+  ring->references.store(2, std::memory_order_relaxed);
+  ring->threadId = _nextThreadId.fetch_add(1, std::memory_order_relaxed);
+  ring->mask = _ringSize - 1;
+  ring->events = reinterpret_cast<AllocationTraceEvent *>(
+      reinterpret_cast<uchar *>(memory) + headerSize);
+
+  std::lock_guard<std::mutex> lock(_ringsMutex);
+  _rings.push_back(ring);
+  return ring;
+}
+
+void AllocationTracer::FlushLoop() {
+  std::unique_lock<std::mutex> lock(_flushMutex);
+  while (!_stopRequested) {
+    _flushSignal.wait_for(lock, _flushInterval);
+    lock.unlock();
+    Drain();
+    lock.lock();
+  }
+
+  // Catch whatever was recorded while the last drain was running
+  lock.unlock();
+  Drain();
+  _file.flush();
+}
+
+void AllocationTracer::Drain() {
+  std::lock_guard<std::mutex> lock(_ringsMutex);
+  for (uint64 i = 0; i < _rings.size();) {
+    AllocationTraceRing *ring = _rings[i];
+
+    // Read before draining, a ring whose thread exited is complete
+    bool orphaned = ring->references.load(std::memory_order_acquire) == 1;
+
+    uint64 tail = ring->tail.load(std::memory_order_relaxed);
+    uint64 head = ring->head.load(std::memory_order_acquire);
+    _written.fetch_add(head - tail, std::memory_order_relaxed);
+    while (tail != head) {
+      uint64 start = tail & ring->mask;
+      uint64 count = std::min(head - tail, ring->mask + 1 - start);
+      _file.write(reinterpret_cast<const char *>(ring->events + start),
+                  count * sizeof(AllocationTraceEvent));
+      tail += count;
+    }
+
+    ring->tail.store(tail, std::memory_order_release);
+
+    if (orphaned) {
+      ReleaseRing(ring);
+      _rings[i] = _rings.back();
+      _rings.pop_back();
+      continue;
+    }
+
+    i++;
+  }
+}
+
+} // namespace memory
+} // namespace flatearth
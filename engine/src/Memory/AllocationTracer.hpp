@@ -0,0 +1,133 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_ALLOCATION_TRACER_HPP
+#define _FLATEARTH_ENGINE_MEMORY_ALLOCATION_TRACER_HPP
+
+#include "Definitions.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Address the current function returns to, used as the allocation site
+#ifdef _MSC_VER
+#include <intrin.h>
+#define FE_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define FE_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+namespace flatearth {
+namespace memory {
+
+struct AllocationTraceRing;
+
+// Trace file layout: an AllocationTraceHeader, tagCount tag names of
+// ALLOCATION_TRACE_TAG_NAME_SIZE bytes each, then AllocationTraceEvent
+// records until the end of the file. Records are grouped per thread in
+// flush batches, so timestamps are only ordered within a thread.
+constexpr char ALLOCATION_TRACE_MAGIC[8] = {'F', 'E', 'T', 'R',
+                                            'A', 'C', 'E', '\0'};
+constexpr uint32 ALLOCATION_TRACE_VERSION = 1;
+constexpr uint32 ALLOCATION_TRACE_TAG_NAME_SIZE = 32;
+
+enum AllocationTraceEventType : uchar {
+  ALLOCATION_TRACE_ALLOCATE,
+  ALLOCATION_TRACE_FREE,
+};
+
+struct AllocationTraceHeader {
+  char magic[8];
+  uint32 version;
+  uint32 eventSize;
+  uint32 tagCount;
+  uint32 tagNameSize;
+};
+
+struct AllocationTraceEvent {
+  // Nanoseconds since the trace started
+  uint64 timestamp;
+  uint64 address;
+  uint64 size;
+  // Return address of the MemoryManager caller, 0 when not captured
+  uint64 callsite;
+  uint32 threadId;
+  uchar tag;
+  uchar type;
+  uchar padding[2];
+};
+
+STATIC_ASSERT(sizeof(AllocationTraceHeader) == 24,
+              "Expected AllocationTraceHeader to be 24 bytes");
+STATIC_ASSERT(sizeof(AllocationTraceEvent) == 40,
+              "Expected AllocationTraceEvent to be 40 bytes");
+
+// Default number of events each thread can buffer between two flushes
+constexpr uint64 ALLOCATION_TRACE_DEFAULT_RING_SIZE = 16 * 1024;
+constexpr uint64 ALLOCATION_TRACE_DEFAULT_FLUSH_MS = 50;
+
+// Records allocation events into one single producer ring per thread, so
+// recording never takes a lock. A background thread drains the rings into
+// the trace file. Events are dropped, not waited for, when a ring is full;
+// GetDroppedCount() tells how many. Rings are bootstrapped from the platform
+// so tracing never shows up in its own trace.
+class AllocationTracer {
+public:
+  FEAPI AllocationTracer(uint64 ringSize = ALLOCATION_TRACE_DEFAULT_RING_SIZE,
+                         uint64 flushIntervalMs =
+                             ALLOCATION_TRACE_DEFAULT_FLUSH_MS);
+  FEAPI ~AllocationTracer();
+
+  AllocationTracer(const AllocationTracer &) = delete;
+  AllocationTracer &operator=(const AllocationTracer &) = delete;
+
+  // tagNames must hold tagCount entries, written to the file header
+  FEAPI bool Start(const string &path, const vstring *tagNames,
+                   uint32 tagCount, bool captureCallsites);
+  // Joins the flush thread after writing every pending event
+  FEAPI void Stop();
+
+  FEAPI void Record(AllocationTraceEventType type, const void *address,
+                    uint64 size, uchar tag, const void *callsite);
+
+  FEAPI bool IsRunning() const;
+  // Both counters are reset by Start()
+  FEAPI uint64 GetWrittenCount() const;
+  FEAPI uint64 GetDroppedCount() const;
+
+private:
+  AllocationTraceRing *LocalRing();
+  AllocationTraceRing *CreateRing();
+  void FlushLoop();
+  void Drain();
+
+  uint64 _ringSize;
+  std::chrono::milliseconds _flushInterval;
+  std::atomic<bool> _running;
+  bool _captureCallsites;
+  std::chrono::steady_clock::time_point _startTime;
+
+  // Every ring ever created, rings of exited threads are freed once drained
+  std::mutex _ringsMutex;
+  std::vector<AllocationTraceRing *> _rings;
+  std::atomic<uint32> _nextThreadId;
+
+  std::ofstream _file;
+  std::thread _flushThread;
+  std::mutex _flushMutex;
+  std::condition_variable _flushSignal;
+  bool _stopRequested;
+
+  std::atomic<uint64> _written;
+  std::atomic<uint64> _dropped;
+
+  // Lets threads tell a new tracer from a destroyed one at the same address
+  uint64 _id;
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_ALLOCATION_TRACER_HPP
@@ -0,0 +1,81 @@
+#include "FrameAllocator.hpp"
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+
+#include <stdexcept>
+
+namespace flatearth {
+namespace memory {
+
+// Both arenas are carved out of a single block so they share one allocation
+FINLINE void *AllocateFrameMemory(void *memory, uint64 frameSize) {
+  if (memory) {
+    return memory;
+  }
+
+  void *block = core::memory::MemoryManager::Allocate(
+      frameSize * 2, core::memory::MEMORY_CACHE_LINE_SIZE,
+      core::memory::MEMORY_TAG_FRAME_ALLOCATOR,
+      core::memory::ALLOCATION_FLAG_POISONED);
+  // Checked before the arenas are built on top of it
+  if (!block) {
+    FERROR("FrameAllocator::FrameAllocator(): failed to allocate two %lluB "
+           "frames",
+           frameSize);
+    throw std::runtime_error("Failed to allocate frame allocator memory");
+  }
+
+  return block;
+}
+
+FrameAllocator::FrameAllocator(uint64 frameSize, void *memory)
+    : _frameSize(frameSize), _frameIndex(0),
+      _memory(AllocateFrameMemory(memory, frameSize)),
+      _ownsMemory(memory == nullptr),
+      _arenas{LinearAllocator(frameSize, _memory,
+                              core::memory::ALLOCATION_FLAG_POISONED),
+              LinearAllocator(frameSize,
+                              reinterpret_cast<uchar *>(_memory) + frameSize,
+                              core::memory::ALLOCATION_FLAG_POISONED)} {}
+
+FrameAllocator::~FrameAllocator() {
+  if (_memory && _ownsMemory) {
+    core::memory::MemoryManager::Free(_memory, _frameSize * 2,
+                                      core::memory::MEMORY_CACHE_LINE_SIZE,
+                                      core::memory::MEMORY_TAG_FRAME_ALLOCATOR);
+  }
+
+  _frameSize = 0;
+  _frameIndex = 0;
+  _ownsMemory = FeFalse;
+  _memory = nullptr;
+}
+
+void FrameAllocator::BeginFrame() {
+  _frameIndex++;
+  Current().FreaAll();
+}
+
+void *FrameAllocator::Allocate(uint64 size, uint64 alignment) {
+  return Current().Allocate(size, alignment);
+}
+
+uint64 FrameAllocator::GetFrameSize() const { return _frameSize; }
+
+uint64 FrameAllocator::GetAllocatedSize() const {
+  return Current().GetAllocatedSize();
+}
+
+uint64 FrameAllocator::GetFrameIndex() const { return _frameIndex; }
+
+// Private members
+
+LinearAllocator &FrameAllocator::Current() { return _arenas[_frameIndex & 1]; }
+
+const LinearAllocator &FrameAllocator::Current() const {
+  return _arenas[_frameIndex & 1];
+}
+
+} // namespace memory
+} // namespace flatearth
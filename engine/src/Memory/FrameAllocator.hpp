@@ -0,0 +1,47 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_FRAME_ALLOCATOR_HPP
+#define _FLATEARTH_ENGINE_MEMORY_FRAME_ALLOCATOR_HPP
+
+#include "Definitions.hpp"
+#include "Memory/LinearAllocator.hpp"
+
+namespace flatearth {
+namespace memory {
+
+// Per-frame scratch memory backed by two linear arenas. BeginFrame() flips
+// to the other arena and resets it, so anything allocated during the
+// previous frame remains valid for one more frame (e.g. while the GPU or a
+// deferred event still reads it). Nothing is ever freed individually.
+// Arenas are never cleared; debug builds poison them on reset instead so
+// stale reads stand out.
+class FrameAllocator {
+public:
+  // When memory is provided it must hold 2 * frameSize bytes
+  FEAPI FrameAllocator(uint64 frameSize, void *memory);
+  FEAPI ~FrameAllocator();
+
+  FrameAllocator(const FrameAllocator &) = delete;
+  FrameAllocator &operator=(const FrameAllocator &) = delete;
+
+  FEAPI void BeginFrame();
+  FEAPI void *Allocate(uint64 size, uint64 alignment = 8);
+
+  FEAPI uint64 GetFrameSize() const;
+  FEAPI uint64 GetAllocatedSize() const;
+  FEAPI uint64 GetFrameIndex() const;
+
+private:
+  LinearAllocator &Current();
+  const LinearAllocator &Current() const;
+
+  uint64 _frameSize;
+  uint64 _frameIndex;
+  void *_memory;
+  bool _ownsMemory;
+
+  LinearAllocator _arenas[2];
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_FRAME_ALLOCATOR_HPP
@@ -0,0 +1,383 @@
+#include "FreeListAllocator.hpp"
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+namespace flatearth {
+namespace memory {
+
+// Every block starts with this header. The free list links are only valid
+// while the block is free and otherwise overlap the start of the payload
+struct FreeListAllocator::BlockHeader {
+  // Block located right before this one in memory
+  BlockHeader *prevPhysical;
+
+  // Payload size in bytes. Sizes are multiples of ALIGN_SIZE, so the lowest
+  // bit is used as the free flag
+  uint64 sizeAndFlags;
+
+  BlockHeader *nextFree;
+  BlockHeader *prevFree;
+
+  static constexpr uint64 FREE_BIT = 1;
+
+  uint64 Size() const { return sizeAndFlags & ~FREE_BIT; }
+  void SetSize(uint64 size) { sizeAndFlags = size | (sizeAndFlags & FREE_BIT); }
+  bool IsFree() const { return sizeAndFlags & FREE_BIT; }
+  void SetFree(bool isFree) {
+    sizeAndFlags = isFree ? (sizeAndFlags | FREE_BIT) : Size();
+  }
+};
+
+// Bytes preceding the payload of every block
+static constexpr uint64 BLOCK_OVERHEAD = 2 * sizeof(void *);
+
+// Smallest payload able to hold the free list links
+static constexpr uint64 BLOCK_SIZE_MIN = 2 * sizeof(void *);
+
+FINLINE uchar *PayloadOf(const void *block) {
+  return reinterpret_cast<uchar *>(const_cast<void *>(block)) + BLOCK_OVERHEAD;
+}
+
+FINLINE uchar *HeaderOf(const void *payload) {
+  return reinterpret_cast<uchar *>(const_cast<void *>(payload)) -
+         BLOCK_OVERHEAD;
+}
+
+FreeListAllocator::FreeListAllocator(uint64 totalSize, void *memory)
+    : _totalSize(totalSize), _allocated(0), _memory(memory),
+      _ownsMemory(memory == nullptr), _flBitmap(0), _slBitmap{},
+      _freeLists{} {
+  if (totalSize < 2 * BLOCK_OVERHEAD + BLOCK_SIZE_MIN + ALIGN_SIZE ||
+      totalSize >= (1ull << FL_INDEX_MAX)) {
+    FERROR("FreeListAllocator::FreeListAllocator(): unsupported pool size "
+           "(%lluB)",
+           totalSize);
+    throw std::invalid_argument("Invalid free list allocator pool size");
+  }
+
+  if (!memory) {
+    _memory = core::memory::MemoryManager::Allocate(
+        totalSize, core::memory::MEMORY_CACHE_LINE_SIZE,
+        core::memory::MEMORY_TAG_FREELIST_ALLOCATOR);
+    if (!_memory) {
+      throw std::runtime_error("Failed to allocate free list allocator pool");
+    }
+  }
+
+  InitializePool();
+}
+
+FreeListAllocator::~FreeListAllocator() {
+  if (_memory && _ownsMemory) {
+    core::memory::MemoryManager::Free(
+        _memory, _totalSize, core::memory::MEMORY_CACHE_LINE_SIZE,
+        core::memory::MEMORY_TAG_FREELIST_ALLOCATOR);
+  }
+
+  _totalSize = 0;
+  _allocated = 0;
+  _ownsMemory = FeFalse;
+  _memory = nullptr;
+}
+
+void *FreeListAllocator::Allocate(uint64 size, uint64 alignment) {
+  if (!_memory) {
+    FERROR("FreeListAllocator::Allocate(): allocator not initialized!");
+    return nullptr;
+  }
+
+  if (size == 0) {
+    FWARN("FreeListAllocator::Allocate(): zero sized allocation requested");
+    return nullptr;
+  }
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("FreeListAllocator::Allocate(): alignment must be a power of 2 "
+           "(got %llu)",
+           alignment);
+    return nullptr;
+  }
+
+  uint64 adjusted = math::AlignUp(size, ALIGN_SIZE);
+  if (adjusted < BLOCK_SIZE_MIN) {
+    adjusted = BLOCK_SIZE_MIN;
+  }
+
+  // Over-aligned requests need room to carve a free block in front of the
+  // aligned payload
+  uint64 searchSize = adjusted;
+  if (alignment > ALIGN_SIZE) {
+    searchSize += alignment + BLOCK_OVERHEAD + BLOCK_SIZE_MIN;
+  }
+
+  BlockHeader *block = LocateFree(searchSize);
+  if (!block) {
+    FERROR("FreeListAllocator::Allocate(): out of memory for %lluB (%lluB "
+           "free)",
+           size, GetFreeSize());
+    return nullptr;
+  }
+
+  if (alignment > ALIGN_SIZE) {
+    uintptr_t payload = reinterpret_cast<uintptr_t>(PayloadOf(block));
+    uint64 gap = math::AlignUp(payload, alignment) - payload;
+
+    // The gap becomes its own free block, so it must fit a header and the
+    // free list links
+    if (gap != 0 && gap < BLOCK_OVERHEAD + BLOCK_SIZE_MIN) {
+      gap = math::AlignUp(payload + BLOCK_OVERHEAD + BLOCK_SIZE_MIN,
+                          alignment) -
+            payload;
+    }
+
+    if (gap != 0) {
+      block = TrimLeading(block, gap);
+    }
+  }
+
+  TrimTrailing(block, adjusted);
+  block->SetFree(FeFalse);
+  _allocated += block->Size() + BLOCK_OVERHEAD;
+
+  return PayloadOf(block);
+}
+
+void FreeListAllocator::Free(void *block) {
+  if (!block) {
+    return;
+  }
+
+  if (!Owns(block)) {
+    FERROR("FreeListAllocator::Free(): block %p does not belong to this "
+           "allocator",
+           block);
+    return;
+  }
+
+  BlockHeader *header = reinterpret_cast<BlockHeader *>(HeaderOf(block));
+  if (header->IsFree()) {
+    FERROR("FreeListAllocator::Free(): double free of block %p", block);
+    return;
+  }
+
+  _allocated -= header->Size() + BLOCK_OVERHEAD;
+  header->SetFree(FeTrue);
+
+  // Coalesce with the previous block
+  BlockHeader *prev = header->prevPhysical;
+  if (prev && prev->IsFree()) {
+    RemoveFree(prev);
+    prev->SetSize(prev->Size() + BLOCK_OVERHEAD + header->Size());
+    header = prev;
+  }
+
+  // Coalesce with the next block. The sentinel is never free, so this always
+  // stops at the end of the pool
+  BlockHeader *next =
+      reinterpret_cast<BlockHeader *>(PayloadOf(header) + header->Size());
+  if (next->IsFree()) {
+    RemoveFree(next);
+    header->SetSize(header->Size() + BLOCK_OVERHEAD + next->Size());
+  }
+
+  next = reinterpret_cast<BlockHeader *>(PayloadOf(header) + header->Size());
+  next->prevPhysical = header;
+
+  InsertFree(header);
+}
+
+bool FreeListAllocator::Owns(const void *block) const {
+  const uchar *ptr = reinterpret_cast<const uchar *>(block);
+  return ptr >= _poolStart && ptr < _poolEnd;
+}
+
+uint64 FreeListAllocator::GetBlockSize(const void *block) const {
+  if (!Owns(block)) {
+    return 0;
+  }
+
+  return reinterpret_cast<const BlockHeader *>(HeaderOf(block))->Size();
+}
+
+uint64 FreeListAllocator::GetTotalSize() const { return _totalSize; }
+
+uint64 FreeListAllocator::GetAllocatedSize() const { return _allocated; }
+
+uint64 FreeListAllocator::GetFreeSize() const {
+  // Pool minus the first block header and the sentinel
+  uint64 usable = (_poolEnd - _poolStart) - 2 * BLOCK_OVERHEAD;
+  return usable - _allocated;
+}
+
+void *FreeListAllocator::GetMemory() const { return _memory; }
+
+// Private members
+
+void FreeListAllocator::InitializePool() {
+  uintptr_t start =
+      math::AlignUp(reinterpret_cast<uintptr_t>(_memory), ALIGN_SIZE);
+  uintptr_t end =
+      (reinterpret_cast<uintptr_t>(_memory) + _totalSize) & ~(ALIGN_SIZE - 1);
+  _poolStart = reinterpret_cast<uchar *>(start);
+  _poolEnd = reinterpret_cast<uchar *>(end);
+
+  // One free block spanning the pool, followed by a zero sized used sentinel
+  BlockHeader *block = reinterpret_cast<BlockHeader *>(_poolStart);
+  block->prevPhysical = nullptr;
+  block->sizeAndFlags = 0;
+  block->SetSize((end - start) - 2 * BLOCK_OVERHEAD);
+  block->SetFree(FeTrue);
+
+  BlockHeader *sentinel =
+      reinterpret_cast<BlockHeader *>(PayloadOf(block) + block->Size());
+  sentinel->prevPhysical = block;
+  sentinel->sizeAndFlags = 0;
+
+  InsertFree(block);
+}
+
+FreeListAllocator::BlockHeader *FreeListAllocator::LocateFree(uint64 size) {
+  uint32 fl = 0;
+  uint32 sl = 0;
+  MappingSearch(size, &fl, &sl);
+  if (fl >= FL_INDEX_COUNT) {
+    return nullptr;
+  }
+
+  // Search the current first level class for a big enough list, then fall
+  // back to the next non empty class
+  uint32 slMap = _slBitmap[fl] & (~0u << sl);
+  if (!slMap) {
+    uint32 flMap = _flBitmap & (~0u << (fl + 1));
+    if (!flMap) {
+      return nullptr;
+    }
+
+    fl = std::countr_zero(flMap);
+    slMap = _slBitmap[fl];
+  }
+
+  sl = std::countr_zero(slMap);
+  BlockHeader *block = _freeLists[fl][sl];
+  RemoveFree(block);
+  return block;
+}
+
+FreeListAllocator::BlockHeader *
+FreeListAllocator::TrimLeading(BlockHeader *block, uint64 gap) {
+  // Keep the first gap bytes as a free block and return the remaining one
+  BlockHeader *remaining =
+      reinterpret_cast<BlockHeader *>(PayloadOf(block) + gap - BLOCK_OVERHEAD);
+  remaining->prevPhysical = block;
+  remaining->sizeAndFlags = 0;
+  remaining->SetSize(block->Size() - gap);
+  remaining->SetFree(FeTrue);
+
+  BlockHeader *next = reinterpret_cast<BlockHeader *>(PayloadOf(remaining) +
+                                                      remaining->Size());
+  next->prevPhysical = remaining;
+
+  block->SetSize(gap - BLOCK_OVERHEAD);
+  InsertFree(block);
+
+  return remaining;
+}
+
+void FreeListAllocator::TrimTrailing(BlockHeader *block, uint64 size) {
+  if (block->Size() < size + BLOCK_OVERHEAD + BLOCK_SIZE_MIN) {
+    return;
+  }
+
+  BlockHeader *remaining =
+      reinterpret_cast<BlockHeader *>(PayloadOf(block) + size);
+  remaining->prevPhysical = block;
+  remaining->sizeAndFlags = 0;
+  remaining->SetSize(block->Size() - size - BLOCK_OVERHEAD);
+  remaining->SetFree(FeTrue);
+
+  BlockHeader *next = reinterpret_cast<BlockHeader *>(PayloadOf(remaining) +
+                                                      remaining->Size());
+  next->prevPhysical = remaining;
+
+  block->SetSize(size);
+
+  // The block after the one being split is in use, otherwise both would
+  // have been coalesced already, so no merge is needed here
+  InsertFree(remaining);
+}
+
+void FreeListAllocator::InsertFree(BlockHeader *block) {
+  uint32 fl = 0;
+  uint32 sl = 0;
+  MappingInsert(block->Size(), &fl, &sl);
+
+  BlockHeader *head = _freeLists[fl][sl];
+  block->nextFree = head;
+  block->prevFree = nullptr;
+  if (head) {
+    head->prevFree = block;
+  }
+
+  _freeLists[fl][sl] = block;
+  _flBitmap |= (1u << fl);
+  _slBitmap[fl] |= (1u << sl);
+}
+
+void FreeListAllocator::RemoveFree(BlockHeader *block) {
+  uint32 fl = 0;
+  uint32 sl = 0;
+  MappingInsert(block->Size(), &fl, &sl);
+
+  if (block->prevFree) {
+    block->prevFree->nextFree = block->nextFree;
+  }
+  if (block->nextFree) {
+    block->nextFree->prevFree = block->prevFree;
+  }
+
+  if (_freeLists[fl][sl] == block) {
+    _freeLists[fl][sl] = block->nextFree;
+    if (!block->nextFree) {
+      _slBitmap[fl] &= ~(1u << sl);
+      if (!_slBitmap[fl]) {
+        _flBitmap &= ~(1u << fl);
+      }
+    }
+  }
+
+  block->nextFree = nullptr;
+  block->prevFree = nullptr;
+}
+
+void FreeListAllocator::MappingInsert(uint64 size, uint32 *fl, uint32 *sl) {
+  if (size < SMALL_BLOCK_SIZE) {
+    // Small blocks are stored linearly in the first class
+    *fl = 0;
+    *sl = static_cast<uint32>(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    return;
+  }
+
+  uint32 msb = std::bit_width(size) - 1;
+  *sl = static_cast<uint32>(size >> (msb - SL_INDEX_COUNT_LOG2)) ^
+        SL_INDEX_COUNT;
+  *fl = msb - (FL_INDEX_SHIFT - 1);
+}
+
+void FreeListAllocator::MappingSearch(uint64 size, uint32 *fl, uint32 *sl) {
+  // Round up to the next list so any block found there is large enough
+  if (size >= SMALL_BLOCK_SIZE) {
+    uint32 msb = std::bit_width(size) - 1;
+    size += (1ull << (msb - SL_INDEX_COUNT_LOG2)) - 1;
+  }
+
+  MappingInsert(size, fl, sl);
+}
+
+} // namespace memory
+} // namespace flatearth
@@ -0,0 +1,79 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_FREE_LIST_ALLOCATOR_HPP
+#define _FLATEARTH_ENGINE_MEMORY_FREE_LIST_ALLOCATOR_HPP
+
+#include "Definitions.hpp"
+
+#include <array>
+
+namespace flatearth {
+namespace memory {
+
+// General purpose allocator serving variable sized blocks out of one
+// preallocated region. Free blocks are kept in two-level segregated lists
+// (TLSF), so both Allocate() and Free() run in constant time, and neighbouring
+// free blocks are coalesced on Free(). Not thread safe.
+class FreeListAllocator {
+public:
+  static constexpr uint64 FREELIST_DEFAULT_ALIGNMENT = 16;
+
+  FEAPI FreeListAllocator(uint64 totalSize, void *memory);
+  FEAPI ~FreeListAllocator();
+
+  FEAPI void *Allocate(uint64 size,
+                       uint64 alignment = FREELIST_DEFAULT_ALIGNMENT);
+  FEAPI void Free(void *block);
+
+  // Checks whether the block was handed out by this allocator
+  FEAPI bool Owns(const void *block) const;
+
+  // Usable size of an allocated block, which may be larger than requested
+  FEAPI uint64 GetBlockSize(const void *block) const;
+
+  FEAPI uint64 GetTotalSize() const;
+  FEAPI uint64 GetAllocatedSize() const;
+  FEAPI uint64 GetFreeSize() const;
+  FEAPI void *GetMemory() const;
+
+private:
+  struct BlockHeader;
+
+  // Free lists are split in first level classes (powers of two) and
+  // SL_INDEX_COUNT linear second level subdivisions of each class
+  static constexpr uint32 ALIGN_SIZE_LOG2 = 4;
+  static constexpr uint64 ALIGN_SIZE = 1ull << ALIGN_SIZE_LOG2;
+  static constexpr uint32 SL_INDEX_COUNT_LOG2 = 5;
+  static constexpr uint32 SL_INDEX_COUNT = 1u << SL_INDEX_COUNT_LOG2;
+  static constexpr uint32 FL_INDEX_MAX = 38;
+  static constexpr uint32 FL_INDEX_SHIFT = SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2;
+  static constexpr uint32 FL_INDEX_COUNT = FL_INDEX_MAX - FL_INDEX_SHIFT + 1;
+  static constexpr uint64 SMALL_BLOCK_SIZE = 1ull << FL_INDEX_SHIFT;
+
+  void InitializePool();
+  BlockHeader *LocateFree(uint64 size);
+  BlockHeader *TrimLeading(BlockHeader *block, uint64 gap);
+  void TrimTrailing(BlockHeader *block, uint64 size);
+  void InsertFree(BlockHeader *block);
+  void RemoveFree(BlockHeader *block);
+
+  static void MappingInsert(uint64 size, uint32 *fl, uint32 *sl);
+  static void MappingSearch(uint64 size, uint32 *fl, uint32 *sl);
+
+  uint64 _totalSize;
+  uint64 _allocated;
+  void *_memory;
+  bool _ownsMemory;
+
+  // Usable pool, aligned to ALIGN_SIZE
+  uchar *_poolStart;
+  uchar *_poolEnd;
+
+  uint32 _flBitmap;
+  std::array<uint32, FL_INDEX_COUNT> _slBitmap;
+  std::array<std::array<BlockHeader *, SL_INDEX_COUNT>, FL_INDEX_COUNT>
+      _freeLists;
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_FREE_LIST_ALLOCATOR_HPP
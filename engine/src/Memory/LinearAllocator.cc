@@ -2,25 +2,39 @@
 
 #include "Core/FeMemory.hpp"
 #include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
 #include <cstdint>
 
 namespace flatearth {
 namespace memory {
 
-LinearAllocator::LinearAllocator(uint64 totalSize, void *memory)
+LinearAllocator::LinearAllocator(uint64 totalSize, void *memory, uint32 flags)
     : _totalSize(totalSize), _allocated(0), _memory(memory),
-      _ownsMemory(memory == nullptr) {
-  if (!memory) {
+      _ownsMemory(memory == nullptr), _flags(flags),
+      _largePageKind(platform::LARGE_PAGE_NONE) {
+  if (!memory && (flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES)) {
+    _memory = core::memory::MemoryManager::AllocateLargePages(
+        totalSize, core::memory::MEMORY_TAG_LINEAR_ALLOCATOR, flags,
+        &_largePageKind);
+  } else if (!memory) {
+    // Cache line aligned so aligned requests don't waste the head of the block
     _memory = core::memory::MemoryManager::Allocate(
-        totalSize, core::memory::MEMORY_TAG_LINEAR_ALLOCATOR);
+        totalSize, core::memory::MEMORY_CACHE_LINE_SIZE,
+        core::memory::MEMORY_TAG_LINEAR_ALLOCATOR, flags);
   }
 }
 
 LinearAllocator::~LinearAllocator() {
   _allocated = 0;
-  if (_memory && _ownsMemory) {
+  if (_memory && _ownsMemory &&
+      (_flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES)) {
+    core::memory::MemoryManager::FreeLargePages(
+        _memory, _totalSize, core::memory::MEMORY_TAG_LINEAR_ALLOCATOR,
+        _largePageKind);
+  } else if (_memory && _ownsMemory) {
     core::memory::MemoryManager::Free(
-        _memory, _totalSize, core::memory::MEMORY_TAG_LINEAR_ALLOCATOR);
+        _memory, _totalSize, core::memory::MEMORY_CACHE_LINE_SIZE,
+        core::memory::MEMORY_TAG_LINEAR_ALLOCATOR);
   }
 
   _totalSize = 0;
@@ -35,8 +49,15 @@ void *LinearAllocator::Allocate(uint64 size, uint64 alignment) {
     return nullptr;
   }
 
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("LinearAllocator::Allocate(): alignment must be a power of 2 (got "
+           "%llu)",
+           alignment);
+    return nullptr;
+  }
+
   uintptr_t currentAddr = reinterpret_cast<uintptr_t>(_memory) + _allocated;
-  uintptr_t alignedAddr = AlignForward(currentAddr, alignment);
+  uintptr_t alignedAddr = math::AlignUp(currentAddr, alignment);
   uint64 adjustment = alignedAddr - currentAddr;
 
   if (_allocated + size + adjustment > _totalSize) {
@@ -56,8 +77,9 @@ void LinearAllocator::FreaAll() {
     return;
   }
 
+  // Bytes past the used range were never touched since the last reset
+  core::memory::MemoryManager::InitializeMemory(_memory, _allocated, _flags);
   _allocated = 0;
-  core::memory::MemoryManager::ZeroMemory(_memory, _totalSize);
 }
 
 uint64 LinearAllocator::GetTotalSize() const { return _totalSize; }
@@ -66,5 +88,9 @@ uint64 LinearAllocator::GetAllocatedSize() const { return _allocated; }
 
 void *LinearAllocator::GetMemory() const { return _memory; }
 
+platform::LargePageKind LinearAllocator::GetLargePageKind() const {
+  return _largePageKind;
+}
+
 } // namespace memory
 } // namespace flatearth
@@ -1,6 +1,7 @@
 #ifndef _FLATEARHT_ENGINE_MEMORY_LINEAR_ALLOCATOR_HPP
 #define _FLATEARHT_ENGINE_MEMORY_LINEAR_ALLOCATOR_HPP
 
+#include "Core/FeMemory.hpp"
 #include "Definitions.hpp"
 
 namespace flatearth {
@@ -8,7 +9,12 @@ namespace memory {
 
 class LinearAllocator {
 public:
-  FEAPI LinearAllocator(uint64 totalSize, void *memory);
+  // flags (core::memory::AllocationFlags) decide what FreaAll() leaves behind
+  // in the bytes that were handed out, and whether owned memory is backed by
+  // huge pages
+  FEAPI LinearAllocator(
+      uint64 totalSize, void *memory,
+      uint32 flags = core::memory::ALLOCATION_FLAG_ZEROED);
   ~LinearAllocator();
 
   FEAPI void *Allocate(uint64 size, uint64 alignment = 8);
@@ -17,16 +23,15 @@ public:
   FEAPI uint64 GetTotalSize() const;
   FEAPI uint64 GetAllocatedSize() const;
   FEAPI void *GetMemory() const;
-
-  FINLINE uintptr_t AlignForward(uintptr_t address, uint64 alignment) {
-    return (address + (alignment - 1)) & ~(alignment - 1);
-  }
+  FEAPI platform::LargePageKind GetLargePageKind() const;
 
 private:
   uint64 _totalSize;
   uint64 _allocated;
   void *_memory;
   bool _ownsMemory;
+  uint32 _flags;
+  platform::LargePageKind _largePageKind;
 };
 
 } // namespace memory
@@ -0,0 +1,201 @@
+#include "PoolAllocator.hpp"
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace flatearth {
+namespace memory {
+
+// Every block must be able to hold the free list link
+FINLINE uint64 BlockStride(uint64 blockSize, uint64 alignment) {
+  uint64 size = blockSize < sizeof(void *) ? sizeof(void *) : blockSize;
+  return math::AlignUp(size, alignment);
+}
+
+PoolAllocator::PoolAllocator(uint64 blockSize, uint64 blocksPerChunk,
+                             void *memory, uint64 alignment, bool growable)
+    : _blockSize(0), _blocksPerChunk(blocksPerChunk), _alignment(alignment),
+      _chunkHeaderSize(0), _growable(growable), _externalBlocks(nullptr),
+      _chunks(nullptr), _chunkCount(0), _freeList(nullptr),
+      _allocatedCount(0) {
+  if (blockSize == 0 || blocksPerChunk == 0) {
+    FERROR("PoolAllocator::PoolAllocator(): block size and block count must "
+           "be greater than 0");
+    throw std::invalid_argument("Invalid pool allocator dimensions");
+  }
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("PoolAllocator::PoolAllocator(): alignment must be a power of 2 "
+           "(got %llu)",
+           alignment);
+    throw std::invalid_argument("Invalid pool allocator alignment");
+  }
+
+  if (_alignment < alignof(void *)) {
+    _alignment = alignof(void *);
+  }
+
+  _blockSize = BlockStride(blockSize, _alignment);
+  _chunkHeaderSize = math::AlignUp(sizeof(Chunk), _alignment);
+
+  if (memory) {
+    _externalBlocks = reinterpret_cast<uchar *>(
+        math::AlignUp(reinterpret_cast<uintptr_t>(memory), _alignment));
+    PushBlocks(_externalBlocks, _blocksPerChunk);
+    return;
+  }
+
+  if (!AllocateChunk()) {
+    throw std::runtime_error("Failed to allocate pool allocator chunk");
+  }
+}
+
+PoolAllocator::~PoolAllocator() {
+  uint64 chunkSize = _chunkHeaderSize + _blockSize * _blocksPerChunk;
+  Chunk *chunk = _chunks;
+  while (chunk) {
+    Chunk *next = chunk->next;
+    core::memory::MemoryManager::Free(chunk, chunkSize, _alignment,
+                                      core::memory::MEMORY_TAG_POOL_ALLOCATOR);
+    chunk = next;
+  }
+
+  _chunks = nullptr;
+  _chunkCount = 0;
+  _externalBlocks = nullptr;
+  _freeList = nullptr;
+  _allocatedCount = 0;
+}
+
+void *PoolAllocator::Allocate() {
+  if (!_freeList) {
+    if (!_growable) {
+      FERROR("PoolAllocator::Allocate(): pool exhausted (%llu blocks of %lluB)",
+             GetCapacity(), _blockSize);
+      return nullptr;
+    }
+
+    if (!AllocateChunk()) {
+      FERROR("PoolAllocator::Allocate(): failed to grow pool");
+      return nullptr;
+    }
+  }
+
+  void *block = _freeList;
+  _freeList = *reinterpret_cast<void **>(block);
+  _allocatedCount++;
+  return block;
+}
+
+void PoolAllocator::Free(void *block) {
+  if (!block) {
+    return;
+  }
+
+  if (_allocatedCount == 0) {
+    FERROR("PoolAllocator::Free(): freeing block %p from an empty pool", block);
+    return;
+  }
+
+  *reinterpret_cast<void **>(block) = _freeList;
+  _freeList = block;
+  _allocatedCount--;
+}
+
+void PoolAllocator::FreeAll() {
+  _freeList = nullptr;
+  _allocatedCount = 0;
+
+  if (_externalBlocks) {
+    PushBlocks(_externalBlocks, _blocksPerChunk);
+  }
+
+  for (Chunk *chunk = _chunks; chunk; chunk = chunk->next) {
+    PushBlocks(BlocksOf(chunk), _blocksPerChunk);
+  }
+}
+
+bool PoolAllocator::Owns(const void *block) const {
+  const uchar *ptr = reinterpret_cast<const uchar *>(block);
+  if (_externalBlocks && RegionOwns(_externalBlocks, ptr)) {
+    return FeTrue;
+  }
+
+  for (Chunk *chunk = _chunks; chunk; chunk = chunk->next) {
+    if (RegionOwns(BlocksOf(chunk), ptr)) {
+      return FeTrue;
+    }
+  }
+
+  return FeFalse;
+}
+
+uint64 PoolAllocator::GetBlockSize() const { return _blockSize; }
+
+uint64 PoolAllocator::GetAlignment() const { return _alignment; }
+
+uint64 PoolAllocator::GetCapacity() const {
+  uint64 regions = _chunkCount + (_externalBlocks ? 1 : 0);
+  return regions * _blocksPerChunk;
+}
+
+uint64 PoolAllocator::GetAllocatedCount() const { return _allocatedCount; }
+
+uint64 PoolAllocator::GetChunkCount() const { return _chunkCount; }
+
+uint64 PoolAllocator::GetMemoryRequirement(uint64 blockSize, uint64 blockCount,
+                                           uint64 alignment) {
+  if (alignment < alignof(void *)) {
+    alignment = alignof(void *);
+  }
+
+  // Extra room to align the start of a caller provided region
+  return BlockStride(blockSize, alignment) * blockCount + alignment - 1;
+}
+
+// Private members
+
+bool PoolAllocator::AllocateChunk() {
+  uint64 chunkSize = _chunkHeaderSize + _blockSize * _blocksPerChunk;
+  void *memory = core::memory::MemoryManager::Allocate(
+      chunkSize, _alignment, core::memory::MEMORY_TAG_POOL_ALLOCATOR);
+  if (!memory) {
+    return FeFalse;
+  }
+
+  Chunk *chunk = reinterpret_cast<Chunk *>(memory);
+  chunk->next = _chunks;
+  _chunks = chunk;
+  _chunkCount++;
+
+  PushBlocks(BlocksOf(chunk), _blocksPerChunk);
+  return FeTrue;
+}
+
+void PoolAllocator::PushBlocks(uchar *blocks, uint64 count) {
+  // Push backwards so blocks are handed out in address order
+  for (uint64 i = count; i > 0; i--) {
+    void *block = blocks + (i - 1) * _blockSize;
+    *reinterpret_cast<void **>(block) = _freeList;
+    _freeList = block;
+  }
+}
+
+bool PoolAllocator::RegionOwns(const uchar *blocks, const uchar *ptr) const {
+  if (ptr < blocks || ptr >= blocks + _blockSize * _blocksPerChunk) {
+    return FeFalse;
+  }
+
+  return (ptr - blocks) % _blockSize == 0;
+}
+
+uchar *PoolAllocator::BlocksOf(Chunk *chunk) const {
+  return reinterpret_cast<uchar *>(chunk) + _chunkHeaderSize;
+}
+
+} // namespace memory
+} // namespace flatearth
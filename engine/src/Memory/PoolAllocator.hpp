@@ -0,0 +1,70 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_POOL_ALLOCATOR_HPP
+#define _FLATEARTH_ENGINE_MEMORY_POOL_ALLOCATOR_HPP
+
+#include "Definitions.hpp"
+
+namespace flatearth {
+namespace memory {
+
+// Hands out fixed size blocks in O(1). Free blocks are chained through an
+// intrusive singly linked list stored inside the blocks themselves. A
+// growable pool allocates a new chunk of blocksPerChunk blocks whenever it
+// runs dry; chunks are only released when the pool is destroyed.
+class PoolAllocator {
+public:
+  // When memory is provided it must hold at least
+  // GetMemoryRequirement(blockSize, blocksPerChunk, alignment) bytes, and
+  // the pool will not take ownership of it
+  FEAPI PoolAllocator(uint64 blockSize, uint64 blocksPerChunk, void *memory,
+                      uint64 alignment = alignof(void *),
+                      bool growable = FeFalse);
+  FEAPI ~PoolAllocator();
+
+  PoolAllocator(const PoolAllocator &) = delete;
+  PoolAllocator &operator=(const PoolAllocator &) = delete;
+
+  FEAPI void *Allocate();
+  FEAPI void Free(void *block);
+  FEAPI void FreeAll();
+
+  FEAPI bool Owns(const void *block) const;
+
+  FEAPI uint64 GetBlockSize() const;
+  FEAPI uint64 GetAlignment() const;
+  FEAPI uint64 GetCapacity() const;
+  FEAPI uint64 GetAllocatedCount() const;
+  FEAPI uint64 GetChunkCount() const;
+
+  FEAPI static uint64 GetMemoryRequirement(uint64 blockSize,
+                                           uint64 blockCount,
+                                           uint64 alignment = alignof(void *));
+
+private:
+  struct Chunk {
+    Chunk *next;
+  };
+
+  bool AllocateChunk();
+  void PushBlocks(uchar *blocks, uint64 count);
+  bool RegionOwns(const uchar *blocks, const uchar *ptr) const;
+  uchar *BlocksOf(Chunk *chunk) const;
+
+  uint64 _blockSize;
+  uint64 _blocksPerChunk;
+  uint64 _alignment;
+  uint64 _chunkHeaderSize;
+  bool _growable;
+
+  // Caller provided region, nullptr when every block lives in owned chunks
+  uchar *_externalBlocks;
+  Chunk *_chunks;
+  uint64 _chunkCount;
+
+  void *_freeList;
+  uint64 _allocatedCount;
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_POOL_ALLOCATOR_HPP
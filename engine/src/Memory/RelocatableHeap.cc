@@ -0,0 +1,268 @@
+#include "RelocatableHeap.hpp"
+
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace flatearth {
+namespace memory {
+
+// Marks freed blocks in BlockHeader::handle
+constexpr uint32 RELOCATABLE_BLOCK_FREE = UINT32_MAX;
+// Marks the end of the handle free list and unused handle entries
+constexpr uint32 RELOCATABLE_HANDLE_NONE = UINT32_MAX;
+constexpr uint64 RELOCATABLE_OFFSET_NONE = UINT64_MAX;
+
+// Sits right before every block, tells the compaction how far to step and
+// which handle to patch when the block moves
+struct RelocatableHeap::BlockHeader {
+  uint64 size;
+  uint32 handle;
+  uint32 tag;
+};
+
+struct RelocatableHeap::HandleEntry {
+  uint64 offset;
+  uint32 generation;
+  uint32 nextFree;
+};
+
+RelocatableHeap::RelocatableHeap(uint64 totalSize, uint32 maxHandles)
+    : _memory(nullptr), _allocationSize(0), _heap(nullptr),
+      _totalSize(math::AlignUp(totalSize, RELOCATABLE_HEAP_ALIGNMENT)), _top(0),
+      _handles(nullptr), _maxHandles(maxHandles), _handleCount(0),
+      _freeHandle(RELOCATABLE_HANDLE_NONE), _liveSize(0), _fragmentedSize(0),
+      _taggedLive(), _taggedReclaimed(), _defragmenting(FeFalse),
+      _compactWrite(0), _compactRead(0) {
+  if (totalSize == 0 || maxHandles == 0 ||
+      maxHandles == RELOCATABLE_HANDLE_NONE) {
+    FERROR("RelocatableHeap::RelocatableHeap(): size and handle count must be "
+           "greater than 0");
+    throw std::invalid_argument("Invalid relocatable heap dimensions");
+  }
+
+  uint64 tableSize = math::AlignUp((uint64)maxHandles * sizeof(HandleEntry),
+                                   RELOCATABLE_HEAP_ALIGNMENT);
+  _allocationSize = tableSize + _totalSize;
+  _memory = static_cast<uchar *>(core::memory::MemoryManager::Allocate(
+      _allocationSize, RELOCATABLE_HEAP_ALIGNMENT,
+      core::memory::MEMORY_TAG_RELOCATABLE_HEAP,
+      core::memory::ALLOCATION_FLAG_UNINITIALIZED));
+  if (!_memory) {
+    throw std::runtime_error("Failed to allocate relocatable heap");
+  }
+
+  _handles = reinterpret_cast<HandleEntry *>(_memory);
+  _heap = _memory + tableSize;
+
+  // Pushed in reverse so handles are handed out from index 0 up
+  for (uint32 i = maxHandles; i > 0; i--) {
+    HandleEntry &entry = _handles[i - 1];
+    entry.offset = RELOCATABLE_OFFSET_NONE;
+    entry.generation = 1;
+    entry.nextFree = _freeHandle;
+    _freeHandle = i - 1;
+  }
+}
+
+RelocatableHeap::~RelocatableHeap() {
+  if (_handleCount > 0) {
+    FWARN("RelocatableHeap::~RelocatableHeap(): %u handles were never freed",
+          _handleCount);
+  }
+
+  core::memory::MemoryManager::Free(_memory, _allocationSize,
+                                    RELOCATABLE_HEAP_ALIGNMENT,
+                                    core::memory::MEMORY_TAG_RELOCATABLE_HEAP);
+  _memory = nullptr;
+  _heap = nullptr;
+  _handles = nullptr;
+}
+
+MemoryHandle RelocatableHeap::Allocate(uint64 size, core::memory::MemoryTag tag,
+                                       uint32 flags) {
+  if (size == 0 || tag >= core::memory::MEMORY_TAG_MAX_TAGS) {
+    FERROR("RelocatableHeap::Allocate(): invalid size %llu or tag %u", size,
+           (uint32)tag);
+    return INVALID_MEMORY_HANDLE;
+  }
+
+  uint64 payload = math::AlignUp(size, RELOCATABLE_HEAP_ALIGNMENT);
+  uint64 stride = sizeof(BlockHeader) + payload;
+  if (stride > _totalSize - _top) {
+    FERROR("RelocatableHeap::Allocate(): out of memory, requested %lluB with "
+           "%lluB left (%lluB fragmented)",
+           size, _totalSize - _top, _fragmentedSize);
+    return INVALID_MEMORY_HANDLE;
+  }
+
+  if (_freeHandle == RELOCATABLE_HANDLE_NONE) {
+    FERROR("RelocatableHeap::Allocate(): all %u handles are in use",
+           _maxHandles);
+    return INVALID_MEMORY_HANDLE;
+  }
+
+  uint32 index = _freeHandle;
+  HandleEntry &entry = _handles[index];
+  _freeHandle = entry.nextFree;
+  entry.offset = _top;
+  entry.nextFree = RELOCATABLE_HANDLE_NONE;
+
+  BlockHeader *header = HeaderAt(_top);
+  header->size = payload;
+  header->handle = index;
+  header->tag = tag;
+  _top += stride;
+
+  _handleCount++;
+  _liveSize += payload;
+  _taggedLive[tag] += payload;
+
+  core::memory::MemoryManager::InitializeMemory(header + 1, payload, flags);
+  return {index, entry.generation};
+}
+
+void RelocatableHeap::Free(MemoryHandle handle) {
+  if (!handle.IsValid()) {
+    return;
+  }
+
+  HandleEntry *entry = LookUp(handle);
+  if (!entry) {
+    FERROR("RelocatableHeap::Free(): stale handle %u (generation %u)",
+           handle.index, handle.generation);
+    return;
+  }
+
+  BlockHeader *header = HeaderAt(entry->offset);
+  uint64 stride = sizeof(BlockHeader) + header->size;
+  _handleCount--;
+  _liveSize -= header->size;
+  _taggedLive[header->tag] -= header->size;
+
+  // The last block can be given back right away, unless a compaction pass
+  // still has to walk over it
+  if (!_defragmenting && entry->offset + stride == _top) {
+    _top = entry->offset;
+  } else {
+    header->handle = RELOCATABLE_BLOCK_FREE;
+    _fragmentedSize += stride;
+  }
+
+  entry->offset = RELOCATABLE_OFFSET_NONE;
+  // Generation 0 marks invalid handles, skip it on wrap around
+  entry->generation = entry->generation + 1 == 0 ? 1 : entry->generation + 1;
+  entry->nextFree = _freeHandle;
+  _freeHandle = handle.index;
+}
+
+void *RelocatableHeap::Resolve(MemoryHandle handle) const {
+  HandleEntry *entry = LookUp(handle);
+  if (!entry) {
+    return nullptr;
+  }
+
+  return HeaderAt(entry->offset) + 1;
+}
+
+bool RelocatableHeap::IsValid(MemoryHandle handle) const {
+  return LookUp(handle) != nullptr;
+}
+
+uint64 RelocatableHeap::Defragment(float64 timeBudgetSeconds) {
+  if (!_defragmenting) {
+    if (_fragmentedSize == 0) {
+      return 0;
+    }
+
+    _defragmenting = FeTrue;
+    _compactWrite = 0;
+    _compactRead = 0;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::duration<float64>(timeBudgetSeconds));
+  uint64 reclaimed = 0;
+
+  while (_compactRead < _top) {
+    BlockHeader *header = HeaderAt(_compactRead);
+    uint64 stride = sizeof(BlockHeader) + header->size;
+
+    if (header->handle == RELOCATABLE_BLOCK_FREE) {
+      core::memory::MemoryTag tag =
+          static_cast<core::memory::MemoryTag>(header->tag);
+      _taggedReclaimed[tag] += stride;
+      core::memory::MemoryManager::TrackReclaimed(stride, tag);
+      reclaimed += stride;
+    } else {
+      if (_compactRead != _compactWrite) {
+        std::memmove(_heap + _compactWrite, header, stride);
+        _handles[HeaderAt(_compactWrite)->handle].offset = _compactWrite;
+      }
+      _compactWrite += stride;
+    }
+
+    _compactRead += stride;
+    if (std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+  }
+
+  if (_compactRead == _top) {
+    _fragmentedSize -= _compactRead - _compactWrite;
+    _top = _compactWrite;
+    _defragmenting = FeFalse;
+  }
+
+  return reclaimed;
+}
+
+bool RelocatableHeap::IsDefragmenting() const { return _defragmenting; }
+
+uint64 RelocatableHeap::GetTotalSize() const { return _totalSize; }
+
+uint64 RelocatableHeap::GetUsedSize() const { return _top; }
+
+uint64 RelocatableHeap::GetLiveSize() const { return _liveSize; }
+
+uint64 RelocatableHeap::GetFragmentedSize() const { return _fragmentedSize; }
+
+uint64
+RelocatableHeap::GetTaggedLiveSize(core::memory::MemoryTag tag) const {
+  return tag < core::memory::MEMORY_TAG_MAX_TAGS ? _taggedLive[tag] : 0;
+}
+
+uint64
+RelocatableHeap::GetTaggedReclaimedSize(core::memory::MemoryTag tag) const {
+  return tag < core::memory::MEMORY_TAG_MAX_TAGS ? _taggedReclaimed[tag] : 0;
+}
+
+uint32 RelocatableHeap::GetHandleCount() const { return _handleCount; }
+
+// Private members
+
+RelocatableHeap::BlockHeader *RelocatableHeap::HeaderAt(uint64 offset) const {
+  return reinterpret_cast<BlockHeader *>(_heap + offset);
+}
+
+RelocatableHeap::HandleEntry *
+RelocatableHeap::LookUp(MemoryHandle handle) const {
+  if (!handle.IsValid() || handle.index >= _maxHandles) {
+    return nullptr;
+  }
+
+  HandleEntry *entry = &_handles[handle.index];
+  if (entry->generation != handle.generation ||
+      entry->offset == RELOCATABLE_OFFSET_NONE) {
+    return nullptr;
+  }
+
+  return entry;
+}
+
+} // namespace memory
+} // namespace flatearth
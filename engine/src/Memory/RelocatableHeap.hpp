@@ -0,0 +1,102 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_RELOCATABLE_HEAP_HPP
+#define _FLATEARTH_ENGINE_MEMORY_RELOCATABLE_HEAP_HPP
+
+#include "Core/FeMemory.hpp"
+#include "Definitions.hpp"
+
+namespace flatearth {
+namespace memory {
+
+// Reference to a block of a RelocatableHeap. The generation makes handles to
+// freed blocks stale instead of dangling, generation 0 is never handed out.
+struct MemoryHandle {
+  uint32 index;
+  uint32 generation;
+
+  bool IsValid() const { return generation != 0; }
+  bool operator==(const MemoryHandle &other) const = default;
+};
+
+constexpr MemoryHandle INVALID_MEMORY_HANDLE = {0, 0};
+
+// Heap whose blocks are only reached through handles, so they can be moved.
+// Allocations are bumped at the top of the heap and frees leave holes behind;
+// Defragment() slides live blocks down over the holes a few at a time, within
+// a time budget, so it can run once per frame. Pointers from Resolve() are
+// only valid until the next Defragment() call. Not thread safe.
+class RelocatableHeap {
+public:
+  static constexpr uint64 RELOCATABLE_HEAP_ALIGNMENT = 16;
+
+  // The heap region and the handle table are allocated together under
+  // MEMORY_TAG_RELOCATABLE_HEAP
+  FEAPI RelocatableHeap(uint64 totalSize, uint32 maxHandles);
+  FEAPI ~RelocatableHeap();
+
+  RelocatableHeap(const RelocatableHeap &) = delete;
+  RelocatableHeap &operator=(const RelocatableHeap &) = delete;
+
+  // Blocks are RELOCATABLE_HEAP_ALIGNMENT aligned. The tag is kept with the
+  // block to account for live and reclaimed bytes
+  FEAPI MemoryHandle Allocate(uint64 size, core::memory::MemoryTag tag,
+                              uint32 flags = core::memory::ALLOCATION_FLAG_ZEROED);
+  FEAPI void Free(MemoryHandle handle);
+
+  // nullptr for stale or invalid handles
+  FEAPI void *Resolve(MemoryHandle handle) const;
+  FEAPI bool IsValid(MemoryHandle handle) const;
+
+  // Compacts until every hole is gone or the budget runs out, resuming where
+  // the previous call stopped. At least one block is processed per call.
+  // Returns the bytes of freed blocks compacted away by this call, they can
+  // be allocated again once the pass completes
+  FEAPI uint64 Defragment(float64 timeBudgetSeconds);
+  FEAPI bool IsDefragmenting() const;
+
+  FEAPI uint64 GetTotalSize() const;
+  // Bytes up to the top of the heap, holes included
+  FEAPI uint64 GetUsedSize() const;
+  // Payload bytes of live blocks
+  FEAPI uint64 GetLiveSize() const;
+  // Bytes of holes left by freed blocks, headers included
+  FEAPI uint64 GetFragmentedSize() const;
+  FEAPI uint64 GetTaggedLiveSize(core::memory::MemoryTag tag) const;
+  FEAPI uint64 GetTaggedReclaimedSize(core::memory::MemoryTag tag) const;
+  FEAPI uint32 GetHandleCount() const;
+
+private:
+  struct BlockHeader;
+  struct HandleEntry;
+
+  BlockHeader *HeaderAt(uint64 offset) const;
+  HandleEntry *LookUp(MemoryHandle handle) const;
+
+  uchar *_memory;
+  uint64 _allocationSize;
+  uchar *_heap;
+  uint64 _totalSize;
+  uint64 _top;
+
+  HandleEntry *_handles;
+  uint32 _maxHandles;
+  uint32 _handleCount;
+  uint32 _freeHandle;
+
+  uint64 _liveSize;
+  uint64 _fragmentedSize;
+  uint64 _taggedLive[core::memory::MEMORY_TAG_MAX_TAGS];
+  uint64 _taggedReclaimed[core::memory::MEMORY_TAG_MAX_TAGS];
+
+  // Incremental compaction state: [0, _compactWrite) is compacted,
+  // [_compactWrite, _compactRead) is free and [_compactRead, _top) has not
+  // been visited yet. Blocks are only walked by the compaction so the gap
+  // needs no header
+  bool _defragmenting;
+  uint64 _compactWrite;
+  uint64 _compactRead;
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_RELOCATABLE_HEAP_HPP
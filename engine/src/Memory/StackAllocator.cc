@@ -0,0 +1,288 @@
+#include "StackAllocator.hpp"
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+
+#include <cstdint>
+
+namespace flatearth {
+namespace memory {
+
+FINLINE uintptr_t AlignBackward(uintptr_t address, uint64 alignment) {
+  return address & ~(alignment - 1);
+}
+
+// Both allocators hand out a cache line aligned block when they own it, or a
+// huge page backed one when asked to
+FINLINE void *AllocateStackMemory(uint64 totalSize, uint32 flags,
+                                  platform::LargePageKind *kind) {
+  if (flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES) {
+    return core::memory::MemoryManager::AllocateLargePages(
+        totalSize, core::memory::MEMORY_TAG_STACK_ALLOCATOR, flags, kind);
+  }
+
+  return core::memory::MemoryManager::Allocate(
+      totalSize, core::memory::MEMORY_CACHE_LINE_SIZE,
+      core::memory::MEMORY_TAG_STACK_ALLOCATOR, flags);
+}
+
+FINLINE void FreeStackMemory(void *memory, uint64 totalSize, uint32 flags,
+                             platform::LargePageKind kind) {
+  if (flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES) {
+    core::memory::MemoryManager::FreeLargePages(
+        memory, totalSize, core::memory::MEMORY_TAG_STACK_ALLOCATOR, kind);
+    return;
+  }
+
+  core::memory::MemoryManager::Free(memory, totalSize,
+                                    core::memory::MEMORY_CACHE_LINE_SIZE,
+                                    core::memory::MEMORY_TAG_STACK_ALLOCATOR);
+}
+
+// StackAllocator
+
+StackAllocator::StackAllocator(uint64 totalSize, void *memory, uint32 flags)
+    : _totalSize(totalSize), _allocated(0), _memory(memory),
+      _ownsMemory(memory == nullptr), _flags(flags),
+      _largePageKind(platform::LARGE_PAGE_NONE) {
+  if (!memory) {
+    _memory = AllocateStackMemory(totalSize, flags, &_largePageKind);
+  }
+}
+
+StackAllocator::~StackAllocator() {
+  _allocated = 0;
+  if (_memory && _ownsMemory) {
+    FreeStackMemory(_memory, _totalSize, _flags, _largePageKind);
+  }
+
+  _totalSize = 0;
+  _ownsMemory = FeFalse;
+  _memory = nullptr;
+}
+
+void *StackAllocator::Allocate(uint64 size, uint64 alignment) {
+  if (!_memory) {
+    FERROR("StackAllocator::Allocate(): Provided allocator not initialized!");
+    return nullptr;
+  }
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("StackAllocator::Allocate(): alignment must be a power of 2 (got "
+           "%llu)",
+           alignment);
+    return nullptr;
+  }
+
+  uintptr_t currentAddr = reinterpret_cast<uintptr_t>(_memory) + _allocated;
+  uintptr_t alignedAddr = math::AlignUp(currentAddr, alignment);
+  uint64 adjustment = alignedAddr - currentAddr;
+
+  if (_allocated + size + adjustment > _totalSize) {
+    uint64 remaining = _totalSize - _allocated;
+    FERROR("StackAllocator::Allocate(): Tried to allocate %lluB (with %lluB "
+           "alignment), only %lluB remaining",
+           size, adjustment, remaining);
+    return nullptr;
+  }
+
+  _allocated += adjustment + size;
+  return reinterpret_cast<void *>(alignedAddr);
+}
+
+StackMarker StackAllocator::GetMarker() const { return _allocated; }
+
+void StackAllocator::FreeToMarker(StackMarker marker) {
+  if (marker > _allocated) {
+    FERROR("StackAllocator::FreeToMarker(): marker %llu is above the top of "
+           "the stack (%llu)",
+           marker, _allocated);
+    return;
+  }
+
+  // Only the released range needs clearing
+  core::memory::MemoryManager::InitializeMemory(
+      reinterpret_cast<uchar *>(_memory) + marker, _allocated - marker,
+      _flags);
+  _allocated = marker;
+}
+
+void StackAllocator::FreeAll() {
+  if (!_memory) {
+    return;
+  }
+
+  FreeToMarker(0);
+}
+
+uint64 StackAllocator::GetTotalSize() const { return _totalSize; }
+
+uint64 StackAllocator::GetAllocatedSize() const { return _allocated; }
+
+void *StackAllocator::GetMemory() const { return _memory; }
+
+platform::LargePageKind StackAllocator::GetLargePageKind() const {
+  return _largePageKind;
+}
+
+// DoubleEndedStackAllocator
+
+DoubleEndedStackAllocator::DoubleEndedStackAllocator(uint64 totalSize,
+                                                     void *memory, uint32 flags)
+    : _totalSize(totalSize), _lower(0), _upper(totalSize), _memory(memory),
+      _ownsMemory(memory == nullptr), _flags(flags),
+      _largePageKind(platform::LARGE_PAGE_NONE) {
+  if (!memory) {
+    _memory = AllocateStackMemory(totalSize, flags, &_largePageKind);
+  }
+}
+
+DoubleEndedStackAllocator::~DoubleEndedStackAllocator() {
+  if (_memory && _ownsMemory) {
+    FreeStackMemory(_memory, _totalSize, _flags, _largePageKind);
+  }
+
+  _totalSize = 0;
+  _lower = 0;
+  _upper = 0;
+  _ownsMemory = FeFalse;
+  _memory = nullptr;
+}
+
+void *DoubleEndedStackAllocator::AllocateLower(uint64 size, uint64 alignment) {
+  if (!_memory) {
+    FERROR("DoubleEndedStackAllocator::AllocateLower(): Provided allocator not "
+           "initialized!");
+    return nullptr;
+  }
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("DoubleEndedStackAllocator::AllocateLower(): alignment must be a "
+           "power of 2 (got %llu)",
+           alignment);
+    return nullptr;
+  }
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(_memory);
+  uintptr_t alignedAddr = math::AlignUp(base + _lower, alignment);
+  uint64 newLower = (alignedAddr - base) + size;
+
+  if (newLower > _upper) {
+    FERROR("DoubleEndedStackAllocator::AllocateLower(): Tried to allocate "
+           "%lluB, only %lluB remaining",
+           size, GetFreeSize());
+    return nullptr;
+  }
+
+  _lower = newLower;
+  return reinterpret_cast<void *>(alignedAddr);
+}
+
+void *DoubleEndedStackAllocator::AllocateUpper(uint64 size, uint64 alignment) {
+  if (!_memory) {
+    FERROR("DoubleEndedStackAllocator::AllocateUpper(): Provided allocator not "
+           "initialized!");
+    return nullptr;
+  }
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("DoubleEndedStackAllocator::AllocateUpper(): alignment must be a "
+           "power of 2 (got %llu)",
+           alignment);
+    return nullptr;
+  }
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(_memory);
+  if (size > _upper - _lower) {
+    FERROR("DoubleEndedStackAllocator::AllocateUpper(): Tried to allocate "
+           "%lluB, only %lluB remaining",
+           size, GetFreeSize());
+    return nullptr;
+  }
+
+  uintptr_t alignedAddr = AlignBackward(base + _upper - size, alignment);
+  if (alignedAddr < base + _lower) {
+    FERROR("DoubleEndedStackAllocator::AllocateUpper(): Tried to allocate "
+           "%lluB (aligned to %llu), only %lluB remaining",
+           size, alignment, GetFreeSize());
+    return nullptr;
+  }
+
+  _upper = alignedAddr - base;
+  return reinterpret_cast<void *>(alignedAddr);
+}
+
+StackMarker DoubleEndedStackAllocator::GetLowerMarker() const { return _lower; }
+
+StackMarker DoubleEndedStackAllocator::GetUpperMarker() const { return _upper; }
+
+void DoubleEndedStackAllocator::FreeToLowerMarker(StackMarker marker) {
+  if (marker > _lower) {
+    FERROR("DoubleEndedStackAllocator::FreeToLowerMarker(): marker %llu is "
+           "above the lower top (%llu)",
+           marker, _lower);
+    return;
+  }
+
+  core::memory::MemoryManager::InitializeMemory(
+      reinterpret_cast<uchar *>(_memory) + marker, _lower - marker, _flags);
+  _lower = marker;
+}
+
+void DoubleEndedStackAllocator::FreeToUpperMarker(StackMarker marker) {
+  if (marker < _upper || marker > _totalSize) {
+    FERROR("DoubleEndedStackAllocator::FreeToUpperMarker(): marker %llu is "
+           "outside the upper stack [%llu, %llu]",
+           marker, _upper, _totalSize);
+    return;
+  }
+
+  core::memory::MemoryManager::InitializeMemory(
+      reinterpret_cast<uchar *>(_memory) + _upper, marker - _upper, _flags);
+  _upper = marker;
+}
+
+void DoubleEndedStackAllocator::FreeLower() {
+  if (!_memory) {
+    return;
+  }
+
+  FreeToLowerMarker(0);
+}
+
+void DoubleEndedStackAllocator::FreeUpper() {
+  if (!_memory) {
+    return;
+  }
+
+  FreeToUpperMarker(_totalSize);
+}
+
+void DoubleEndedStackAllocator::FreeAll() {
+  FreeLower();
+  FreeUpper();
+}
+
+uint64 DoubleEndedStackAllocator::GetTotalSize() const { return _totalSize; }
+
+uint64 DoubleEndedStackAllocator::GetLowerAllocatedSize() const {
+  return _lower;
+}
+
+uint64 DoubleEndedStackAllocator::GetUpperAllocatedSize() const {
+  return _totalSize - _upper;
+}
+
+uint64 DoubleEndedStackAllocator::GetFreeSize() const {
+  return _upper - _lower;
+}
+
+void *DoubleEndedStackAllocator::GetMemory() const { return _memory; }
+
+platform::LargePageKind DoubleEndedStackAllocator::GetLargePageKind() const {
+  return _largePageKind;
+}
+
+} // namespace memory
+} // namespace flatearth
@@ -0,0 +1,92 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_STACK_ALLOCATOR_HPP
+#define _FLATEARTH_ENGINE_MEMORY_STACK_ALLOCATOR_HPP
+
+#include "Core/FeMemory.hpp"
+#include "Definitions.hpp"
+
+namespace flatearth {
+namespace memory {
+
+// Offset from the start of the block, as returned by GetMarker()
+using StackMarker = uint64;
+
+// Linear allocator that can roll back to a previously taken marker. Freeing
+// to a marker releases everything allocated after it was taken, and applies
+// flags (core::memory::AllocationFlags) to the released range only.
+class StackAllocator {
+public:
+  FEAPI StackAllocator(uint64 totalSize, void *memory,
+                       uint32 flags = core::memory::ALLOCATION_FLAG_ZEROED);
+  FEAPI ~StackAllocator();
+
+  StackAllocator(const StackAllocator &) = delete;
+  StackAllocator &operator=(const StackAllocator &) = delete;
+
+  FEAPI void *Allocate(uint64 size, uint64 alignment = 8);
+
+  FEAPI StackMarker GetMarker() const;
+  FEAPI void FreeToMarker(StackMarker marker);
+  FEAPI void FreeAll();
+
+  FEAPI uint64 GetTotalSize() const;
+  FEAPI uint64 GetAllocatedSize() const;
+  FEAPI void *GetMemory() const;
+  FEAPI platform::LargePageKind GetLargePageKind() const;
+
+private:
+  uint64 _totalSize;
+  uint64 _allocated;
+  void *_memory;
+  bool _ownsMemory;
+  uint32 _flags;
+  platform::LargePageKind _largePageKind;
+};
+
+// Two stacks sharing one block: the lower one grows up from the start and
+// the upper one grows down from the end. Typically the lower end holds long
+// lived data (e.g. a loaded level) and the upper end transient scratch.
+class DoubleEndedStackAllocator {
+public:
+  FEAPI DoubleEndedStackAllocator(
+      uint64 totalSize, void *memory,
+      uint32 flags = core::memory::ALLOCATION_FLAG_ZEROED);
+  FEAPI ~DoubleEndedStackAllocator();
+
+  DoubleEndedStackAllocator(const DoubleEndedStackAllocator &) = delete;
+  DoubleEndedStackAllocator &
+  operator=(const DoubleEndedStackAllocator &) = delete;
+
+  FEAPI void *AllocateLower(uint64 size, uint64 alignment = 8);
+  FEAPI void *AllocateUpper(uint64 size, uint64 alignment = 8);
+
+  FEAPI StackMarker GetLowerMarker() const;
+  FEAPI StackMarker GetUpperMarker() const;
+  FEAPI void FreeToLowerMarker(StackMarker marker);
+  FEAPI void FreeToUpperMarker(StackMarker marker);
+
+  FEAPI void FreeLower();
+  FEAPI void FreeUpper();
+  FEAPI void FreeAll();
+
+  FEAPI uint64 GetTotalSize() const;
+  FEAPI uint64 GetLowerAllocatedSize() const;
+  FEAPI uint64 GetUpperAllocatedSize() const;
+  FEAPI uint64 GetFreeSize() const;
+  FEAPI void *GetMemory() const;
+  FEAPI platform::LargePageKind GetLargePageKind() const;
+
+private:
+  uint64 _totalSize;
+  // Offsets of the lower top (grows up) and upper top (grows down)
+  uint64 _lower;
+  uint64 _upper;
+  void *_memory;
+  bool _ownsMemory;
+  uint32 _flags;
+  platform::LargePageKind _largePageKind;
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_STACK_ALLOCATOR_HPP
@@ -1,7 +1,12 @@
 #ifndef _FLATEARTH_ENGINE_MEMORY_UTILS_HPP
 #define _FLATEARTH_ENGINE_MEMORY_UTILS_HPP
 
+#include "Memory/FrameAllocator.hpp"
 #include "Memory/LinearAllocator.hpp"
+#include "Memory/PoolAllocator.hpp"
+
+#include <new>
+#include <utility>
 
 namespace flatearth {
 namespace memory {
@@ -12,6 +17,38 @@ T *AllocateObject(LinearAllocator &allocator, Args&&... args) {
   return new (mem) T(std::forward<Args>(args)...);
 }
 
+template <typename T, typename... Args>
+T *AllocateObject(FrameAllocator &allocator, Args&&... args) {
+  void *mem = allocator.Allocate(sizeof(T), alignof(T));
+  if (!mem) {
+    return nullptr;
+  }
+  return new (mem) T(std::forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+T *AllocateObject(PoolAllocator &allocator, Args&&... args) {
+  if (sizeof(T) > allocator.GetBlockSize() ||
+      alignof(T) > allocator.GetAlignment()) {
+    return nullptr;
+  }
+
+  void *mem = allocator.Allocate();
+  if (!mem) {
+    return nullptr;
+  }
+  return new (mem) T(std::forward<Args>(args)...);
+}
+
+template <typename T> void FreeObject(PoolAllocator &allocator, T *object) {
+  if (!object) {
+    return;
+  }
+
+  object->~T();
+  allocator.Free(object);
+}
+
 }
 }
 
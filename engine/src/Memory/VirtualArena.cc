@@ -0,0 +1,187 @@
+#include "VirtualArena.hpp"
+
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+#include "Platform/Platform.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace flatearth {
+namespace memory {
+
+// Commit steps are page multiples but not always powers of 2
+FINLINE uint64 RoundUp(uint64 value, uint64 multiple) {
+  return ((value + multiple - 1) / multiple) * multiple;
+}
+
+VirtualArena::VirtualArena(uint64 reserveSize, uint64 commitSize, uint32 flags)
+    : _reservedSize(0), _committedSize(0), _allocated(0), _peak(0),
+      _commitSize(0), _flags(flags), _largePageKind(platform::LARGE_PAGE_NONE),
+      _reservation(nullptr), _reservationSize(0), _memory(nullptr) {
+  if (reserveSize == 0) {
+    FERROR("VirtualArena::VirtualArena(): reserve size must be greater than 0");
+    throw std::invalid_argument("Invalid virtual arena size");
+  }
+
+  bool largePages = flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES;
+  uint64 pageSize = platform::Platform::PGetPageSize();
+  uint64 granularity =
+      largePages ? platform::Platform::PGetLargePageSize() : pageSize;
+  _reservedSize = math::AlignUp(reserveSize, granularity);
+  _commitSize =
+      math::AlignUp(commitSize > 0 ? commitSize : pageSize, granularity);
+
+  // Reserve an extra huge page so the arena can start on a boundary
+  _reservationSize =
+      _reservedSize + (granularity > pageSize ? granularity : 0);
+  _reservation = platform::Platform::PReserveMemory(_reservationSize);
+  if (!_reservation) {
+    throw std::runtime_error("Failed to reserve virtual arena");
+  }
+
+  _memory = reinterpret_cast<uchar *>(
+      math::AlignUp(reinterpret_cast<uintptr_t>(_reservation), granularity));
+
+  if (largePages) {
+    _largePageKind =
+        platform::Platform::PAdviseLargePages(_memory, _reservedSize)
+            ? platform::LARGE_PAGE_TRANSPARENT
+            : platform::LARGE_PAGE_NONE;
+  }
+}
+
+VirtualArena::~VirtualArena() {
+  if (_reservation) {
+    core::memory::MemoryManager::TrackFree(
+        _committedSize, core::memory::MEMORY_TAG_VIRTUAL_ARENA);
+    if (_flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES) {
+      core::memory::MemoryManager::TrackLargePages(_committedSize,
+                                                   _largePageKind, FeFalse);
+    }
+    platform::Platform::PReleaseMemory(_reservation, _reservationSize);
+  }
+
+  _reservation = nullptr;
+  _memory = nullptr;
+  _reservedSize = 0;
+  _reservationSize = 0;
+  _committedSize = 0;
+  _allocated = 0;
+}
+
+void *VirtualArena::Allocate(uint64 size, uint64 alignment) {
+  if (!_memory) {
+    FERROR("VirtualArena::Allocate(): arena not initialized!");
+    return nullptr;
+  }
+
+  if (!math::IsPowerOf2(alignment)) {
+    FERROR("VirtualArena::Allocate(): alignment must be a power of 2 (got "
+           "%llu)",
+           alignment);
+    return nullptr;
+  }
+
+  uintptr_t currentAddr = reinterpret_cast<uintptr_t>(_memory) + _allocated;
+  uintptr_t alignedAddr = math::AlignUp(currentAddr, alignment);
+  uint64 alignedOffset = _allocated + (alignedAddr - currentAddr);
+
+  // Compared against what is left so a huge size cannot wrap the sum
+  if (alignedOffset > _reservedSize || size > _reservedSize - alignedOffset) {
+    FERROR("VirtualArena::Allocate(): Tried to allocate %lluB, only %lluB "
+           "left in the reservation",
+           size, _reservedSize - _allocated);
+    return nullptr;
+  }
+
+  uint64 newAllocated = alignedOffset + size;
+  if (newAllocated > _committedSize && !Commit(newAllocated)) {
+    return nullptr;
+  }
+
+  _allocated = newAllocated;
+  if (_allocated > _peak) {
+    _peak = _allocated;
+  }
+
+  return reinterpret_cast<void *>(alignedAddr);
+}
+
+void VirtualArena::FreeAll() {
+  if (!_memory) {
+    return;
+  }
+
+  core::memory::MemoryManager::InitializeMemory(_memory, _allocated, _flags);
+  _allocated = 0;
+}
+
+void VirtualArena::Decommit(uint64 keepSize) {
+  if (!_memory) {
+    return;
+  }
+
+  uint64 keep = keepSize > _allocated ? keepSize : _allocated;
+  keep = RoundUp(keep, _commitSize);
+  if (keep >= _committedSize) {
+    return;
+  }
+
+  uint64 released = _committedSize - keep;
+  platform::Platform::PDecommitMemory(_memory + keep, released);
+  core::memory::MemoryManager::TrackFree(
+      released, core::memory::MEMORY_TAG_VIRTUAL_ARENA);
+  if (_flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES) {
+    core::memory::MemoryManager::TrackLargePages(released, _largePageKind,
+                                                 FeFalse);
+  }
+  _committedSize = keep;
+}
+
+uint64 VirtualArena::GetReservedSize() const { return _reservedSize; }
+
+uint64 VirtualArena::GetCommittedSize() const { return _committedSize; }
+
+uint64 VirtualArena::GetAllocatedSize() const { return _allocated; }
+
+uint64 VirtualArena::GetPeakSize() const { return _peak; }
+
+void *VirtualArena::GetMemory() const { return _memory; }
+
+platform::LargePageKind VirtualArena::GetLargePageKind() const {
+  return _largePageKind;
+}
+
+// Private members
+
+bool VirtualArena::Commit(uint64 size) {
+  uint64 target = RoundUp(size, _commitSize);
+  if (target > _reservedSize) {
+    target = _reservedSize;
+  }
+
+  uint64 growth = target - _committedSize;
+  if (!platform::Platform::PCommitMemory(_memory + _committedSize, growth)) {
+    FERROR("VirtualArena::Commit(): failed to commit %lluB", growth);
+    return FeFalse;
+  }
+
+  // Fresh pages are already zeroed, only poisoning needs a pass
+  if (_flags & core::memory::ALLOCATION_FLAG_POISONED) {
+    core::memory::MemoryManager::InitializeMemory(_memory + _committedSize,
+                                                  growth, _flags);
+  }
+
+  core::memory::MemoryManager::TrackAllocation(
+      growth, core::memory::MEMORY_TAG_VIRTUAL_ARENA);
+  if (_flags & core::memory::ALLOCATION_FLAG_LARGE_PAGES) {
+    core::memory::MemoryManager::TrackLargePages(growth, _largePageKind,
+                                                 FeTrue);
+  }
+  _committedSize = target;
+  return FeTrue;
+}
+
+} // namespace memory
+} // namespace flatearth
@@ -0,0 +1,64 @@
+#ifndef _FLATEARTH_ENGINE_MEMORY_VIRTUAL_ARENA_HPP
+#define _FLATEARTH_ENGINE_MEMORY_VIRTUAL_ARENA_HPP
+
+#include "Core/FeMemory.hpp"
+#include "Definitions.hpp"
+
+namespace flatearth {
+namespace memory {
+
+// Linear allocator over a reserved virtual address range. Pages are committed
+// in commitSize steps as the bump pointer moves forward, so only memory that
+// was actually reached costs physical pages, and returned pointers never move.
+// Committed pages above a high-water mark can be handed back with Decommit().
+// With ALLOCATION_FLAG_LARGE_PAGES the range is huge page aligned, commits
+// happen in whole huge pages and the kernel is asked to back them with
+// transparent huge pages.
+class VirtualArena {
+public:
+  static constexpr uint64 VIRTUAL_ARENA_DEFAULT_COMMIT_SIZE = 64 * 1024;
+
+  // commitSize is rounded up to the platform (or huge) page size
+  FEAPI VirtualArena(uint64 reserveSize,
+                     uint64 commitSize = VIRTUAL_ARENA_DEFAULT_COMMIT_SIZE,
+                     uint32 flags = core::memory::ALLOCATION_FLAG_ZEROED);
+  FEAPI ~VirtualArena();
+
+  VirtualArena(const VirtualArena &) = delete;
+  VirtualArena &operator=(const VirtualArena &) = delete;
+
+  FEAPI void *Allocate(uint64 size, uint64 alignment = 8);
+  FEAPI void FreeAll();
+
+  // Decommits every page above max(keepSize, GetAllocatedSize())
+  FEAPI void Decommit(uint64 keepSize = 0);
+
+  FEAPI uint64 GetReservedSize() const;
+  FEAPI uint64 GetCommittedSize() const;
+  FEAPI uint64 GetAllocatedSize() const;
+  // Highest allocated size reached since creation
+  FEAPI uint64 GetPeakSize() const;
+  FEAPI void *GetMemory() const;
+  FEAPI platform::LargePageKind GetLargePageKind() const;
+
+private:
+  bool Commit(uint64 size);
+
+  uint64 _reservedSize;
+  uint64 _committedSize;
+  uint64 _allocated;
+  uint64 _peak;
+  uint64 _commitSize;
+  uint32 _flags;
+  platform::LargePageKind _largePageKind;
+
+  // Start of the reservation, _memory may sit past it to be huge page aligned
+  void *_reservation;
+  uint64 _reservationSize;
+  uchar *_memory;
+};
+
+} // namespace memory
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_MEMORY_VIRTUAL_ARENA_HPP
@@ -6,10 +6,22 @@
 namespace flatearth {
 namespace platform {
 
+// What actually backs a large page allocation
+enum LargePageKind : uchar {
+  // Regular pages, the platform refused every huge page option
+  LARGE_PAGE_NONE,
+  // Transparent huge pages were requested (Linux MADV_HUGEPAGE), the kernel
+  // promotes aligned ranges when it can
+  LARGE_PAGE_TRANSPARENT,
+  // Explicitly reserved huge pages (Linux MAP_HUGETLB, Windows MEM_LARGE_PAGES)
+  LARGE_PAGE_EXPLICIT,
+  LARGE_PAGE_MAX_KINDS,
+};
+
 struct PlatformState {
   unique_void_ptr internalState;
 
-  PlatformState() : internalState(nullptr, [](const void *) {}) {}
+  PlatformState() : internalState(nullptr, VoidDeleter{}) {}
 };
 
 class Platform {
@@ -20,13 +32,41 @@ public:
 
   bool PollEvents();
 
-  static void *PAllocateMemory(uint64 size, bool aligned);
-  static void PFreeMemory(void *block, bool aligned);
+  // Alignments at or below alignof(std::max_align_t) use the plain allocator,
+  // anything stricter goes through the platform's aligned allocator. Blocks
+  // must be freed with the same alignment they were allocated with.
+  static void *PAllocateMemory(uint64 size, uint64 alignment);
+  static void PFreeMemory(void *block, uint64 alignment);
+  // Resizes a PAllocateMemory block keeping its contents, large blocks are
+  // usually remapped instead of copied. Returns nullptr and leaves the block
+  // untouched when it can't be done, e.g. for over-aligned blocks on Linux
+  static void *PReallocateMemory(void *block, uint64 size, uint64 alignment);
   static void *PZeroMemory(void *block, uint64 size);
   static void *PCopyMemory(void *dest, const void *source, uint64 size);
   static void *PSetMemory(void *dest, sint32 value, uint64 size);
-  static void ConsoleWrite(const string &message, uchar color);
-  static void ConsoleError(const string &message, uchar color);
+
+  // Virtual memory. A reserved range only claims address space, pages must be
+  // committed before being touched. Sizes and addresses passed to commit and
+  // decommit must be multiples of PGetPageSize(). Committed pages read as zero
+  // until written, including after a decommit/commit cycle.
+  static uint64 PGetPageSize();
+  static void *PReserveMemory(uint64 size);
+  static bool PCommitMemory(void *block, uint64 size);
+  static void PDecommitMemory(void *block, uint64 size);
+  static void PReleaseMemory(void *block, uint64 size);
+
+  // Large page allocation for big long-lived arenas. The block is committed,
+  // zeroed and page aligned (huge page aligned whenever huge pages back it),
+  // and must be freed with PFreeLargePages() using the same size. kind
+  // reports what was obtained.
+  static uint64 PGetLargePageSize();
+  static void *PAllocateLargePages(uint64 size, LargePageKind *kind);
+  static void PFreeLargePages(void *block, uint64 size);
+  // Hints that a reserved range should be backed by huge pages once
+  // committed. Returns FeFalse when the platform does not support it
+  static bool PAdviseLargePages(void *block, uint64 size);
+  static void ConsoleWrite(vstring message, uchar color);
+  static void ConsoleError(vstring message, uchar color);
   static float64 GetAbsoluteTime();
   static void Sleep(uint64 milliseconds);
 
@@ -13,10 +13,15 @@
 #include <X11/Xlib-xcb.h>
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <print>
 #include <stdexcept>
+#include <sys/mman.h>
 #include <xcb/xcb.h>
 #include <xcb/xproto.h>
 
@@ -255,12 +260,37 @@ bool Platform::PollEvents() {
   return !quitFlag;
 }
 
-void *Platform::PAllocateMemory(uint64 size, bool aligned) {
-  // TODO: alignment
-  return malloc(size);
+void *Platform::PAllocateMemory(uint64 size, uint64 alignment) {
+  // malloc already guarantees the fundamental alignment
+  if (alignment <= alignof(std::max_align_t)) {
+    return malloc(size);
+  }
+
+  void *block = nullptr;
+  if (posix_memalign(&block, alignment, size) != 0) {
+    FERROR("Platform::PAllocateMemory(): posix_memalign failed for %lluB "
+           "aligned to %lluB",
+           size, alignment);
+    return nullptr;
+  }
+
+  return block;
 }
 
-void Platform::PFreeMemory(void *block, bool aligned) { free(block); }
+void Platform::PFreeMemory(void *block, [[maybe_unused]] uint64 alignment) {
+  // glibc free() releases both malloc and posix_memalign blocks
+  free(block);
+}
+
+void *Platform::PReallocateMemory(void *block, uint64 size, uint64 alignment) {
+  // realloc() does not keep posix_memalign alignments. glibc serves large
+  // blocks with mmap and grows them with mremap, without copying
+  if (alignment > alignof(std::max_align_t)) {
+    return nullptr;
+  }
+
+  return realloc(block, size);
+}
 
 void *Platform::PZeroMemory(void *block, uint64 size) {
   return memset(block, 0, size);
@@ -274,13 +304,131 @@ void *Platform::PSetMemory(void *dest, sint32 value, uint64 size) {
   return memset(dest, value, size);
 }
 
-void Platform::ConsoleWrite(const string &message, uchar color) {
+uint64 Platform::PGetPageSize() {
+  static const uint64 pageSize = (uint64)sysconf(_SC_PAGESIZE);
+  return pageSize;
+}
+
+void *Platform::PReserveMemory(uint64 size) {
+  // MAP_NORESERVE keeps large reservations from counting against overcommit
+  void *block = mmap(nullptr, size, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (block == MAP_FAILED) {
+    FERROR("Platform::PReserveMemory(): failed to reserve %lluB", size);
+    return nullptr;
+  }
+
+  return block;
+}
+
+bool Platform::PCommitMemory(void *block, uint64 size) {
+  if (mprotect(block, size, PROT_READ | PROT_WRITE) != 0) {
+    FERROR("Platform::PCommitMemory(): failed to commit %lluB at %p", size,
+           block);
+    return FeFalse;
+  }
+
+  return FeTrue;
+}
+
+void Platform::PDecommitMemory(void *block, uint64 size) {
+  // Drops the physical pages, the next touch after a commit maps zero pages
+  madvise(block, size, MADV_DONTNEED);
+  mprotect(block, size, PROT_NONE);
+}
+
+void Platform::PReleaseMemory(void *block, uint64 size) {
+  if (block) {
+    munmap(block, size);
+  }
+}
+
+// Default huge page size on x86_64 and most aarch64 kernels
+constexpr uint64 LINUX_DEFAULT_HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static uint64 ReadHugePageSize() {
+  FILE *meminfo = fopen("/proc/meminfo", "r");
+  if (!meminfo) {
+    return LINUX_DEFAULT_HUGE_PAGE_SIZE;
+  }
+
+  uint64 sizeKb = 0;
+  char line[128];
+  while (fgets(line, sizeof(line), meminfo)) {
+    if (sscanf(line, "Hugepagesize: %llu kB", &sizeKb) == 1) {
+      break;
+    }
+  }
+  fclose(meminfo);
+
+  return sizeKb > 0 ? sizeKb * 1024 : LINUX_DEFAULT_HUGE_PAGE_SIZE;
+}
+
+uint64 Platform::PGetLargePageSize() {
+  static const uint64 largePageSize = ReadHugePageSize();
+  return largePageSize;
+}
+
+void *Platform::PAllocateLargePages(uint64 size, LargePageKind *kind) {
+  uint64 pageSize = PGetLargePageSize();
+  uint64 roundedSize = (size + pageSize - 1) & ~(pageSize - 1);
+
+  // Explicit huge pages only succeed when the admin reserved a pool
+  void *block = mmap(nullptr, roundedSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (block != MAP_FAILED) {
+    *kind = LARGE_PAGE_EXPLICIT;
+    return block;
+  }
+
+  // Transparent huge pages only back huge page aligned ranges, so over-map and
+  // trim both ends to land on a boundary
+  uint64 mappedSize = roundedSize + pageSize;
+  uchar *raw = reinterpret_cast<uchar *>(
+      mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  if (raw == MAP_FAILED) {
+    FERROR("Platform::PAllocateLargePages(): failed to map %lluB", size);
+    *kind = LARGE_PAGE_NONE;
+    return nullptr;
+  }
+
+  uchar *aligned = reinterpret_cast<uchar *>(
+      (reinterpret_cast<uintptr_t>(raw) + pageSize - 1) & ~(pageSize - 1));
+  uint64 head = aligned - raw;
+  uint64 tail = mappedSize - head - roundedSize;
+  if (head > 0) {
+    munmap(raw, head);
+  }
+  if (tail > 0) {
+    munmap(aligned + roundedSize, tail);
+  }
+
+  *kind = PAdviseLargePages(aligned, roundedSize) ? LARGE_PAGE_TRANSPARENT
+                                                  : LARGE_PAGE_NONE;
+  return aligned;
+}
+
+void Platform::PFreeLargePages(void *block, uint64 size) {
+  if (!block) {
+    return;
+  }
+
+  uint64 pageSize = PGetLargePageSize();
+  munmap(block, (size + pageSize - 1) & ~(pageSize - 1));
+}
+
+bool Platform::PAdviseLargePages(void *block, uint64 size) {
+  return madvise(block, size, MADV_HUGEPAGE) == 0;
+}
+
+void Platform::ConsoleWrite(vstring message, uchar color) {
   // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
   const char *colorStrings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
   std::println("\033[{0}m{1}\033[0m", colorStrings[color], message);
 }
 
-void Platform::ConsoleError(const string &message, uchar color) {
+void Platform::ConsoleError(vstring message, uchar color) {
   // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
   const char *colorStrings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
   std::println("\033[{0}m{1}\033[0m", colorStrings[color], message);
@@ -4,7 +4,10 @@
 #include "Core/Input.hpp"
 #include "Core/Logger.hpp"
 
+#include <cstddef>
+#include <cstdlib>
 #include <cstring>
+#include <malloc.h>
 #include <stdexcept>
 #include <windows.h>
 #include <windowsx.h>
@@ -134,12 +137,32 @@ bool Platform::PollEvents() {
   return FeFalse;
 }
 
-void *Platform::PAllocateMemory(uint64 size, bool aligned) {
-  // TODO: alignment
-  return malloc(size);
+void *Platform::PAllocateMemory(uint64 size, uint64 alignment) {
+  // malloc already guarantees the fundamental alignment
+  if (alignment <= alignof(std::max_align_t)) {
+    return malloc(size);
+  }
+
+  return _aligned_malloc(size, alignment);
+}
+
+void Platform::PFreeMemory(void *block, uint64 alignment) {
+  // _aligned_malloc blocks must be released with _aligned_free
+  if (alignment <= alignof(std::max_align_t)) {
+    free(block);
+    return;
+  }
+
+  _aligned_free(block);
 }
 
-void Platform::PFreeMemory(void *block, bool aligned) { free(block); }
+void *Platform::PReallocateMemory(void *block, uint64 size, uint64 alignment) {
+  if (alignment <= alignof(std::max_align_t)) {
+    return realloc(block, size);
+  }
+
+  return _aligned_realloc(block, size, alignment);
+}
 
 void *Platform::PZeroMemory(void *block, uint64 size) {
   return memset(block, 0, size);
@@ -153,30 +176,149 @@ void *Platform::PSetMemory(void *dest, sint32 value, uint64 size) {
   return memset(dest, value, size);
 }
 
-void Platform::ConsoleWrite(const string &message, uchar color) {
-  HANDLE consoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
-  // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
-  static uchar levels[6] = {64, 4, 6, 2, 1, 8};
-  string sOut = message + "\n";
-  SetConsoleTextAttribute(consoleHandle, levels[color]);
-  OutputDebugStringA(sOut.c_str());
-  uint64 length = (uint64)sOut.length();
-  LPDWORD numberWritten = 0;
-  WriteConsoleA(GetStdHandle(STD_OUTPUT_HANDLE), sOut.c_str(), (DWORD)length,
-                numberWritten, 0);
+uint64 Platform::PGetPageSize() {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (uint64)info.dwPageSize;
+}
+
+void *Platform::PReserveMemory(uint64 size) {
+  void *block = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+  if (!block) {
+    FERROR("Platform::PReserveMemory(): failed to reserve %lluB", size);
+  }
+
+  return block;
+}
+
+bool Platform::PCommitMemory(void *block, uint64 size) {
+  if (!VirtualAlloc(block, size, MEM_COMMIT, PAGE_READWRITE)) {
+    FERROR("Platform::PCommitMemory(): failed to commit %lluB at %p", size,
+           block);
+    return FeFalse;
+  }
+
+  return FeTrue;
+}
+
+void Platform::PDecommitMemory(void *block, uint64 size) {
+  VirtualFree(block, size, MEM_DECOMMIT);
+}
+
+void Platform::PReleaseMemory(void *block, uint64 size) {
+  // MEM_RELEASE requires a size of 0 and frees the whole reservation
+  if (block) {
+    VirtualFree(block, 0, MEM_RELEASE);
+  }
+}
+
+uint64 Platform::PGetLargePageSize() {
+  // 0 when large pages are not supported at all
+  uint64 largePageSize = (uint64)GetLargePageMinimum();
+  return largePageSize > 0 ? largePageSize : PGetPageSize();
 }
 
-void Platform::ConsoleError(const string &message, uchar color) {
-  HANDLE consoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
+// MEM_LARGE_PAGES needs SeLockMemoryPrivilege enabled in the process token.
+// Most accounts do not hold it, and those that do still have it disabled
+static bool EnableLockMemoryPrivilege() {
+  HANDLE token = nullptr;
+  if (!OpenProcessToken(GetCurrentProcess(),
+                        TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token)) {
+    FWARN("Platform::PAllocateLargePages(): failed to open the process "
+          "token, using regular pages");
+    return FeFalse;
+  }
+
+  TOKEN_PRIVILEGES privileges = {};
+  privileges.PrivilegeCount = 1;
+  privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+  bool enabled =
+      LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME,
+                           &privileges.Privileges[0].Luid) &&
+      AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr) &&
+      GetLastError() != ERROR_NOT_ALL_ASSIGNED;
+  CloseHandle(token);
+
+  if (!enabled) {
+    FWARN("Platform::PAllocateLargePages(): SeLockMemoryPrivilege is not "
+          "held, using regular pages");
+  }
+
+  return enabled;
+}
+
+void *Platform::PAllocateLargePages(uint64 size, LargePageKind *kind) {
+  uint64 pageSize = PGetLargePageSize();
+  uint64 roundedSize = (size + pageSize - 1) & ~(pageSize - 1);
+
+  // Enabled once, the token keeps the privilege for the process lifetime
+  static const bool lockMemoryPrivilege =
+      GetLargePageMinimum() > 0 && EnableLockMemoryPrivilege();
+  if (lockMemoryPrivilege) {
+    void *block =
+        VirtualAlloc(nullptr, roundedSize,
+                     MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                     PAGE_READWRITE);
+    if (block) {
+      *kind = LARGE_PAGE_EXPLICIT;
+      return block;
+    }
+  }
+
+  *kind = LARGE_PAGE_NONE;
+  void *block = VirtualAlloc(nullptr, roundedSize, MEM_RESERVE | MEM_COMMIT,
+                             PAGE_READWRITE);
+  if (!block) {
+    FERROR("Platform::PAllocateLargePages(): failed to allocate %lluB", size);
+  }
+
+  return block;
+}
+
+void Platform::PFreeLargePages(void *block, [[maybe_unused]] uint64 size) {
+  if (block) {
+    VirtualFree(block, 0, MEM_RELEASE);
+  }
+}
+
+bool Platform::PAdviseLargePages([[maybe_unused]] void *block,
+                                 [[maybe_unused]] uint64 size) {
+  // No transparent huge pages on Windows
+  return FeFalse;
+}
+
+// Pieces of the message handed to OutputDebugStringA, which needs them null
+// terminated
+constexpr uint64 WIN32_DEBUG_OUTPUT_CHUNK = 512;
+
+// Writes the message and a newline without copying it to the heap
+static void WriteConsoleLine(HANDLE consoleHandle, vstring message,
+                             uchar color) {
   // FATAL, ERROR, WARN, INFO, DEBUG, TRACE
   static uchar levels[6] = {64, 4, 6, 2, 1, 8};
-  string sOut = message + "\n";
   SetConsoleTextAttribute(consoleHandle, levels[color]);
-  OutputDebugStringA(sOut.c_str());
-  uint64 length = (uint64)sOut.length();
-  LPDWORD numberWritten = 0;
-  WriteConsoleA(GetStdHandle(STD_OUTPUT_HANDLE), sOut.c_str(), (DWORD)length,
-                numberWritten, 0);
+
+  char chunk[WIN32_DEBUG_OUTPUT_CHUNK];
+  for (uint64 offset = 0; offset < message.size();
+       offset += sizeof(chunk) - 1) {
+    vstring piece = message.substr(offset, sizeof(chunk) - 1);
+    memcpy(chunk, piece.data(), piece.size());
+    chunk[piece.size()] = '\0';
+    OutputDebugStringA(chunk);
+  }
+  OutputDebugStringA("\n");
+
+  WriteConsoleA(consoleHandle, message.data(), (DWORD)message.size(), nullptr,
+                nullptr);
+  WriteConsoleA(consoleHandle, "\n", 1, nullptr, nullptr);
+}
+
+void Platform::ConsoleWrite(vstring message, uchar color) {
+  WriteConsoleLine(GetStdHandle(STD_OUTPUT_HANDLE), message, color);
+}
+
+void Platform::ConsoleError(vstring message, uchar color) {
+  WriteConsoleLine(GetStdHandle(STD_OUTPUT_HANDLE), message, color);
 }
 
 float64 Platform::GetAbsoluteTime() {
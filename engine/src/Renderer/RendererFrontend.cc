@@ -83,7 +83,8 @@ void FrontendRenderer::CreateBackends(
     core::memory::unique_stateful_renderer_ptr<IRendererBackend> (
         &backends)[MAX_BACKENDS]) {
   void *allocatedMemory = core::memory::MemoryManager::Allocate(
-      sizeof(vulkan::VulkanBackend), core::memory::MEMORY_TAG_RENDERER);
+      sizeof(vulkan::VulkanBackend), alignof(vulkan::VulkanBackend),
+      core::memory::MEMORY_TAG_RENDERER);
 
   if (allocatedMemory) {
     backends[RendererBackendType::RENDERER_BACKEND_TYPE_VULKAN] =
@@ -91,7 +92,8 @@ void FrontendRenderer::CreateBackends(
             new (allocatedMemory) vulkan::VulkanBackend(),
             core::memory::StatefulCustomDeleter<IRendererBackend>(
                 sizeof(vulkan::VulkanBackend),
-                core::memory::MEMORY_TAG_RENDERER));
+                core::memory::MEMORY_TAG_RENDERER,
+                alignof(vulkan::VulkanBackend)));
   }
 }
 
@@ -0,0 +1,228 @@
+#include "VulkanAllocator.hpp"
+
+#include "Core/FeMemory.hpp"
+#include "Core/Logger.hpp"
+#include "Math/FeMath.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace flatearth {
+namespace renderer {
+namespace vulkan {
+
+// Sits right before every block handed to the driver
+struct VulkanAllocator::BlockHeader {
+  uint64 size;
+  uint32 alignment;
+  uchar scope;
+  bool fromArena;
+};
+
+static void *AllocateCommandArena(uint64 size) {
+  void *memory = core::memory::MemoryManager::Allocate(
+      size, core::memory::MEMORY_CACHE_LINE_SIZE,
+      core::memory::MEMORY_TAG_RENDERER,
+      core::memory::ALLOCATION_FLAG_UNINITIALIZED);
+  if (!memory) {
+    throw std::runtime_error("Failed to allocate the Vulkan command arena");
+  }
+
+  return memory;
+}
+
+VulkanAllocator::VulkanAllocator(uint64 commandArenaSize)
+    : _callbacks({}),
+      _commandArenaMemory(AllocateCommandArena(commandArenaSize)),
+      _commandArenaSize(commandArenaSize),
+      _commandArena(commandArenaSize, _commandArenaMemory,
+                    core::memory::ALLOCATION_FLAG_UNINITIALIZED),
+      _commandArenaLive(0), _scopeAllocated(), _scopeCounts(),
+      _internalAllocated(0), _commandArenaFallbacks(0) {
+  _callbacks.pUserData = this;
+  _callbacks.pfnAllocation = Allocation;
+  _callbacks.pfnReallocation = Reallocation;
+  _callbacks.pfnFree = Free;
+  _callbacks.pfnInternalAllocation = InternalAllocation;
+  _callbacks.pfnInternalFree = InternalFree;
+}
+
+VulkanAllocator::~VulkanAllocator() {
+  if (_commandArenaLive > 0) {
+    FWARN("VulkanAllocator::~VulkanAllocator(): %llu command scoped blocks "
+          "were never freed",
+          _commandArenaLive);
+  }
+
+  core::memory::MemoryManager::Free(
+      _commandArenaMemory, _commandArenaSize,
+      core::memory::MEMORY_CACHE_LINE_SIZE, core::memory::MEMORY_TAG_RENDERER);
+  _commandArenaMemory = nullptr;
+}
+
+VkAllocationCallbacks *VulkanAllocator::GetCallbacks() { return &_callbacks; }
+
+uint64 VulkanAllocator::GetAllocatedSize(VkSystemAllocationScope scope) const {
+  return _scopeAllocated[scope].load(std::memory_order_relaxed);
+}
+
+uint64
+VulkanAllocator::GetAllocationCount(VkSystemAllocationScope scope) const {
+  return _scopeCounts[scope].load(std::memory_order_relaxed);
+}
+
+uint64 VulkanAllocator::GetInternalAllocatedSize() const {
+  return _internalAllocated.load(std::memory_order_relaxed);
+}
+
+uint64 VulkanAllocator::GetCommandArenaFallbackCount() const {
+  return _commandArenaFallbacks.load(std::memory_order_relaxed);
+}
+
+// Private members
+
+void *VulkanAllocator::Allocation(void *userData, size_t size,
+                                  size_t alignment,
+                                  VkSystemAllocationScope scope) {
+  VulkanAllocator *allocator = static_cast<VulkanAllocator *>(userData);
+  return allocator->AllocateBlock(size, alignment, scope);
+}
+
+void *VulkanAllocator::Reallocation(void *userData, void *original,
+                                    size_t size, size_t alignment,
+                                    VkSystemAllocationScope scope) {
+  VulkanAllocator *allocator = static_cast<VulkanAllocator *>(userData);
+  if (!original) {
+    return allocator->AllocateBlock(size, alignment, scope);
+  }
+
+  if (size == 0) {
+    allocator->FreeBlock(original);
+    return nullptr;
+  }
+
+  // On failure the original block must be left untouched
+  void *block = allocator->AllocateBlock(size, alignment, scope);
+  if (!block) {
+    return nullptr;
+  }
+
+  const BlockHeader *header = static_cast<const BlockHeader *>(original) - 1;
+  core::memory::MemoryManager::CopyMemory(block, original,
+                                          std::min<uint64>(header->size, size));
+  allocator->FreeBlock(original);
+  return block;
+}
+
+void VulkanAllocator::Free(void *userData, void *memory) {
+  if (!memory) {
+    return;
+  }
+
+  static_cast<VulkanAllocator *>(userData)->FreeBlock(memory);
+}
+
+void VulkanAllocator::InternalAllocation(void *userData, size_t size,
+                                         VkInternalAllocationType,
+                                         VkSystemAllocationScope) {
+  VulkanAllocator *allocator = static_cast<VulkanAllocator *>(userData);
+  allocator->_internalAllocated.fetch_add(size, std::memory_order_relaxed);
+  core::memory::MemoryManager::TrackAllocation(
+      size, core::memory::MEMORY_TAG_RENDERER);
+}
+
+void VulkanAllocator::InternalFree(void *userData, size_t size,
+                                   VkInternalAllocationType,
+                                   VkSystemAllocationScope) {
+  VulkanAllocator *allocator = static_cast<VulkanAllocator *>(userData);
+  allocator->_internalAllocated.fetch_sub(size, std::memory_order_relaxed);
+  core::memory::MemoryManager::TrackFree(size,
+                                         core::memory::MEMORY_TAG_RENDERER);
+}
+
+void *VulkanAllocator::AllocateBlock(uint64 size, uint64 alignment,
+                                     VkSystemAllocationScope scope) {
+  if (size == 0 || scope >= VULKAN_ALLOCATION_SCOPE_COUNT) {
+    return nullptr;
+  }
+
+  // The header must fit in front of the block without breaking its alignment
+  alignment = std::max<uint64>(alignment, sizeof(BlockHeader));
+  uint64 offset = math::AlignUp(sizeof(BlockHeader), alignment);
+  uint64 totalSize = offset + size;
+
+  bool fromArena = FeFalse;
+  void *base = nullptr;
+  if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND) {
+    base = AllocateFromArena(totalSize, alignment);
+    fromArena = base != nullptr;
+    if (!fromArena) {
+      _commandArenaFallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  if (!base) {
+    // Drivers initialize what they use
+    base = core::memory::MemoryManager::Allocate(
+        totalSize, alignment, core::memory::MEMORY_TAG_RENDERER,
+        core::memory::ALLOCATION_FLAG_UNINITIALIZED);
+    if (!base) {
+      return nullptr;
+    }
+  }
+
+  uchar *block = static_cast<uchar *>(base) + offset;
+  BlockHeader *header = reinterpret_cast<BlockHeader *>(block) - 1;
+  header->size = size;
+  header->alignment = (uint32)alignment;
+  header->scope = (uchar)scope;
+  header->fromArena = fromArena;
+
+  _scopeAllocated[scope].fetch_add(size, std::memory_order_relaxed);
+  _scopeCounts[scope].fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+void *VulkanAllocator::AllocateFromArena(uint64 totalSize, uint64 alignment) {
+  std::lock_guard<std::mutex> lock(_commandArenaMutex);
+
+  // Checked up front, the arena logs an error when it runs out
+  uint64 used = _commandArena.GetAllocatedSize();
+  if (used + totalSize + alignment > _commandArena.GetTotalSize()) {
+    return nullptr;
+  }
+
+  void *base = _commandArena.Allocate(totalSize, alignment);
+  if (base) {
+    _commandArenaLive++;
+  }
+
+  return base;
+}
+
+void VulkanAllocator::FreeBlock(void *memory) {
+  BlockHeader *header = static_cast<BlockHeader *>(memory) - 1;
+  uint64 size = header->size;
+  uint64 alignment = header->alignment;
+  uchar scope = header->scope;
+
+  _scopeAllocated[scope].fetch_sub(size, std::memory_order_relaxed);
+  _scopeCounts[scope].fetch_sub(1, std::memory_order_relaxed);
+
+  if (header->fromArena) {
+    std::lock_guard<std::mutex> lock(_commandArenaMutex);
+    if (--_commandArenaLive == 0) {
+      _commandArena.FreeAll();
+    }
+    return;
+  }
+
+  uint64 offset = math::AlignUp(sizeof(BlockHeader), alignment);
+  core::memory::MemoryManager::Free(static_cast<uchar *>(memory) - offset,
+                                    offset + size, alignment,
+                                    core::memory::MEMORY_TAG_RENDERER);
+}
+
+} // namespace vulkan
+} // namespace renderer
+} // namespace flatearth
@@ -0,0 +1,88 @@
+#ifndef _FLATEARTH_ENGINE_VULKAN_ALLOCATOR_HPP
+#define _FLATEARTH_ENGINE_VULKAN_ALLOCATOR_HPP
+
+#include "Definitions.hpp"
+#include "Memory/StackAllocator.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vulkan/vulkan_core.h>
+
+namespace flatearth {
+namespace renderer {
+namespace vulkan {
+
+// Size of the arena serving VK_SYSTEM_ALLOCATION_SCOPE_COMMAND allocations
+constexpr uint64 VULKAN_COMMAND_ARENA_SIZE = 256 * 1024;
+
+constexpr uint64 VULKAN_ALLOCATION_SCOPE_COUNT =
+    VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE + 1;
+
+// Host allocation callbacks handed to the driver. Every block is tagged
+// MEMORY_TAG_RENDERER and counted per allocation scope. Command scoped
+// blocks only live for the duration of a single Vulkan call, so they are
+// bumped out of a stack arena that is rewound once all of them are freed;
+// when the arena is full they fall back to the MemoryManager.
+class VulkanAllocator {
+public:
+  VulkanAllocator(uint64 commandArenaSize = VULKAN_COMMAND_ARENA_SIZE);
+  ~VulkanAllocator();
+
+  VulkanAllocator(const VulkanAllocator &) = delete;
+  VulkanAllocator &operator=(const VulkanAllocator &) = delete;
+
+  // Stays valid for the lifetime of the allocator
+  VkAllocationCallbacks *GetCallbacks();
+
+  uint64 GetAllocatedSize(VkSystemAllocationScope scope) const;
+  uint64 GetAllocationCount(VkSystemAllocationScope scope) const;
+  // Memory the driver allocated on its own and reported to us
+  uint64 GetInternalAllocatedSize() const;
+  // Command scoped allocations that did not fit in the arena
+  uint64 GetCommandArenaFallbackCount() const;
+
+private:
+  struct BlockHeader;
+
+  static VKAPI_ATTR void *VKAPI_CALL
+  Allocation(void *userData, size_t size, size_t alignment,
+             VkSystemAllocationScope scope);
+  static VKAPI_ATTR void *VKAPI_CALL
+  Reallocation(void *userData, void *original, size_t size, size_t alignment,
+               VkSystemAllocationScope scope);
+  static VKAPI_ATTR void VKAPI_CALL Free(void *userData, void *memory);
+  static VKAPI_ATTR void VKAPI_CALL
+  InternalAllocation(void *userData, size_t size,
+                     VkInternalAllocationType type,
+                     VkSystemAllocationScope scope);
+  static VKAPI_ATTR void VKAPI_CALL
+  InternalFree(void *userData, size_t size, VkInternalAllocationType type,
+               VkSystemAllocationScope scope);
+
+  void *AllocateBlock(uint64 size, uint64 alignment,
+                      VkSystemAllocationScope scope);
+  void *AllocateFromArena(uint64 totalSize, uint64 alignment);
+  void FreeBlock(void *memory);
+
+  VkAllocationCallbacks _callbacks;
+
+  void *_commandArenaMemory;
+  uint64 _commandArenaSize;
+  memory::StackAllocator _commandArena;
+  std::mutex _commandArenaMutex;
+  // Arena blocks not freed yet, the arena is rewound when it drops to 0
+  uint64 _commandArenaLive;
+
+  std::array<std::atomic<uint64>, VULKAN_ALLOCATION_SCOPE_COUNT>
+      _scopeAllocated;
+  std::array<std::atomic<uint64>, VULKAN_ALLOCATION_SCOPE_COUNT> _scopeCounts;
+  std::atomic<uint64> _internalAllocated;
+  std::atomic<uint64> _commandArenaFallbacks;
+};
+
+} // namespace vulkan
+} // namespace renderer
+} // namespace flatearth
+
+#endif // _FLATEARTH_ENGINE_VULKAN_ALLOCATOR_HPP
@@ -33,8 +33,8 @@ VulkanBackend::~VulkanBackend() {
 
 bool VulkanBackend::Initialize(const char *applicationName,
                                struct platform::PlatformState *platState) {
-  // TODO: custom allocator
-  _context.allocator = nullptr;
+  // Driver host allocations go through the MemoryManager
+  _context.allocator = _hostAllocator.GetCallbacks();
 
   core::application::App::GetFrameBufferSize(&cachedFrameBufferWidth,
                                              &cachedFrameBufferHeight);
@@ -90,7 +90,7 @@ bool VulkanBackend::Initialize(const char *applicationName,
   uint32 availableLayerCount = 0;
   VK_CHECK(vkEnumerateInstanceLayerProperties(&availableLayerCount, nullptr));
   containers::DArray<VkLayerProperties> availableLayers;
-  availableLayers.Reserve(availableLayerCount);
+  availableLayers.SetLength(availableLayerCount);
   VK_CHECK(vkEnumerateInstanceLayerProperties(&availableLayerCount,
                                               availableLayers.Data()));
 
@@ -179,7 +179,7 @@ bool VulkanBackend::Initialize(const char *applicationName,
 
   // Framebuffer creation
   FDEBUG("VulkanBackend::Initialize(): Regenerating framebuffers...");
-  _context.swapchain.framebuffers.Reserve(_context.swapchain.imageCount);
+  _context.swapchain.framebuffers.SetLength(_context.swapchain.imageCount);
   FrameBufferRegenerate(&_context.swapchain, &_context.mainRenderPass);
   FINFO("VulkanBackend::Initialize(): Framebuffers regenerated successfully");
 
@@ -189,9 +189,9 @@ bool VulkanBackend::Initialize(const char *applicationName,
 
   // Sync object creation
   FDEBUG("VulkanBackend::Initialize(): Creating sync objects & fences...");
-  _context.imageAvailableSemaphores.Reserve(_context.swapchain.imageCount);
-  _context.queueCompleteSemaphores.Reserve(_context.swapchain.imageCount);
-  _context.inFlightFences.Reserve(_context.swapchain.imageCount);
+  _context.imageAvailableSemaphores.SetLength(_context.swapchain.imageCount);
+  _context.queueCompleteSemaphores.SetLength(_context.swapchain.imageCount);
+  _context.inFlightFences.SetLength(_context.swapchain.imageCount);
   for (uint32 i = 0; i < _context.swapchain.imageCount; i++) {
     VkSemaphoreCreateInfo semaphoreCreateInfo = {};
     semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -210,7 +210,7 @@ bool VulkanBackend::Initialize(const char *applicationName,
   // At this point no in flight fences exist, so clear the array. These
   // are stored in pointers because initial state must be nullptr and will
   // be nullptr when not in use. Actual fences are not owned by this array
-  _context.imagesInFlight.Reserve(_context.swapchain.imageCount);
+  _context.imagesInFlight.SetLength(_context.swapchain.imageCount);
   for (uint32 i = 0; i < _context.swapchain.imageCount; i++) {
     _context.imagesInFlight[i] = nullptr;
   }
@@ -1146,6 +1146,10 @@ uint64 VulkanBackend::GetFrameBuffer() const { return _frameBuffer; }
 
 const Context &VulkanBackend::GetContext() const { return _context; }
 
+const VulkanAllocator &VulkanBackend::GetHostAllocator() const {
+  return _hostAllocator;
+}
+
 /****************************************************************/
 /**************        PRIVATE MEHTODS         ******************/
 /****************************************************************/
@@ -1697,7 +1701,7 @@ bool VulkanBackend::PhysicalDeviceMeetsRequirements(
 /****** COMMAND BUFFER LOGIC ******/
 void VulkanBackend::CommandBuffersCreate() {
   if (_context.graphicsCommandBuffers.IsEmpty()) {
-    _context.graphicsCommandBuffers.Reserve(_context.swapchain.imageCount);
+    _context.graphicsCommandBuffers.SetLength(_context.swapchain.imageCount);
     for (uint32 i = 0; i < _context.swapchain.imageCount; i++) {
       core::memory::MemoryManager::ZeroMemory(
           &_context.graphicsCommandBuffers[i], sizeof(CommandBuffer));
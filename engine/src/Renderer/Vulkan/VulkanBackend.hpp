@@ -3,6 +3,7 @@
 
 #include "Containers/DArray.hpp"
 #include "Renderer/RendererTypes.inl"
+#include "VulkanAllocator.hpp"
 #include "VulkanTypes.inl"
 #include <vulkan/vulkan_core.h>
 
@@ -105,6 +106,7 @@ public:
   void SetFrameBuffer(uint64 frameBuffer) override;
   uint64 GetFrameBuffer() const override;
   const Context &GetContext() const;
+  const VulkanAllocator &GetHostAllocator() const;
 
 private:
   void Shutdown();
@@ -130,6 +132,10 @@ private:
   // Frame buffer private methods
   void FrameBufferRegenerate(Swapchain *swapchain, RenderPass *renderPass);
 
+  // Backs _context.allocator. Members are destroyed in reverse order, so it
+  // is declared first to outlive _context and anything still released
+  // through its callbacks
+  VulkanAllocator _hostAllocator;
   Context _context;
   struct platform::PlatformState *_platState;
   uint64 _frameBuffer;
@@ -0,0 +1,109 @@
+#include "BitSetTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/BitSet.hpp>
+
+namespace flatearth {
+namespace tests {
+
+using namespace containers;
+
+uchar TestSBitSetOperations_Success() {
+  SBitSet<130> bits;
+  ASSERT_EQ_INT(3, bits.GetWordCount());
+  ASSERT_TRUE(bits.None());
+  ASSERT_EQ_INT(BITSET_NOT_FOUND, bits.FindFirstSet());
+
+  bits.Set(3);
+  bits.Set(64);
+  bits.Set(129, FeTrue);
+  bits.Flip(70);
+  ASSERT_TRUE(bits.Test(64));
+  ASSERT_FALSE(bits.Test(65));
+  ASSERT_EQ_INT(4, bits.Count());
+  ASSERT_EQ_INT(3, bits.FindFirstSet());
+  ASSERT_EQ_INT(64, bits.FindNextSet(4));
+  ASSERT_EQ_INT(129, bits.FindNextSet(71));
+  ASSERT_EQ_INT(BITSET_NOT_FOUND, bits.FindNextSet(130));
+
+  uint64 visited[4] = {};
+  uint64 count = 0;
+  bits.ForEachSetBit([&](uint64 index) { visited[count++] = index; });
+  ASSERT_EQ_INT(4, count);
+  ASSERT_EQ_INT(70, visited[2]);
+
+  // Bits past the size never get set
+  SBitSet<130> all;
+  all.SetAll();
+  ASSERT_EQ_INT(130, all.Count());
+  all ^= bits;
+  ASSERT_EQ_INT(126, all.Count());
+  all &= bits;
+  ASSERT_TRUE(all.None());
+  all |= bits;
+  ASSERT_TRUE(all == bits);
+
+  bits.Reset(3);
+  ASSERT_EQ_INT(64, bits.FindFirstSet());
+  bits.ResetAll();
+  ASSERT_TRUE(bits.None());
+
+  constexpr SBitSet<8> compileTime = [] {
+    SBitSet<8> set;
+    set.Set(5);
+    return set;
+  }();
+  STATIC_ASSERT(compileTime.FindFirstSet() == 5, "Expected bit 5 set");
+
+  return FeTrue;
+}
+
+uchar TestDBitSetOperations_Success() {
+  DBitSet<> visible(100000);
+  ASSERT_EQ_INT(100000, visible.GetSize());
+  ASSERT_EQ_INT(1563, visible.GetWordCount());
+
+  for (uint64 i = 0; i < 100000; i += 1000) {
+    visible.Set(i + 7);
+  }
+  ASSERT_EQ_INT(100, visible.Count());
+  ASSERT_EQ_INT(7, visible.FindFirstSet());
+  ASSERT_EQ_INT(1007, visible.FindNextSet(8));
+
+  uint64 sum = 0;
+  visible.ForEachSetBit([&](uint64 index) { sum += index; });
+  ASSERT_EQ_INT(100 * 7 + 1000 * 99 * 100 / 2, sum);
+
+  DBitSet<> dirty(100000);
+  dirty.Set(7);
+  dirty.Set(8);
+  dirty &= visible;
+  ASSERT_EQ_INT(1, dirty.Count());
+
+  // Mismatched sizes are refused
+  DBitSet<> small(10);
+  small.SetAll();
+  dirty |= small;
+  ASSERT_EQ_INT(1, dirty.Count());
+
+  // Bits dropped by a shrink do not come back when growing again
+  small.Resize(5);
+  ASSERT_EQ_INT(5, small.Count());
+  small.Resize(200);
+  ASSERT_EQ_INT(5, small.Count());
+  ASSERT_FALSE(small.Test(7));
+  ASSERT_EQ_INT(BITSET_NOT_FOUND, small.FindNextSet(5));
+
+  return FeTrue;
+}
+
+void BitSetRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestSBitSetOperations_Success,
+                  "Static bit set should set, scan and combine bits");
+  tm.RegisterTest(TestDBitSetOperations_Success,
+                  "Dynamic bit set should set, scan and resize bits");
+}
+
+}
+}
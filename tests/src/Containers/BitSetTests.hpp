@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_BIT_SET_HPP
+#define _FLATEARHT_TESTS_BIT_SET_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void BitSetRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_BIT_SET_HPP
@@ -5,6 +5,8 @@
 #include <Containers/DArray.hpp>
 #include <Math/FeMath.hpp>
 #include <Math/MathTypes.inl>
+#include <Memory/LinearAllocator.hpp>
+#include <Memory/PoolAllocator.hpp>
 
 namespace flatearth {
 namespace tests {
@@ -153,8 +155,192 @@ uchar TestDArrayReserveCapacityOnly() {
   array.Push(1);
   array.Reserve(32);
 
-  ASSERT_EQ_INT(32, array.GetLength());
+  ASSERT_EQ_INT(1, array.GetLength());
   ASSERT_TRUE(array.GetCapacity() >= 32);
+  ASSERT_EQ_INT(1, array[0]);
+
+  // SetLength is the way to get addressable, zeroed elements
+  array.SetLength(32);
+  ASSERT_EQ_INT(32, array.GetLength());
+  ASSERT_EQ_INT(0, array[31]);
+
+  return FeTrue;
+}
+
+struct alignas(64) CacheLineAligned {
+  uint64 value;
+};
+
+uchar TestDArrayOverAlignedType_Success() {
+  DArray<CacheLineAligned> array;
+  for (uint64 i = 0; i < 8; i++) {
+    array.Push(CacheLineAligned{i});
+  }
+
+  ASSERT_EQ_INT(8, array.GetLength());
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(array.Data()) % 64);
+  ASSERT_EQ_INT(7, array[7].value);
+  return FeTrue;
+}
+
+uchar TestDArrayTriviallyRelocatableGrowth_Success() {
+  STATIC_ASSERT(IsTriviallyRelocatableV<math::Vec2i>,
+                "Vec2i should grow with a plain copy");
+  STATIC_ASSERT(!IsTriviallyRelocatableV<string>,
+                "string must be moved element by element");
+
+  uint64 before = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_DARRAY];
+  {
+    DArray<uint32> numbers;
+    DArray<string> names;
+    for (uint32 i = 0; i < 100000; i++) {
+      numbers.Push(i);
+    }
+    for (uint32 i = 0; i < 100; i++) {
+      names.Push(std::to_string(i) + " is long enough to live on the heap");
+    }
+
+    ASSERT_EQ_INT(100000, numbers.GetLength());
+    ASSERT_EQ_INT(131072, numbers.GetCapacity());
+    for (uint32 i = 0; i < 100000; i++) {
+      ASSERT_EQ_INT(i, numbers[i]);
+    }
+    ASSERT_TRUE(names[99] == "99 is long enough to live on the heap");
+  }
+  ASSERT_EQ_INT(before, core::memory::MemoryManager::GetStats()
+                            .taggedAllocations[core::memory::MEMORY_TAG_DARRAY]);
+
+  return FeTrue;
+}
+
+uchar TestDArrayMoveAndEmplace_Success() {
+  DArray<string> array;
+  string moved = "moved into the array without any copy of it";
+  array.Push(std::move(moved));
+  string &emplaced = array.Emplace(5, 'x');
+
+  ASSERT_EQ_INT(2, array.GetLength());
+  ASSERT_TRUE(moved.empty());
+  ASSERT_TRUE(array[0] == "moved into the array without any copy of it");
+  ASSERT_TRUE(emplaced == "xxxxx");
+
+  // Pushing an element of the array itself while it grows
+  for (uint32 i = 0; i < 6; i++) {
+    array.Push(array[0]);
+  }
+  ASSERT_EQ_INT(8, array.GetLength());
+  ASSERT_TRUE(array[7] == array[0]);
+
+  array.InsertAt(array[1], 1);
+  ASSERT_TRUE(array[1] == "xxxxx");
+  ASSERT_TRUE(array[2] == "xxxxx");
+  ASSERT_TRUE(array[8] == array[0]);
+
+  return FeTrue;
+}
+
+uchar TestDArrayPopAtSwap_Success() {
+  DArray<uint32> array;
+  for (uint32 i = 0; i < 5; i++) {
+    array.Push(i);
+  }
+
+  array.PopAtSwap(1);
+  ASSERT_EQ_INT(4, array.GetLength());
+  ASSERT_EQ_INT(4, array[1]);
+  ASSERT_EQ_INT(3, array[3]);
+
+  array.PopAtSwap(3);
+  ASSERT_EQ_INT(3, array.GetLength());
+  ASSERT_EQ_INT(2, array[2]);
+
+  array.PopAtSwap(3);
+  ASSERT_EQ_INT(3, array.GetLength());
+
+  DArray<string> names;
+  names.Push("first");
+  names.Push("second");
+  names.Push("third");
+  names.PopAtSwap(0);
+  ASSERT_TRUE(names[0] == "third");
+  ASSERT_TRUE(names[1] == "second");
+
+  return FeTrue;
+}
+
+uchar TestDArrayAppend_Success() {
+  uint32 values[100];
+  for (uint32 i = 0; i < 100; i++) {
+    values[i] = i;
+  }
+
+  DArray<uint32> array;
+  array.Push(1000);
+  array.Append(values, 100);
+  ASSERT_EQ_INT(101, array.GetLength());
+  ASSERT_EQ_INT(1000, array[0]);
+  ASSERT_EQ_INT(99, array[100]);
+
+  // Appending the array to itself
+  array.Append(array.Data(), array.GetLength());
+  ASSERT_EQ_INT(202, array.GetLength());
+  ASSERT_EQ_INT(1000, array[101]);
+  ASSERT_EQ_INT(99, array[201]);
+
+  string names[] = {"a", "b", "c"};
+  DArray<string> strings;
+  strings.Append(names, 3);
+  ASSERT_EQ_INT(3, strings.GetLength());
+  ASSERT_TRUE(strings[2] == "c");
+
+  return FeTrue;
+}
+
+uchar TestDArrayCustomAllocators_Success() {
+  uint64 before = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_RENDERER];
+  {
+    DArray<uint32, TaggedAllocator<core::memory::MEMORY_TAG_RENDERER>> tagged;
+    tagged.Reserve(64);
+    uint64 during = core::memory::MemoryManager::GetStats()
+                        .taggedAllocations[core::memory::MEMORY_TAG_RENDERER];
+    ASSERT_EQ_INT(before + 64 * sizeof(uint32), during);
+  }
+  ASSERT_EQ_INT(before, core::memory::MemoryManager::GetStats()
+                            .taggedAllocations[core::memory::MEMORY_TAG_RENDERER]);
+
+  // Scratch arrays live in the arena and go away with it
+  memory::LinearAllocator scratch(4096, nullptr);
+  {
+    ArenaAllocator<memory::LinearAllocator> arena(&scratch);
+    DArray<uint64, ArenaAllocator<memory::LinearAllocator>> array(arena);
+    for (uint64 i = 0; i < 100; i++) {
+      array.Push(i);
+    }
+
+    uintptr_t data = reinterpret_cast<uintptr_t>(array.Data());
+    uintptr_t base = reinterpret_cast<uintptr_t>(scratch.GetMemory());
+    ASSERT_TRUE(data >= base && data < base + scratch.GetTotalSize());
+    ASSERT_EQ_INT(99, array[99]);
+    ASSERT_EQ_PTR(&scratch, array.GetAllocator().GetArena());
+  }
+  scratch.FreaAll();
+
+  // Pool blocks grow in place up to the block size
+  memory::PoolAllocator pool(256, 4, nullptr, 16);
+  {
+    PoolBlockAllocator blocks(&pool);
+    DArray<uint32, PoolBlockAllocator> array(blocks, 4);
+    void *first = array.Data();
+    for (uint32 i = 0; i < 64; i++) {
+      array.Push(i);
+    }
+    ASSERT_EQ_PTR(first, array.Data());
+    ASSERT_EQ_INT(1, pool.GetAllocatedCount());
+    ASSERT_EQ_INT(63, array[63]);
+  }
+  ASSERT_EQ_INT(0, pool.GetAllocatedCount());
 
   return FeTrue;
 }
@@ -172,6 +358,15 @@ void DArrayRegisterTests(TestManager &tm) {
   tm.RegisterTest(TestDArrayPopAtInvalidIndex_DoesNothing, "DArray: PopAt invalid index");
   tm.RegisterTest(TestDArrayAccessOutOfBounds_Throws, "DArray: Access out-of-bounds throws");
   tm.RegisterTest(TestDArrayReserveCapacityOnly, "DArray: Reserve");
+  tm.RegisterTest(TestDArrayOverAlignedType_Success,
+                  "DArray: Over-aligned element type");
+  tm.RegisterTest(TestDArrayTriviallyRelocatableGrowth_Success,
+                  "DArray: Growth by relocation");
+  tm.RegisterTest(TestDArrayMoveAndEmplace_Success, "DArray: Push(T&&) & Emplace");
+  tm.RegisterTest(TestDArrayPopAtSwap_Success, "DArray: PopAtSwap");
+  tm.RegisterTest(TestDArrayAppend_Success, "DArray: Append");
+  tm.RegisterTest(TestDArrayCustomAllocators_Success,
+                  "DArray: Tagged, arena and pool allocators");
 }
 
 }
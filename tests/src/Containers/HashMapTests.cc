@@ -0,0 +1,159 @@
+#include "HashMapTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/HashMap.hpp>
+#include <Core/FeMemory.hpp>
+
+namespace flatearth {
+namespace tests {
+
+using namespace containers;
+
+static uint64 DictAllocatedBytes() {
+  return core::memory::MemoryManager::GetStats()
+      .taggedAllocations[core::memory::MEMORY_TAG_DICT];
+}
+
+uchar TestHashMapInsertAndFind_Success() {
+  HashMap<uint32, uint32> map;
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_EQ_PTR(nullptr, map.Find(7u));
+
+  for (uint32 i = 0; i < 1000; i++) {
+    ASSERT_TRUE(map.Insert(i, i * 3));
+  }
+  ASSERT_EQ_INT(1000, map.GetLength());
+
+  // Existing keys are left alone by Insert and overwritten by Set
+  ASSERT_FALSE(map.Insert(10, 0));
+  ASSERT_EQ_INT(30, *map.Find(10u));
+  map.Set(10, 5);
+  ASSERT_EQ_INT(5, *map.Find(10u));
+  map[10] = 30;
+  map[2000] += 4;
+  ASSERT_EQ_INT(4, *map.Find(2000u));
+  ASSERT_EQ_INT(1001, map.GetLength());
+
+  for (uint32 i = 0; i < 1000; i++) {
+    uint32 *value = map.Find(i);
+    ASSERT_NEQ_PTR(nullptr, value);
+    ASSERT_EQ_INT(i * 3, *value);
+  }
+  ASSERT_FALSE(map.Contains(1000u));
+
+  uint64 sum = 0;
+  uint64 keySum = 0;
+  uint64 visited = 0;
+  uint64 mismatched = 0;
+  map.ForEach([&](const uint32 &key, uint32 &value) {
+    sum += value;
+    keySum += key;
+    visited++;
+    // Every key but 2000 maps to three times itself
+    if (key != 2000u && value != key * 3) {
+      mismatched++;
+    }
+  });
+  ASSERT_EQ_INT(1001, visited);
+  ASSERT_EQ_INT(0, mismatched);
+  ASSERT_EQ_INT(999 * 1000 / 2 + 2000, keySum);
+  ASSERT_EQ_INT(3 * 999 * 1000 / 2 + 4, sum);
+
+  return FeTrue;
+}
+
+uchar TestHashMapEraseChurn_Success() {
+  HashMap<uint64, uint64> map;
+  for (uint64 i = 0; i < 512; i++) {
+    map.Insert(i, i);
+  }
+  uint64 capacity = map.GetCapacity();
+
+  // Keep erasing and inserting at the same size, the entries shifted back
+  // by each erase must stay reachable and the map must never grow
+  for (uint64 round = 0; round < 20; round++) {
+    uint64 base = round * 512;
+    for (uint64 i = 0; i < 512; i++) {
+      ASSERT_TRUE(map.Erase(base + i));
+      ASSERT_FALSE(map.Erase(base + i));
+      ASSERT_TRUE(map.Insert(base + 512 + i, base + 512 + i));
+    }
+
+    ASSERT_EQ_INT(512, map.GetLength());
+    ASSERT_EQ_INT(capacity, map.GetCapacity());
+    for (uint64 i = base + 512; i < base + 1024; i++) {
+      uint64 *value = map.Find(i);
+      ASSERT_NEQ_PTR(nullptr, value);
+      ASSERT_EQ_INT(i, *value);
+    }
+  }
+
+  map.Clear();
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_FALSE(map.Contains(10752ull));
+
+  return FeTrue;
+}
+
+uchar TestHashMapHeterogeneousLookup_Success() {
+  HashMap<string, uint32> map;
+  map.Insert("albedo", 1);
+  map.Insert("normal", 2);
+  map.Insert(string(64, 'x'), 3);
+
+  // No string is built to look these up
+  vstring normal = "normal";
+  ASSERT_EQ_INT(2, *map.Find(normal));
+  ASSERT_EQ_INT(1, *map.Find("albedo"));
+  ASSERT_EQ_INT(3, *map.Find(string(64, 'x')));
+  ASSERT_FALSE(map.Contains(vstring("roughness")));
+
+  ASSERT_TRUE(map.Erase(vstring("albedo")));
+  ASSERT_EQ_PTR(nullptr, map.Find("albedo"));
+  ASSERT_EQ_INT(2, map.GetLength());
+
+  return FeTrue;
+}
+
+uchar TestHashMapReserve_Success() {
+  uint64 before = DictAllocatedBytes();
+  {
+    HashMap<uint32, uint64> map;
+    ASSERT_EQ_INT(0, map.GetCapacity());
+    ASSERT_EQ_INT(before, DictAllocatedBytes());
+
+    map.Reserve(100);
+    uint64 capacity = map.GetCapacity();
+    ASSERT_EQ_INT(128, capacity);
+    ASSERT_TRUE(DictAllocatedBytes() > before);
+    uint64 reserved = DictAllocatedBytes();
+
+    for (uint32 i = 0; i < 100; i++) {
+      map.Insert(i, i);
+    }
+    ASSERT_EQ_INT(capacity, map.GetCapacity());
+    ASSERT_EQ_INT(reserved, DictAllocatedBytes());
+
+    // Never shrinks
+    map.Reserve(10);
+    ASSERT_EQ_INT(capacity, map.GetCapacity());
+  }
+  ASSERT_EQ_INT(before, DictAllocatedBytes());
+
+  return FeTrue;
+}
+
+void HashMapRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestHashMapInsertAndFind_Success,
+                  "Hash map should insert and find entries");
+  tm.RegisterTest(TestHashMapEraseChurn_Success,
+                  "Hash map should keep entries reachable across erases");
+  tm.RegisterTest(TestHashMapHeterogeneousLookup_Success,
+                  "Hash map should find string keys from views");
+  tm.RegisterTest(TestHashMapReserve_Success,
+                  "Hash map should not grow after reserving");
+}
+
+}
+}
@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_HASH_MAP_HPP
+#define _FLATEARHT_TESTS_HASH_MAP_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void HashMapRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_HASH_MAP_HPP
@@ -0,0 +1,195 @@
+#include "RingQueueTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/RingQueue.hpp>
+#include <Core/FeMemory.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace flatearth {
+namespace tests {
+
+using namespace containers;
+
+static uint64 RingQueueAllocatedBytes() {
+  return core::memory::MemoryManager::GetStats()
+      .taggedAllocations[core::memory::MEMORY_TAG_RING_QUEUE];
+}
+
+uchar TestSPSCQueuePushPop_Success() {
+  uint64 before = RingQueueAllocatedBytes();
+  {
+    SPSCQueue<string> queue(4);
+    ASSERT_EQ_INT(4, queue.GetCapacity());
+    ASSERT_EQ_INT(4 * sizeof(string), RingQueueAllocatedBytes() - before);
+
+    // Several laps around the ring
+    string popped;
+    for (uint32 i = 0; i < 10; i++) {
+      ASSERT_TRUE(queue.TryPush(std::to_string(i)));
+      ASSERT_TRUE(queue.TryEmplace(3, 'x'));
+      ASSERT_EQ_INT(2, queue.GetLength());
+      ASSERT_TRUE(queue.TryPop(popped));
+      ASSERT_TRUE(popped == std::to_string(i));
+      ASSERT_TRUE(queue.TryPop(popped));
+      ASSERT_TRUE(popped == "xxx");
+    }
+    ASSERT_TRUE(queue.IsEmpty());
+    ASSERT_FALSE(queue.TryPop(popped));
+
+    for (uint32 i = 0; i < 4; i++) {
+      ASSERT_TRUE(queue.TryPush(string(32, 'a' + i)));
+    }
+    ASSERT_FALSE(queue.TryPush(string("full")));
+
+    string batch[3] = {"b", "c", "d"};
+    ASSERT_TRUE(queue.TryPop(popped));
+    ASSERT_EQ_INT(1, queue.PushBatch(batch, 3));
+    string out[8];
+    ASSERT_EQ_INT(4, queue.PopBatch(out, 8));
+    ASSERT_TRUE(out[3] == "b");
+    ASSERT_EQ_INT(0, queue.PopBatch(out, 8));
+
+    // Left in the queue, destroyed with it
+    ASSERT_EQ_INT(3, queue.PushBatch(batch, 3));
+  }
+  ASSERT_EQ_INT(before, RingQueueAllocatedBytes());
+
+  bool thrown = FeFalse;
+  try {
+    SPSCQueue<uint32> queue(3);
+  } catch (const std::invalid_argument &) {
+    thrown = FeTrue;
+  }
+  ASSERT_TRUE(thrown);
+
+  return FeTrue;
+}
+
+uchar TestSPSCQueueThreads_Success() {
+  constexpr uint64 count = 200000;
+  SPSCQueue<uint64> queue(64);
+
+  std::thread producer([&queue]() {
+    uint64 batch[16];
+    uint64 next = 0;
+    while (next < count) {
+      uint64 size = 0;
+      for (; size < 16 && next + size < count; size++) {
+        batch[size] = next + size;
+      }
+      next += queue.PushBatch(batch, size);
+    }
+  });
+
+  // Elements come out in the order they went in
+  uint64 expected = 0;
+  bool ordered = FeTrue;
+  uint64 value = 0;
+  while (expected < count) {
+    if (expected % 2 == 0) {
+      uint64 batch[8];
+      uint64 popped = queue.PopBatch(batch, 8);
+      for (uint64 i = 0; i < popped; i++) {
+        ordered = ordered && batch[i] == expected++;
+      }
+    } else if (queue.TryPop(value)) {
+      ordered = ordered && value == expected++;
+    }
+  }
+  producer.join();
+
+  ASSERT_TRUE(ordered);
+  ASSERT_TRUE(queue.IsEmpty());
+
+  return FeTrue;
+}
+
+uchar TestMPMCQueueSingleThread_Success() {
+  MPMCQueue<uint32> queue(8);
+  uint32 value = 0;
+  ASSERT_FALSE(queue.TryPop(value));
+
+  uint32 batch[12] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  ASSERT_EQ_INT(8, queue.PushBatch(batch, 12));
+  ASSERT_FALSE(queue.TryPush(12u));
+  ASSERT_EQ_INT(8, queue.GetLength());
+
+  uint32 out[12] = {};
+  ASSERT_EQ_INT(5, queue.PopBatch(out, 5));
+  ASSERT_EQ_INT(4, out[4]);
+  ASSERT_EQ_INT(4, queue.PushBatch(batch + 8, 4));
+  ASSERT_EQ_INT(7, queue.PopBatch(out, 12));
+  ASSERT_EQ_INT(5, out[0]);
+  ASSERT_EQ_INT(11, out[6]);
+  ASSERT_TRUE(queue.IsEmpty());
+
+  return FeTrue;
+}
+
+uchar TestMPMCQueueThreads_Success() {
+  constexpr uint64 threadCount = 4;
+  constexpr uint64 perProducer = 50000;
+  MPMCQueue<uint64> queue(256);
+
+  std::atomic<uint64> consumed = 0;
+  std::atomic<uint64> sum = 0;
+  std::vector<std::thread> threads;
+  for (uint64 t = 0; t < threadCount; t++) {
+    threads.emplace_back([&queue, t]() {
+      uint64 batch[4];
+      for (uint64 i = 0; i < perProducer;) {
+        if (i % 3 == 0) {
+          uint64 size = 0;
+          for (; size < 4 && i + size < perProducer; size++) {
+            batch[size] = t * perProducer + i + size + 1;
+          }
+          i += queue.PushBatch(batch, size);
+        } else if (queue.TryPush(t * perProducer + i + 1)) {
+          i++;
+        }
+      }
+    });
+
+    threads.emplace_back([&queue, &consumed, &sum, t]() {
+      uint64 batch[4];
+      while (consumed.load() < threadCount * perProducer) {
+        uint64 popped = t % 2 ? queue.PopBatch(batch, 4)
+                              : queue.TryPop(batch[0]) ? 1 : 0;
+        for (uint64 i = 0; i < popped; i++) {
+          sum += batch[i];
+        }
+        consumed += popped;
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  // Every value came out exactly once
+  uint64 total = threadCount * perProducer;
+  ASSERT_EQ_INT(total, consumed.load());
+  ASSERT_EQ_INT(total * (total + 1) / 2, sum.load());
+  ASSERT_TRUE(queue.IsEmpty());
+
+  return FeTrue;
+}
+
+void RingQueueRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestSPSCQueuePushPop_Success,
+                  "SPSC queue should push and pop around the ring");
+  tm.RegisterTest(TestSPSCQueueThreads_Success,
+                  "SPSC queue should keep order across threads");
+  tm.RegisterTest(TestMPMCQueueSingleThread_Success,
+                  "MPMC queue should push and pop in batches");
+  tm.RegisterTest(TestMPMCQueueThreads_Success,
+                  "MPMC queue should deliver every element once");
+}
+
+}
+}
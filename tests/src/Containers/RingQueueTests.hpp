@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_RING_QUEUE_HPP
+#define _FLATEARHT_TESTS_RING_QUEUE_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void RingQueueRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_RING_QUEUE_HPP
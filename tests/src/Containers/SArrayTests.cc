@@ -0,0 +1,96 @@
+#include "SArrayTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/SArray.hpp>
+#include <Core/FeMemory.hpp>
+
+namespace flatearth {
+namespace tests {
+
+using namespace containers;
+
+uchar TestSArrayCreate_Success() {
+  SArray<uint32, 8> array;
+
+  ASSERT_EQ_INT(8, array.GetSize());
+  ASSERT_FALSE(array.IsEmpty());
+  ASSERT_EQ_INT(8, array.End() - array.Begin());
+  for (uint64 i = 0; i < 8; i++) {
+    ASSERT_EQ_INT(0, array[i]);
+  }
+
+  array.At(7) = 42;
+  ASSERT_EQ_INT(42, array[7]);
+
+  return FeTrue;
+}
+
+uchar TestSArrayAccessOutOfBounds_Throws() {
+  SArray<uint32, 4> array;
+
+  bool caught = false;
+  try {
+    auto v = array.At(4);
+  } catch (const std::out_of_range &) {
+    caught = true;
+  }
+
+  ASSERT_TRUE(caught);
+  return FeTrue;
+}
+
+uchar TestSArraySwap_Success() {
+  SArray<string, 2> first;
+  SArray<string, 2> second;
+  first[0] = "first";
+  second[0] = "second";
+
+  first.Swap(second);
+  ASSERT_TRUE(first[0] == "second");
+  ASSERT_TRUE(second[0] == "first");
+
+  return FeTrue;
+}
+
+uchar TestSArrayInlineStorage_Success() {
+  struct Embedded {
+    uint32 before;
+    SArray<uint32, 4> values;
+    uint32 after;
+  };
+  STATIC_ASSERT(sizeof(SArray<uint32, 4>) == 4 * sizeof(uint32),
+                "SArray must not carry anything besides its elements");
+
+  uint64 before = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_ARRAY];
+  Embedded embedded = {1, {2, 3}, 4};
+  ASSERT_EQ_INT(before, core::memory::MemoryManager::GetStats()
+                            .taggedAllocations[core::memory::MEMORY_TAG_ARRAY]);
+
+  // Contiguous with the struct around it
+  ASSERT_EQ_PTR(reinterpret_cast<uchar *>(&embedded) + sizeof(uint32),
+                reinterpret_cast<uchar *>(embedded.values.Data()));
+  ASSERT_EQ_INT(2, embedded.values[0]);
+  ASSERT_EQ_INT(3, embedded.values[1]);
+  ASSERT_EQ_INT(0, embedded.values[3]);
+  ASSERT_EQ_INT(4, embedded.after);
+
+  constexpr SArray<uint32, 3> sizes = {1, 2, 4};
+  STATIC_ASSERT(sizes.At(2) == 4, "At must be usable in constant expressions");
+  STATIC_ASSERT(sizes.GetSize() == 3, "Size must be known at compile time");
+
+  return FeTrue;
+}
+
+void SArrayRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestSArrayCreate_Success, "SArray: Create uint32");
+  tm.RegisterTest(TestSArrayAccessOutOfBounds_Throws,
+                  "SArray: Access out-of-bounds throws");
+  tm.RegisterTest(TestSArraySwap_Success, "SArray: Swap");
+  tm.RegisterTest(TestSArrayInlineStorage_Success,
+                  "SArray: Inline aggregate storage");
+}
+
+}
+}
@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_SARRAY_HPP
+#define _FLATEARHT_TESTS_SARRAY_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void SArrayRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_SARRAY_HPP
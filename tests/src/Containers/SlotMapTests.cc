@@ -0,0 +1,107 @@
+#include "SlotMapTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/SlotMap.hpp>
+#include <Core/FeMemory.hpp>
+
+namespace flatearth {
+namespace tests {
+
+using namespace containers;
+
+uchar TestSlotMapInsertAndGet_Success() {
+  SlotMap<string> map;
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_EQ_PTR(nullptr, map.Get(INVALID_SLOT_HANDLE));
+
+  SlotHandle first = map.Insert(string("first"));
+  SlotHandle second = map.Emplace(40, 's');
+  ASSERT_TRUE(first.IsValid());
+  ASSERT_TRUE(second.IsValid());
+  ASSERT_FALSE(first == second);
+  ASSERT_EQ_INT(2, map.GetLength());
+
+  ASSERT_TRUE(*map.Get(first) == "first");
+  ASSERT_EQ_INT(40, map.Get(second)->size());
+  ASSERT_TRUE(map.Contains(second));
+  ASSERT_FALSE(map.Contains({7, 1}));
+
+  return FeTrue;
+}
+
+uchar TestSlotMapStaleHandle_Fails() {
+  SlotMap<uint32> map;
+  SlotHandle handle = map.Insert(1u);
+  ASSERT_TRUE(map.Remove(handle));
+  ASSERT_FALSE(map.Remove(handle));
+  ASSERT_EQ_PTR(nullptr, map.Get(handle));
+
+  // Nor does a handle guessing the generation of the free slot
+  for (uint32 generation = 0; generation < 4; generation++) {
+    ASSERT_FALSE(map.Contains({handle.index, handle.generation + generation}));
+  }
+  ASSERT_FALSE(map.Remove({handle.index, handle.generation + 1}));
+
+  // The slot is reused with a new generation, the old handle stays stale
+  SlotHandle reused = map.Insert(2u);
+  ASSERT_EQ_INT(handle.index, reused.index);
+  ASSERT_FALSE(map.Contains(handle));
+  ASSERT_EQ_INT(2, *map.Get(reused));
+
+  map.Clear();
+  ASSERT_TRUE(map.IsEmpty());
+  ASSERT_FALSE(map.Contains(reused));
+
+  return FeTrue;
+}
+
+uchar TestSlotMapDenseIteration_Success() {
+  SlotMap<uint32, TaggedAllocator<core::memory::MEMORY_TAG_ENTITY>> map;
+  map.Reserve(64);
+
+  SlotHandle handles[64];
+  for (uint32 i = 0; i < 64; i++) {
+    handles[i] = map.Insert(i);
+  }
+
+  // Removing swaps the last elements into the holes, handles still resolve
+  for (uint32 i = 0; i < 64; i += 3) {
+    ASSERT_TRUE(map.Remove(handles[i]));
+  }
+  ASSERT_EQ_INT(42, map.GetLength());
+  for (uint32 i = 0; i < 64; i++) {
+    if (i % 3 == 0) {
+      ASSERT_EQ_PTR(nullptr, map.Get(handles[i]));
+    } else {
+      ASSERT_EQ_INT(i, *map.Get(handles[i]));
+    }
+  }
+
+  // The live elements are contiguous and know their handles
+  uint32 *data = map.Data();
+  for (uint64 i = 0; i < map.GetLength(); i++) {
+    ASSERT_NEQ_INT(0, data[i] % 3);
+    ASSERT_EQ_PTR(&data[i], map.Get(map.GetHandle(i)));
+  }
+
+  uint64 resolved = 0;
+  map.ForEach([&](SlotHandle handle, uint32 &value) {
+    resolved += map.Get(handle) == &value;
+  });
+  ASSERT_EQ_INT(42, resolved);
+
+  return FeTrue;
+}
+
+void SlotMapRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestSlotMapInsertAndGet_Success,
+                  "Slot map should insert and resolve handles");
+  tm.RegisterTest(TestSlotMapStaleHandle_Fails,
+                  "Slot map must reject stale handles");
+  tm.RegisterTest(TestSlotMapDenseIteration_Success,
+                  "Slot map should keep live elements contiguous");
+}
+
+}
+}
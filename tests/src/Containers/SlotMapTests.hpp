@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_SLOT_MAP_HPP
+#define _FLATEARHT_TESTS_SLOT_MAP_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void SlotMapRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_SLOT_MAP_HPP
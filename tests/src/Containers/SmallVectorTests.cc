@@ -0,0 +1,120 @@
+#include "SmallVectorTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/SmallVector.hpp>
+#include <Core/FeMemory.hpp>
+
+namespace flatearth {
+namespace tests {
+
+using namespace containers;
+
+static uint64 DArrayAllocatedBytes() {
+  return core::memory::MemoryManager::GetStats()
+      .taggedAllocations[core::memory::MEMORY_TAG_DARRAY];
+}
+
+uchar TestSmallVectorInline_Success() {
+  uint64 before = DArrayAllocatedBytes();
+  {
+    SmallVector<uint32, 4> vector;
+    for (uint32 i = 0; i < 4; i++) {
+      vector.Push(i);
+    }
+
+    ASSERT_TRUE(vector.IsInline());
+    ASSERT_EQ_INT(4, vector.GetLength());
+    ASSERT_EQ_INT(4, vector.GetCapacity());
+    ASSERT_EQ_INT(3, vector[3]);
+    ASSERT_EQ_INT(before, DArrayAllocatedBytes());
+
+    // Stored right inside the object
+    uintptr_t data = reinterpret_cast<uintptr_t>(vector.Data());
+    uintptr_t self = reinterpret_cast<uintptr_t>(&vector);
+    ASSERT_TRUE(data > self && data < self + sizeof(vector));
+  }
+
+  return FeTrue;
+}
+
+uchar TestSmallVectorSpill_Success() {
+  uint64 before = DArrayAllocatedBytes();
+  {
+    SmallVector<uint32, 2> vector;
+    for (uint32 i = 0; i < 100; i++) {
+      vector.Push(i);
+    }
+
+    ASSERT_FALSE(vector.IsInline());
+    ASSERT_EQ_INT(100, vector.GetLength());
+    ASSERT_EQ_INT(128, vector.GetCapacity());
+    ASSERT_EQ_INT(128 * sizeof(uint32), DArrayAllocatedBytes() - before);
+    for (uint32 i = 0; i < 100; i++) {
+      ASSERT_EQ_INT(i, vector[i]);
+    }
+
+    SmallVector<string, 2> names;
+    for (uint32 i = 0; i < 10; i++) {
+      names.Emplace(std::to_string(i) + " is long enough to live on the heap");
+    }
+    ASSERT_FALSE(names.IsInline());
+    ASSERT_TRUE(names[0] == "0 is long enough to live on the heap");
+    ASSERT_TRUE(names[9] == "9 is long enough to live on the heap");
+  }
+  ASSERT_EQ_INT(before, DArrayAllocatedBytes());
+
+  return FeTrue;
+}
+
+uchar TestSmallVectorInsertAndPop_Success() {
+  SmallVector<string, 4> names;
+  names.Push("b");
+  names.Push("d");
+  names.InsertAt("a", 0);
+  names.InsertAt("c", 2);
+  names.InsertAt(names[0], 4);
+  ASSERT_EQ_INT(5, names.GetLength());
+  ASSERT_TRUE(names[0] == "a");
+  ASSERT_TRUE(names[2] == "c");
+  ASSERT_TRUE(names[4] == "a");
+
+  names.PopAt(0);
+  ASSERT_TRUE(names[0] == "b");
+  names.PopAtSwap(0);
+  ASSERT_TRUE(names[0] == "a");
+  ASSERT_EQ_INT(3, names.GetLength());
+
+  uint32 values[] = {1, 2, 3, 4, 5, 6};
+  SmallVector<uint32, 4> numbers;
+  numbers.Append(values, 3);
+  ASSERT_TRUE(numbers.IsInline());
+  numbers.Append(numbers.Data(), 3);
+  numbers.InsertAt(0, 0);
+  ASSERT_EQ_INT(7, numbers.GetLength());
+  ASSERT_EQ_INT(0, numbers[0]);
+  ASSERT_EQ_INT(3, numbers[6]);
+
+  numbers.PopAt(0);
+  numbers.Pop();
+  ASSERT_EQ_INT(5, numbers.GetLength());
+  ASSERT_EQ_INT(2, numbers[4]);
+
+  numbers.SetLength(8);
+  ASSERT_EQ_INT(0, numbers[7]);
+  numbers.Clear();
+  ASSERT_TRUE(numbers.IsEmpty());
+
+  return FeTrue;
+}
+
+void SmallVectorRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestSmallVectorInline_Success,
+                  "SmallVector: Inline elements do not allocate");
+  tm.RegisterTest(TestSmallVectorSpill_Success, "SmallVector: Spill to heap");
+  tm.RegisterTest(TestSmallVectorInsertAndPop_Success,
+                  "SmallVector: Insert, pop and append");
+}
+
+}
+}
@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_SMALL_VECTOR_HPP
+#define _FLATEARHT_TESTS_SMALL_VECTOR_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void SmallVectorRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_SMALL_VECTOR_HPP
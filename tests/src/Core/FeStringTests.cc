@@ -0,0 +1,78 @@
+#include "FeStringTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Core/FeString.hpp>
+#include <Memory/LinearAllocator.hpp>
+
+#include <cstring>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestSprintf_Success() {
+  ASSERT_TRUE(core::Sprintf("%d %s", 42, "frames") == "42 frames");
+
+  // Longer than the stack buffer
+  string longText(1000, 'x');
+  string formatted = core::Sprintf("[%s]", longText.c_str());
+  ASSERT_EQ_INT(1002, formatted.size());
+  ASSERT_TRUE(formatted.back() == ']');
+
+  return FeTrue;
+}
+
+uchar TestFixedString_Success() {
+  core::FixedString<32> text;
+  ASSERT_EQ_INT(31, text.GetCapacity());
+  ASSERT_EQ_INT(0, text.GetLength());
+
+  text.Append("fps: ").Format("{} ({} ms)", 60, 16);
+  ASSERT_TRUE(text.View() == "fps: 60 (16 ms)");
+  ASSERT_FALSE(text.IsTruncated());
+
+  // Cut to the capacity, still null terminated
+  text.Append(string(64, 'z'));
+  ASSERT_TRUE(text.IsTruncated());
+  ASSERT_EQ_INT(31, text.GetLength());
+  ASSERT_EQ_INT(31, std::strlen(text.CStr()));
+
+  text.Clear();
+  ASSERT_FALSE(text.IsTruncated());
+  text.Format("{}", string(40, 'a'));
+  ASSERT_TRUE(text.IsTruncated());
+  ASSERT_EQ_INT(31, text.GetLength());
+
+  return FeTrue;
+}
+
+uchar TestStringBuilder_Success() {
+  char buffer[16];
+  core::StringBuilder builder(buffer, sizeof(buffer));
+  builder.Format("{}/{}", 3, 4);
+  ASSERT_TRUE(builder.View() == "3/4");
+  ASSERT_TRUE(builder.CStr() == buffer);
+  builder.Append(" complete tasks");
+  ASSERT_TRUE(builder.IsTruncated());
+  ASSERT_EQ_INT(15, builder.GetLength());
+
+  // Text taken from an arena
+  memory::LinearAllocator arena(256, nullptr);
+  core::StringBuilder line(&arena, 64);
+  line.Format("{} {}", "entity", 7);
+  ASSERT_TRUE(line.View() == "entity 7");
+  ASSERT_EQ_INT(64, arena.GetAllocatedSize());
+
+  return FeTrue;
+}
+
+void FeStringRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestSprintf_Success, "Sprintf should format any length");
+  tm.RegisterTest(TestFixedString_Success,
+                  "Fixed string should format inline and cut overflow");
+  tm.RegisterTest(TestStringBuilder_Success,
+                  "String builder should format into borrowed memory");
+}
+
+}
+}
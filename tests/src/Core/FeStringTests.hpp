@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_FE_STRING_HPP
+#define _FLATEARHT_TESTS_FE_STRING_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void FeStringRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_FE_STRING_HPP
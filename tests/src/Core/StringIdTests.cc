@@ -0,0 +1,61 @@
+#include "StringIdTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Containers/HashMap.hpp>
+#include <Core/StringId.hpp>
+
+namespace flatearth {
+namespace tests {
+
+using core::operator""_sid;
+
+uchar TestStringIdCompileTime_Success() {
+  constexpr core::StringId albedo = "albedo"_sid;
+  STATIC_ASSERT(albedo == core::StringId("albedo"),
+                "Expected literal and constructed ids to match");
+  STATIC_ASSERT(albedo != "normal"_sid, "Expected different ids");
+  STATIC_ASSERT(core::HashString("") == core::STRING_ID_FNV_OFFSET,
+                "Expected the FNV-1a offset for the empty string");
+  // Reference FNV-1a value
+  STATIC_ASSERT(core::HashString("a") == 0xAF63DC4C8601EC8Cull,
+                "Expected the FNV-1a hash of 'a'");
+
+  string runtime = string("alb") + "edo";
+  ASSERT_TRUE(core::StringId(runtime) == albedo);
+  ASSERT_TRUE(albedo.IsValid());
+  ASSERT_FALSE(core::StringId().IsValid());
+
+  // Usable as a hash map key
+  containers::HashMap<core::StringId, uint32> materials;
+  materials.Insert(albedo, 1);
+  materials.Insert("normal"_sid, 2);
+  ASSERT_EQ_INT(2, *materials.Find("normal"_sid));
+
+  return FeTrue;
+}
+
+uchar TestStringIdIntern_Success() {
+  core::StringId id = core::StringId::Intern(string("entity/player"));
+  ASSERT_TRUE(id == "entity/player"_sid);
+  ASSERT_TRUE(id == core::StringId::Intern("entity/player"));
+
+#if STRING_ID_REVERSE_LOOKUP
+  ASSERT_TRUE(id.GetString() == "entity/player");
+  ASSERT_TRUE("never/interned"_sid.GetString().empty());
+#else
+  ASSERT_TRUE(id.GetString().empty());
+#endif
+
+  return FeTrue;
+}
+
+void StringIdRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestStringIdCompileTime_Success,
+                  "String ids should hash literals at compile time");
+  tm.RegisterTest(TestStringIdIntern_Success,
+                  "String ids should look interned strings up again");
+}
+
+}
+}
@@ -0,0 +1,14 @@
+#ifndef _FLATEARHT_TESTS_STRING_ID_HPP
+#define _FLATEARHT_TESTS_STRING_ID_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void StringIdRegisterTests(TestManager &tm);
+
+}
+}
+
+#endif // _FLATEARHT_TESTS_STRING_ID_HPP
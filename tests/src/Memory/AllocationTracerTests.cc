@@ -0,0 +1,135 @@
+#include "AllocationTracerTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Core/FeMemory.hpp>
+#include <Memory/AllocationTracer.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace flatearth {
+namespace tests {
+
+static std::string TracePath(const char *name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static bool ReadTraceEvents(const std::string &path,
+                            memory::AllocationTraceHeader *header,
+                            std::vector<memory::AllocationTraceEvent> *events) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  file.read(reinterpret_cast<char *>(header), sizeof(*header));
+  if (!file) {
+    return FeFalse;
+  }
+
+  file.seekg(header->tagCount * header->tagNameSize, std::ios::cur);
+  memory::AllocationTraceEvent event;
+  while (file.read(reinterpret_cast<char *>(&event), sizeof(event))) {
+    events->push_back(event);
+  }
+  return FeTrue;
+}
+
+uchar TestAllocationTracerRecordsEvents_Success() {
+  std::string path = TracePath("flatearth_trace_events.bin");
+  ASSERT_TRUE(core::memory::MemoryManager::StartTracing(path));
+  ASSERT_TRUE(core::memory::MemoryManager::IsTracing());
+
+  void *block = core::memory::MemoryManager::Allocate(
+      96, core::memory::MEMORY_TAG_JOB);
+  core::memory::MemoryManager::Free(block, 96, core::memory::MEMORY_TAG_JOB);
+
+  constexpr uint64 threadCount = 4;
+  constexpr uint64 iterations = 100;
+  std::vector<std::thread> threads;
+  for (uint64 t = 0; t < threadCount; t++) {
+    threads.emplace_back([]() {
+      for (uint64 i = 0; i < iterations; i++) {
+        void *data = core::memory::MemoryManager::Allocate(
+            32, core::memory::MEMORY_TAG_ENTITY);
+        core::memory::MemoryManager::Free(data, 32,
+                                          core::memory::MEMORY_TAG_ENTITY);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  core::memory::MemoryManager::StopTracing();
+  ASSERT_FALSE(core::memory::MemoryManager::IsTracing());
+
+  memory::AllocationTraceHeader header;
+  std::vector<memory::AllocationTraceEvent> events;
+  ASSERT_TRUE(ReadTraceEvents(path, &header, &events));
+  ASSERT_EQ_INT(0, std::memcmp(header.magic, memory::ALLOCATION_TRACE_MAGIC,
+                               sizeof(header.magic)));
+  ASSERT_EQ_INT(memory::ALLOCATION_TRACE_VERSION, header.version);
+  ASSERT_EQ_INT(sizeof(memory::AllocationTraceEvent), header.eventSize);
+  ASSERT_EQ_INT(core::memory::MEMORY_TAG_MAX_TAGS, header.tagCount);
+
+  uint64 jobEvents = 0;
+  uint64 entityAllocs = 0;
+  uint64 entityFrees = 0;
+  for (const memory::AllocationTraceEvent &event : events) {
+    if (event.tag == core::memory::MEMORY_TAG_JOB) {
+      ASSERT_EQ_INT(reinterpret_cast<uint64>(block), event.address);
+      ASSERT_EQ_INT(96, event.size);
+      ASSERT_TRUE(event.callsite != 0);
+      jobEvents++;
+    } else if (event.tag == core::memory::MEMORY_TAG_ENTITY) {
+      entityAllocs += event.type == memory::ALLOCATION_TRACE_ALLOCATE;
+      entityFrees += event.type == memory::ALLOCATION_TRACE_FREE;
+    }
+  }
+
+  ASSERT_EQ_INT(2, jobEvents);
+  ASSERT_EQ_INT(threadCount * iterations, entityAllocs);
+  ASSERT_EQ_INT(threadCount * iterations, entityFrees);
+
+  std::filesystem::remove(path);
+  return FeTrue;
+}
+
+uchar TestAllocationTracerDropsWhenFull_Success() {
+  std::string path = TracePath("flatearth_trace_drops.bin");
+  constexpr uint64 events = 64;
+
+  // Long flush interval, nothing is drained before Stop()
+  memory::AllocationTracer tracer(8, 60 * 1000);
+  vstring names[] = {"ONLY_TAG"};
+  ASSERT_TRUE(tracer.Start(path, names, 1, FeFalse));
+  for (uint64 i = 0; i < events; i++) {
+    tracer.Record(memory::ALLOCATION_TRACE_ALLOCATE, &tracer, i, 0, nullptr);
+  }
+  tracer.Stop();
+
+  ASSERT_TRUE(tracer.GetDroppedCount() > 0);
+  ASSERT_EQ_INT(events, tracer.GetWrittenCount() + tracer.GetDroppedCount());
+
+  memory::AllocationTraceHeader header;
+  std::vector<memory::AllocationTraceEvent> written;
+  ASSERT_TRUE(ReadTraceEvents(path, &header, &written));
+  ASSERT_EQ_INT(tracer.GetWrittenCount(), written.size());
+  ASSERT_EQ_INT(0, written[0].size);
+  ASSERT_EQ_INT(0, written[0].callsite);
+
+  std::filesystem::remove(path);
+  return FeTrue;
+}
+
+void AllocationTracerRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestAllocationTracerRecordsEvents_Success,
+                  "Allocation tracer should record events of every thread");
+  tm.RegisterTest(TestAllocationTracerDropsWhenFull_Success,
+                  "Allocation tracer should drop events when a ring is full");
+}
+
+} // namespace tests
+} // namespace flatearth
@@ -0,0 +1,14 @@
+#ifndef _FLATEARTH_TESTS_ALLOCATION_TRACER_HPP
+#define _FLATEARTH_TESTS_ALLOCATION_TRACER_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void AllocationTracerRegisterTests(TestManager &tm);
+
+}
+} // namespace flatearth
+
+#endif // _FLATEARTH_TESTS_ALLOCATION_TRACER_HPP
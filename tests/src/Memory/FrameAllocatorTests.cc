@@ -0,0 +1,72 @@
+#include "FrameAllocatorTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Memory/FrameAllocator.hpp>
+#include <Memory/Utils.hpp>
+
+#include <stdexcept>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestFrameAllocatorPreviousFrameSurvives_Success() {
+  memory::FrameAllocator alloc(1024, nullptr);
+
+  alloc.BeginFrame();
+  uint64 *previous = memory::AllocateObject<uint64>(alloc, 42ull);
+  ASSERT_NEQ_PTR(nullptr, previous);
+
+  // Data from the previous frame is left untouched by the next one
+  alloc.BeginFrame();
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+  uint64 *current = memory::AllocateObject<uint64>(alloc, 7ull);
+  ASSERT_NEQ_PTR(nullptr, current);
+  ASSERT_NEQ_PTR(previous, current);
+  ASSERT_EQ_INT(42, *previous);
+
+  // Two frames later the first arena is reused
+  alloc.BeginFrame();
+  ASSERT_EQ_PTR(previous, alloc.Allocate(sizeof(uint64), alignof(uint64)));
+  ASSERT_EQ_INT(7, *current);
+  ASSERT_EQ_INT(3, alloc.GetFrameIndex());
+
+  return FeTrue;
+}
+
+uchar TestFrameAllocatorExhausted_Fails() {
+  memory::FrameAllocator alloc(256, nullptr);
+
+  ASSERT_NEQ_PTR(nullptr, alloc.Allocate(200));
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate(200));
+
+  alloc.BeginFrame();
+  ASSERT_NEQ_PTR(nullptr, alloc.Allocate(200));
+
+  return FeTrue;
+}
+
+uchar TestFrameAllocatorOutOfMemory_Fails() {
+  // No arena may be built on top of a failed allocation
+  bool thrown = FeFalse;
+  try {
+    memory::FrameAllocator alloc(1ull << 60, nullptr);
+  } catch (const std::runtime_error &) {
+    thrown = FeTrue;
+  }
+  ASSERT_TRUE(thrown);
+
+  return FeTrue;
+}
+
+void FrameAllocatorRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestFrameAllocatorPreviousFrameSurvives_Success,
+                  "Frame allocator should keep the previous frame alive");
+  tm.RegisterTest(TestFrameAllocatorExhausted_Fails,
+                  "Frame allocator must fail when the frame arena is full");
+  tm.RegisterTest(TestFrameAllocatorOutOfMemory_Fails,
+                  "Frame allocator must throw when its memory is unavailable");
+}
+
+} // namespace tests
+} // namespace flatearth
@@ -0,0 +1,167 @@
+#include "FreeListAllocatorTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Memory/FreeListAllocator.hpp>
+
+namespace flatearth {
+namespace tests {
+
+constexpr uint64 FREELIST_TEST_POOL_SIZE = 64 * 1024;
+
+uchar TestFreeListAllocatorCreate_Success() {
+  memory::FreeListAllocator alloc(FREELIST_TEST_POOL_SIZE, nullptr);
+
+  ASSERT_NEQ_PTR(nullptr, alloc.GetMemory());
+  ASSERT_EQ_INT(FREELIST_TEST_POOL_SIZE, alloc.GetTotalSize());
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+  ASSERT_TRUE(alloc.GetFreeSize() > 0);
+
+  return FeTrue;
+}
+
+uchar TestFreeListAllocatorAllocateAndFree_Success() {
+  memory::FreeListAllocator alloc(FREELIST_TEST_POOL_SIZE, nullptr);
+  uint64 initialFree = alloc.GetFreeSize();
+
+  void *block = alloc.Allocate(100);
+  ASSERT_NEQ_PTR(nullptr, block);
+  ASSERT_TRUE(alloc.Owns(block));
+  ASSERT_TRUE(alloc.GetBlockSize(block) >= 100);
+  ASSERT_TRUE(alloc.GetFreeSize() < initialFree);
+
+  alloc.Free(block);
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+  ASSERT_EQ_INT(initialFree, alloc.GetFreeSize());
+
+  return FeTrue;
+}
+
+uchar TestFreeListAllocatorReusesFreedBlock_Success() {
+  memory::FreeListAllocator alloc(FREELIST_TEST_POOL_SIZE, nullptr);
+
+  void *first = alloc.Allocate(64);
+  void *guard = alloc.Allocate(64);
+  alloc.Free(first);
+
+  void *second = alloc.Allocate(64);
+  ASSERT_EQ_PTR(first, second);
+
+  alloc.Free(second);
+  alloc.Free(guard);
+  return FeTrue;
+}
+
+uchar TestFreeListAllocatorCoalescesOnFree_Success() {
+  memory::FreeListAllocator alloc(FREELIST_TEST_POOL_SIZE, nullptr);
+  uint64 initialFree = alloc.GetFreeSize();
+
+  constexpr uint64 blockCount = 64;
+  void *blocks[blockCount];
+  for (uint64 i = 0; i < blockCount; i++) {
+    blocks[i] = alloc.Allocate(256);
+    ASSERT_NEQ_PTR(nullptr, blocks[i]);
+  }
+
+  // Free in an interleaved order so both neighbour merges are exercised
+  for (uint64 i = 0; i < blockCount; i += 2) {
+    alloc.Free(blocks[i]);
+  }
+  for (uint64 i = 1; i < blockCount; i += 2) {
+    alloc.Free(blocks[i]);
+  }
+
+  ASSERT_EQ_INT(initialFree, alloc.GetFreeSize());
+
+  // The pool must be a single block again
+  void *big = alloc.Allocate(initialFree - 1024);
+  ASSERT_NEQ_PTR(nullptr, big);
+  alloc.Free(big);
+
+  return FeTrue;
+}
+
+uchar TestFreeListAllocatorAlignedAllocation_Success() {
+  memory::FreeListAllocator alloc(FREELIST_TEST_POOL_SIZE, nullptr);
+  uint64 alignments[] = {16, 32, 64, 128, 256, 4096};
+
+  for (uint64 align : alignments) {
+    void *unaligned = alloc.Allocate(24);
+    void *block = alloc.Allocate(40, align);
+    ASSERT_NEQ_PTR(nullptr, block);
+    ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(block) % align);
+    alloc.Free(unaligned);
+    alloc.Free(block);
+  }
+
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+  return FeTrue;
+}
+
+uchar TestFreeListAllocatorOutOfMemory_Fails() {
+  memory::FreeListAllocator alloc(4096, nullptr);
+
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate(8192));
+
+  void *block = alloc.Allocate(2048);
+  ASSERT_NEQ_PTR(nullptr, block);
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate(4000));
+  alloc.Free(block);
+
+  return FeTrue;
+}
+
+uchar TestFreeListAllocatorDataIntegrity_Success() {
+  memory::FreeListAllocator alloc(FREELIST_TEST_POOL_SIZE, nullptr);
+
+  constexpr uint64 blockCount = 48;
+  uchar *blocks[blockCount];
+  for (uint64 i = 0; i < blockCount; i++) {
+    uint64 size = 16 + (i * 37) % 700;
+    blocks[i] = reinterpret_cast<uchar *>(alloc.Allocate(size));
+    ASSERT_NEQ_PTR(nullptr, blocks[i]);
+    core::memory::MemoryManager::SetMemory(blocks[i], (sint32)i, size);
+  }
+
+  // Punch holes and refill them with different sizes
+  for (uint64 i = 0; i < blockCount; i += 3) {
+    alloc.Free(blocks[i]);
+    blocks[i] = nullptr;
+  }
+  for (uint64 i = 0; i < blockCount; i += 3) {
+    blocks[i] = reinterpret_cast<uchar *>(alloc.Allocate(32));
+    ASSERT_NEQ_PTR(nullptr, blocks[i]);
+    core::memory::MemoryManager::SetMemory(blocks[i], (sint32)i, 32);
+  }
+
+  for (uint64 i = 0; i < blockCount; i++) {
+    uint64 size = (i % 3 == 0) ? 32 : 16 + (i * 37) % 700;
+    for (uint64 j = 0; j < size; j++) {
+      ASSERT_EQ_INT(i, blocks[i][j]);
+    }
+    alloc.Free(blocks[i]);
+  }
+
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+  return FeTrue;
+}
+
+void FreeListAllocatorRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestFreeListAllocatorCreate_Success,
+                  "Free list allocator should create");
+  tm.RegisterTest(TestFreeListAllocatorAllocateAndFree_Success,
+                  "Free list allocator should allocate and free");
+  tm.RegisterTest(TestFreeListAllocatorReusesFreedBlock_Success,
+                  "Free list allocator should reuse freed blocks");
+  tm.RegisterTest(TestFreeListAllocatorCoalescesOnFree_Success,
+                  "Free list allocator should coalesce neighbour blocks");
+  tm.RegisterTest(TestFreeListAllocatorAlignedAllocation_Success,
+                  "Free list allocator should align properly");
+  tm.RegisterTest(TestFreeListAllocatorOutOfMemory_Fails,
+                  "Free list allocator must fail when exhausted");
+  tm.RegisterTest(TestFreeListAllocatorDataIntegrity_Success,
+                  "Free list allocator should keep block contents intact");
+}
+
+} // namespace tests
+} // namespace flatearth
@@ -0,0 +1,14 @@
+#ifndef _FLATEARTH_TESTS_FREE_LIST_ALLOCATOR_HPP
+#define _FLATEARTH_TESTS_FREE_LIST_ALLOCATOR_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void FreeListAllocatorRegisterTests(TestManager &tm);
+
+}
+} // namespace flatearth
+
+#endif // _FLATEARTH_TESTS_FREE_LIST_ALLOCATOR_HPP
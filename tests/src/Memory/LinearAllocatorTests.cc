@@ -215,6 +215,97 @@ uchar TestMultipleAllocatorsFromSingleBuffer_Success() {
   return FeTrue;
 }
 
+uchar TestLinearAllocatorOwnedMemoryCacheAligned_Success() {
+  memory::LinearAllocator alloc(1024, nullptr);
+
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(alloc.GetMemory()) %
+                       core::memory::MEMORY_CACHE_LINE_SIZE);
+
+  // First cache line aligned request must not need any padding
+  void *block = alloc.Allocate(sizeof(uint64), 64);
+  ASSERT_EQ_PTR(alloc.GetMemory(), block);
+  ASSERT_EQ_INT(sizeof(uint64), alloc.GetAllocatedSize());
+
+  return FeTrue;
+}
+
+uchar TestLinearAllocatorInvalidAlignment_Fails() {
+  memory::LinearAllocator alloc(1024, nullptr);
+
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate(sizeof(uint64), 24));
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+
+  return FeTrue;
+}
+
+uchar TestLinearAllocatorFreeAllTouchesUsedBytes_Success() {
+  constexpr uint64 totalSize = 256;
+  constexpr uint64 usedSize = 64;
+  uchar buffer[totalSize];
+  core::memory::MemoryManager::SetMemory(buffer, 0x7F, totalSize);
+
+  memory::LinearAllocator alloc(totalSize, buffer);
+  uchar *block = reinterpret_cast<uchar *>(alloc.Allocate(usedSize, 1));
+  ASSERT_EQ_PTR(buffer, block);
+
+  alloc.FreaAll();
+  for (uint64 i = 0; i < usedSize; i++) {
+    ASSERT_EQ_INT(0, buffer[i]);
+  }
+
+  // Bytes that were never handed out must not be written to
+  for (uint64 i = usedSize; i < totalSize; i++) {
+    ASSERT_EQ_INT(0x7F, buffer[i]);
+  }
+
+  return FeTrue;
+}
+
+uchar TestLinearAllocatorPoisonedFreeAll_Success() {
+  constexpr uint64 totalSize = 128;
+  uchar buffer[totalSize] = {};
+
+  memory::LinearAllocator alloc(totalSize, buffer,
+                                core::memory::ALLOCATION_FLAG_POISONED);
+  uchar *block = reinterpret_cast<uchar *>(alloc.Allocate(32, 1));
+  core::memory::MemoryManager::SetMemory(block, 0x11, 32);
+
+  alloc.FreaAll();
+  uchar expected =
+      MEMORY_POISON_ENABLED ? core::memory::MEMORY_POISON_PATTERN : 0x11;
+  for (uint64 i = 0; i < 32; i++) {
+    ASSERT_EQ_INT(expected, buffer[i]);
+  }
+  ASSERT_EQ_INT(0, buffer[32]);
+
+  return FeTrue;
+}
+
+uchar TestLinearAllocatorLargePages_Success() {
+  constexpr uint64 totalSize = 4 * 1024 * 1024 + 100;
+  memory::LinearAllocator alloc(totalSize, nullptr,
+                                core::memory::ALLOCATION_FLAG_ZEROED |
+                                    core::memory::ALLOCATION_FLAG_LARGE_PAGES);
+
+  ASSERT_NEQ_PTR(nullptr, alloc.GetMemory());
+  if (alloc.GetLargePageKind() != platform::LARGE_PAGE_NONE) {
+    ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(alloc.GetMemory()) %
+                         platform::Platform::PGetLargePageSize());
+  }
+
+  // The whole block must be usable and start out zeroed
+  uchar *block = reinterpret_cast<uchar *>(alloc.Allocate(totalSize, 1));
+  ASSERT_NEQ_PTR(nullptr, block);
+  ASSERT_EQ_INT(0, block[totalSize - 1]);
+  core::memory::MemoryManager::SetMemory(block, 0x5A, totalSize);
+
+  alloc.FreaAll();
+  ASSERT_EQ_INT(0, block[0]);
+  ASSERT_EQ_INT(0, block[totalSize - 1]);
+
+  return FeTrue;
+}
+
 void LinearAllocatorRegisterTests(TestManager &tm) {
   tm.RegisterTest(TestLinearAllocatorCreate_Success,
                   "Linear allocator should create");
@@ -237,6 +328,16 @@ void LinearAllocatorRegisterTests(TestManager &tm) {
   tm.RegisterTest(
       TestMultipleAllocatorsFromSingleBuffer_Success,
       "Multiple linear allocators should work from a shared buffer");
+  tm.RegisterTest(TestLinearAllocatorOwnedMemoryCacheAligned_Success,
+                  "Linear allocator owned memory should be cache line aligned");
+  tm.RegisterTest(TestLinearAllocatorInvalidAlignment_Fails,
+                  "Linear allocator must reject non power of 2 alignments");
+  tm.RegisterTest(TestLinearAllocatorFreeAllTouchesUsedBytes_Success,
+                  "Linear allocator FreaAll() should only clear used bytes");
+  tm.RegisterTest(TestLinearAllocatorPoisonedFreeAll_Success,
+                  "Linear allocator should poison released bytes");
+  tm.RegisterTest(TestLinearAllocatorLargePages_Success,
+                  "Linear allocator should work on large pages");
 }
 
 } // namespace tests
@@ -0,0 +1,261 @@
+#include "MemoryManagerTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Core/FeMemory.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestMemoryManagerStatsTrackAllocations_Success() {
+  core::memory::MemoryBlock before = core::memory::MemoryManager::GetStats();
+
+  void *block = core::memory::MemoryManager::Allocate(
+      128, core::memory::MEMORY_TAG_JOB);
+  ASSERT_NEQ_PTR(nullptr, block);
+
+  core::memory::MemoryBlock during = core::memory::MemoryManager::GetStats();
+  ASSERT_EQ_INT(before.totalAllocated + 128, during.totalAllocated);
+  ASSERT_EQ_INT(before.allocCount + 1, during.allocCount);
+  ASSERT_EQ_INT(
+      before.taggedAllocations[core::memory::MEMORY_TAG_JOB] + 128,
+      during.taggedAllocations[core::memory::MEMORY_TAG_JOB]);
+
+  core::memory::MemoryManager::Free(block, 128, core::memory::MEMORY_TAG_JOB);
+
+  core::memory::MemoryBlock after = core::memory::MemoryManager::GetStats();
+  ASSERT_EQ_INT(before.totalAllocated, after.totalAllocated);
+  ASSERT_EQ_INT(before.taggedAllocations[core::memory::MEMORY_TAG_JOB],
+                after.taggedAllocations[core::memory::MEMORY_TAG_JOB]);
+
+  return FeTrue;
+}
+
+uchar TestMemoryManagerStatsAcrossThreads_Success() {
+  constexpr uint64 threadCount = 8;
+  constexpr uint64 iterations = 2000;
+  core::memory::MemoryBlock before = core::memory::MemoryManager::GetStats();
+
+  // Blocks allocated on one thread are freed on another on purpose
+  std::vector<void *> handoff(threadCount * iterations, nullptr);
+  std::vector<std::thread> workers;
+  for (uint64 t = 0; t < threadCount; t++) {
+    workers.emplace_back([&handoff, t]() {
+      for (uint64 i = 0; i < iterations; i++) {
+        void *block = core::memory::MemoryManager::Allocate(
+            32, core::memory::MEMORY_TAG_JOB);
+        core::memory::MemoryManager::Free(block, 32,
+                                          core::memory::MEMORY_TAG_JOB);
+        handoff[t * iterations + i] = core::memory::MemoryManager::Allocate(
+            16, core::memory::MEMORY_TAG_ENTITY);
+      }
+    });
+  }
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+
+  core::memory::MemoryBlock during = core::memory::MemoryManager::GetStats();
+  ASSERT_EQ_INT(before.totalAllocated + threadCount * iterations * 16,
+                during.totalAllocated);
+  ASSERT_EQ_INT(before.allocCount + threadCount * iterations * 2,
+                during.allocCount);
+
+  std::thread releaser([&handoff]() {
+    for (void *block : handoff) {
+      core::memory::MemoryManager::Free(block, 16,
+                                        core::memory::MEMORY_TAG_ENTITY);
+    }
+  });
+  releaser.join();
+
+  core::memory::MemoryBlock after = core::memory::MemoryManager::GetStats();
+  ASSERT_EQ_INT(before.totalAllocated, after.totalAllocated);
+  ASSERT_EQ_INT(before.taggedAllocations[core::memory::MEMORY_TAG_ENTITY],
+                after.taggedAllocations[core::memory::MEMORY_TAG_ENTITY]);
+
+  return FeTrue;
+}
+
+uchar TestMemoryManagerPeaksAndCounts_Success() {
+  constexpr core::memory::MemoryTag tag = core::memory::MEMORY_TAG_SCENE;
+  core::memory::MemoryBlock before = core::memory::MemoryManager::GetStats();
+
+  void *first = core::memory::MemoryManager::Allocate(4096, tag);
+  void *second = core::memory::MemoryManager::Allocate(4096, tag);
+  core::memory::MemoryManager::Update();
+  core::memory::MemoryManager::Free(first, 4096, tag);
+  core::memory::MemoryManager::Free(second, 4096, tag);
+
+  core::memory::MemoryBlock after = core::memory::MemoryManager::GetStats();
+  ASSERT_EQ_INT(before.taggedAllocations[tag], after.taggedAllocations[tag]);
+  ASSERT_TRUE(after.taggedPeaks[tag] >= before.taggedAllocations[tag] + 8192);
+  ASSERT_EQ_INT(before.taggedAllocCounts[tag] + 2, after.taggedAllocCounts[tag]);
+  ASSERT_EQ_INT(before.taggedFreeCounts[tag] + 2, after.taggedFreeCounts[tag]);
+
+  return FeTrue;
+}
+
+uchar TestMemoryManagerBudgetExceeded_Success() {
+  constexpr core::memory::MemoryTag tag = core::memory::MEMORY_TAG_TEXTURE;
+  uint64 base = core::memory::MemoryManager::GetStats().taggedAllocations[tag];
+
+  uint64 calls = 0;
+  uint64 reported = 0;
+  uint64 reportedBudget = 0;
+  core::memory::MemoryTag reportedTag = core::memory::MEMORY_TAG_UNKNOWN;
+  core::memory::MemoryManager::SetBudgetCallback(
+      [&](core::memory::MemoryTag overTag, uint64 allocated, uint64 budget) {
+        calls++;
+        reportedTag = overTag;
+        reported = allocated;
+        reportedBudget = budget;
+      });
+  core::memory::MemoryManager::SetBudget(tag, base + 1024);
+  ASSERT_EQ_INT(base + 1024, core::memory::MemoryManager::GetBudget(tag));
+
+  void *block = core::memory::MemoryManager::Allocate(512, tag);
+  core::memory::MemoryManager::Update();
+  ASSERT_EQ_INT(0, calls);
+
+  void *extra = core::memory::MemoryManager::Allocate(1024, tag);
+  core::memory::MemoryManager::Update();
+  core::memory::MemoryManager::Update();
+  ASSERT_EQ_INT(1, calls);
+  ASSERT_EQ_INT(tag, reportedTag);
+  ASSERT_EQ_INT(base + 1536, reported);
+  ASSERT_EQ_INT(base + 1024, reportedBudget);
+
+  // Dropping under the budget re-arms the report
+  core::memory::MemoryManager::Free(extra, 1024, tag);
+  core::memory::MemoryManager::Update();
+  extra = core::memory::MemoryManager::Allocate(1024, tag);
+  core::memory::MemoryManager::Update();
+  ASSERT_EQ_INT(2, calls);
+
+  core::memory::MemoryManager::Free(extra, 1024, tag);
+  core::memory::MemoryManager::Free(block, 512, tag);
+  core::memory::MemoryManager::SetBudget(tag, 0);
+  core::memory::MemoryManager::SetBudgetCallback(nullptr);
+
+  return FeTrue;
+}
+
+uchar TestMemoryManagerDumpUsage_Success() {
+  std::string json = core::memory::MemoryManager::DumpMemoryUsage(
+      core::memory::MEMORY_REPORT_JSON);
+  ASSERT_TRUE(json.front() == '{');
+  ASSERT_TRUE(json.find("\"tag\":\"DARRAY\"") != std::string::npos);
+  ASSERT_TRUE(json.find("\"budget\":") != std::string::npos);
+
+  std::string csv = core::memory::MemoryManager::DumpMemoryUsage(
+      core::memory::MEMORY_REPORT_CSV);
+  ASSERT_EQ_INT(0, csv.find("tag,allocated,peak,budget,"));
+
+  // Header plus one line per tag
+  uint64 lines = 0;
+  for (char c : csv) {
+    lines += c == '\n';
+  }
+  ASSERT_EQ_INT(core::memory::MEMORY_TAG_MAX_TAGS + 1, lines);
+
+  return FeTrue;
+}
+
+uchar TestMemoryManagerCompactDeleters_Success() {
+  constexpr uint64 packed = core::memory::PackAllocation(
+      (1ull << 40) + 3, core::memory::MEMORY_TAG_SCENE, 4096);
+  ASSERT_EQ_INT((1ull << 40) + 3, core::memory::PackedSize(packed));
+  ASSERT_EQ_INT(core::memory::MEMORY_TAG_SCENE,
+                core::memory::PackedTag(packed));
+  ASSERT_EQ_INT(4096, core::memory::PackedAlignment(packed));
+
+  ASSERT_EQ_INT(3 * sizeof(void *), sizeof(unique_void_ptr));
+
+  uint64 before = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_SCENE];
+  {
+    void *block = core::memory::MemoryManager::Allocate(
+        256, core::memory::MEMORY_TAG_SCENE);
+    unique_void_ptr owner = core::memory::make_unique_void(
+        block, 256, core::memory::MEMORY_TAG_SCENE, FeTrue);
+
+    using Deleter = core::memory::StatefulCustomDeleter<uint64>;
+    void *typedBlock = core::memory::MemoryManager::Allocate(
+        64, 64, core::memory::MEMORY_TAG_SCENE);
+    std::unique_ptr<uint64, Deleter> typed(
+        static_cast<uint64 *>(typedBlock),
+        Deleter(64, core::memory::MEMORY_TAG_SCENE, 64));
+    ASSERT_EQ_INT(2 * sizeof(void *), sizeof(typed));
+
+    uint64 during = core::memory::MemoryManager::GetStats()
+                        .taggedAllocations[core::memory::MEMORY_TAG_SCENE];
+    ASSERT_EQ_INT(before + 320, during);
+  }
+
+  uint64 after = core::memory::MemoryManager::GetStats()
+                     .taggedAllocations[core::memory::MEMORY_TAG_SCENE];
+  ASSERT_EQ_INT(before, after);
+
+  return FeTrue;
+}
+
+uchar TestMemoryManagerReallocate_Success() {
+  uint64 before = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_SCENE];
+
+  uchar *block = static_cast<uchar *>(core::memory::MemoryManager::Allocate(
+      64, 16, core::memory::MEMORY_TAG_SCENE));
+  core::memory::MemoryManager::SetMemory(block, 0xAB, 64);
+
+  // Large enough for the platform to remap rather than copy
+  uint64 largeSize = 4 * 1024 * 1024;
+  block = static_cast<uchar *>(core::memory::MemoryManager::Reallocate(
+      block, 64, largeSize, 16, core::memory::MEMORY_TAG_SCENE));
+  ASSERT_NEQ_PTR(nullptr, block);
+  ASSERT_EQ_INT(0xAB, block[0]);
+  ASSERT_EQ_INT(0xAB, block[63]);
+  ASSERT_EQ_INT(0, block[64]);
+  ASSERT_EQ_INT(0, block[largeSize - 1]);
+  ASSERT_EQ_INT(before + largeSize,
+                core::memory::MemoryManager::GetStats()
+                    .taggedAllocations[core::memory::MEMORY_TAG_SCENE]);
+
+  // Over-aligned blocks keep their alignment
+  uchar *aligned = static_cast<uchar *>(core::memory::MemoryManager::Reallocate(
+      block, largeSize, 128, 256, core::memory::MEMORY_TAG_SCENE));
+  ASSERT_NEQ_PTR(nullptr, aligned);
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(aligned) % 256);
+  ASSERT_EQ_INT(0xAB, aligned[63]);
+
+  core::memory::MemoryManager::Free(aligned, 128, 256,
+                                    core::memory::MEMORY_TAG_SCENE);
+  ASSERT_EQ_INT(before, core::memory::MemoryManager::GetStats()
+                            .taggedAllocations[core::memory::MEMORY_TAG_SCENE]);
+
+  return FeTrue;
+}
+
+void MemoryManagerRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestMemoryManagerStatsTrackAllocations_Success,
+                  "Memory manager stats should track allocations");
+  tm.RegisterTest(TestMemoryManagerStatsAcrossThreads_Success,
+                  "Memory manager stats should stay exact across threads");
+  tm.RegisterTest(TestMemoryManagerPeaksAndCounts_Success,
+                  "Memory manager should track peaks and counts per tag");
+  tm.RegisterTest(TestMemoryManagerBudgetExceeded_Success,
+                  "Memory manager should report budget overruns once");
+  tm.RegisterTest(TestMemoryManagerDumpUsage_Success,
+                  "Memory manager should dump JSON and CSV reports");
+  tm.RegisterTest(TestMemoryManagerCompactDeleters_Success,
+                  "Owning pointers should free through packed deleters");
+  tm.RegisterTest(TestMemoryManagerReallocate_Success,
+                  "Memory manager should reallocate keeping contents");
+}
+
+} // namespace tests
+} // namespace flatearth
@@ -0,0 +1,14 @@
+#ifndef _FLATEARTH_TESTS_MEMORY_MANAGER_HPP
+#define _FLATEARTH_TESTS_MEMORY_MANAGER_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void MemoryManagerRegisterTests(TestManager &tm);
+
+}
+} // namespace flatearth
+
+#endif // _FLATEARTH_TESTS_MEMORY_MANAGER_HPP
@@ -0,0 +1,162 @@
+#include "PoolAllocatorTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Memory/PoolAllocator.hpp>
+#include <Memory/Utils.hpp>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestPoolAllocatorCreate_Success() {
+  memory::PoolAllocator alloc(24, 16, nullptr);
+
+  ASSERT_EQ_INT(24, alloc.GetBlockSize());
+  ASSERT_EQ_INT(16, alloc.GetCapacity());
+  ASSERT_EQ_INT(0, alloc.GetAllocatedCount());
+  ASSERT_EQ_INT(1, alloc.GetChunkCount());
+
+  return FeTrue;
+}
+
+uchar TestPoolAllocatorAllocateAndFree_Success() {
+  memory::PoolAllocator alloc(32, 8, nullptr);
+
+  void *first = alloc.Allocate();
+  void *second = alloc.Allocate();
+  ASSERT_NEQ_PTR(nullptr, first);
+  ASSERT_NEQ_PTR(nullptr, second);
+  ASSERT_TRUE(alloc.Owns(first));
+  ASSERT_EQ_INT(32, reinterpret_cast<uchar *>(second) -
+                        reinterpret_cast<uchar *>(first));
+  ASSERT_EQ_INT(2, alloc.GetAllocatedCount());
+
+  // Last freed block is handed out first
+  alloc.Free(first);
+  ASSERT_EQ_PTR(first, alloc.Allocate());
+
+  alloc.Free(first);
+  alloc.Free(second);
+  ASSERT_EQ_INT(0, alloc.GetAllocatedCount());
+
+  return FeTrue;
+}
+
+uchar TestPoolAllocatorAlignedBlocks_Success() {
+  memory::PoolAllocator alloc(20, 8, nullptr, 64);
+
+  ASSERT_EQ_INT(64, alloc.GetBlockSize());
+  for (uint64 i = 0; i < 8; i++) {
+    void *block = alloc.Allocate();
+    ASSERT_NEQ_PTR(nullptr, block);
+    ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(block) % 64);
+  }
+
+  return FeTrue;
+}
+
+uchar TestPoolAllocatorExhausted_Fails() {
+  memory::PoolAllocator alloc(16, 4, nullptr);
+
+  for (uint64 i = 0; i < 4; i++) {
+    ASSERT_NEQ_PTR(nullptr, alloc.Allocate());
+  }
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate());
+
+  return FeTrue;
+}
+
+uchar TestPoolAllocatorGrowable_Success() {
+  memory::PoolAllocator alloc(16, 4, nullptr, alignof(void *), FeTrue);
+
+  void *blocks[10];
+  for (uint64 i = 0; i < 10; i++) {
+    blocks[i] = alloc.Allocate();
+    ASSERT_NEQ_PTR(nullptr, blocks[i]);
+  }
+
+  ASSERT_EQ_INT(3, alloc.GetChunkCount());
+  ASSERT_EQ_INT(12, alloc.GetCapacity());
+  for (uint64 i = 0; i < 10; i++) {
+    ASSERT_TRUE(alloc.Owns(blocks[i]));
+  }
+
+  alloc.FreeAll();
+  ASSERT_EQ_INT(0, alloc.GetAllocatedCount());
+  ASSERT_EQ_INT(3, alloc.GetChunkCount());
+
+  return FeTrue;
+}
+
+uchar TestPoolAllocatorExternalMemory_Success() {
+  uchar buffer[512];
+  uint64 required = memory::PoolAllocator::GetMemoryRequirement(16, 8, 16);
+  ASSERT_TRUE(required <= sizeof(buffer));
+
+  memory::PoolAllocator alloc(16, 8, buffer + 1, 16);
+  ASSERT_EQ_INT(0, alloc.GetChunkCount());
+  ASSERT_EQ_INT(8, alloc.GetCapacity());
+
+  for (uint64 i = 0; i < 8; i++) {
+    uchar *block = reinterpret_cast<uchar *>(alloc.Allocate());
+    ASSERT_NEQ_PTR(nullptr, block);
+    ASSERT_TRUE(block >= buffer && block + 16 <= buffer + required + 1);
+  }
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate());
+
+  return FeTrue;
+}
+
+struct PoolTestObject {
+  uint64 id;
+  float32 weight;
+  static uint64 liveCount;
+
+  PoolTestObject(uint64 id, float32 weight) : id(id), weight(weight) {
+    liveCount++;
+  }
+  ~PoolTestObject() { liveCount--; }
+};
+
+uint64 PoolTestObject::liveCount = 0;
+
+uchar TestPoolAllocatorAllocateObject_Success() {
+  memory::PoolAllocator alloc(sizeof(PoolTestObject), 4, nullptr,
+                              alignof(PoolTestObject));
+
+  PoolTestObject *obj = memory::AllocateObject<PoolTestObject>(alloc, 7, 2.5f);
+  ASSERT_NEQ_PTR(nullptr, obj);
+  ASSERT_EQ_INT(7, obj->id);
+  ASSERT_EQ_FLOAT(2.5f, obj->weight);
+  ASSERT_EQ_INT(1, PoolTestObject::liveCount);
+
+  memory::FreeObject(alloc, obj);
+  ASSERT_EQ_INT(0, PoolTestObject::liveCount);
+  ASSERT_EQ_INT(0, alloc.GetAllocatedCount());
+
+  // Objects that do not fit in a block are rejected
+  memory::PoolAllocator small(8, 4, nullptr);
+  ASSERT_EQ_PTR(nullptr, memory::AllocateObject<PoolTestObject>(small, 1, 1.0f));
+
+  return FeTrue;
+}
+
+void PoolAllocatorRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestPoolAllocatorCreate_Success,
+                  "Pool allocator should create");
+  tm.RegisterTest(TestPoolAllocatorAllocateAndFree_Success,
+                  "Pool allocator should allocate and free");
+  tm.RegisterTest(TestPoolAllocatorAlignedBlocks_Success,
+                  "Pool allocator should align blocks");
+  tm.RegisterTest(TestPoolAllocatorExhausted_Fails,
+                  "Pool allocator must fail when exhausted");
+  tm.RegisterTest(TestPoolAllocatorGrowable_Success,
+                  "Pool allocator should grow by chunks");
+  tm.RegisterTest(TestPoolAllocatorExternalMemory_Success,
+                  "Pool allocator should use provided memory");
+  tm.RegisterTest(TestPoolAllocatorAllocateObject_Success,
+                  "Pool allocator should construct and destroy objects");
+}
+
+} // namespace tests
+} // namespace flatearth
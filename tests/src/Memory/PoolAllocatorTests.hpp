@@ -0,0 +1,14 @@
+#ifndef _FLATEARTH_TESTS_POOL_ALLOCATOR_HPP
+#define _FLATEARTH_TESTS_POOL_ALLOCATOR_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void PoolAllocatorRegisterTests(TestManager &tm);
+
+}
+} // namespace flatearth
+
+#endif // _FLATEARTH_TESTS_POOL_ALLOCATOR_HPP
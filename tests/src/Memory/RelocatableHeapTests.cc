@@ -0,0 +1,184 @@
+#include "RelocatableHeapTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Core/FeMemory.hpp>
+#include <Memory/RelocatableHeap.hpp>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestRelocatableHeapAllocateAndResolve_Success() {
+  memory::RelocatableHeap heap(1024, 8);
+
+  memory::MemoryHandle first =
+      heap.Allocate(20, core::memory::MEMORY_TAG_GAME);
+  memory::MemoryHandle second =
+      heap.Allocate(32, core::memory::MEMORY_TAG_TEXTURE);
+  ASSERT_TRUE(first.IsValid());
+  ASSERT_TRUE(second.IsValid());
+  ASSERT_FALSE(first == second);
+
+  uchar *block = static_cast<uchar *>(heap.Resolve(first));
+  ASSERT_NEQ_PTR(nullptr, block);
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(block) %
+                       memory::RelocatableHeap::RELOCATABLE_HEAP_ALIGNMENT);
+  ASSERT_EQ_INT(0, block[19]);
+
+  ASSERT_EQ_INT(2, heap.GetHandleCount());
+  ASSERT_EQ_INT(64, heap.GetLiveSize());
+  ASSERT_EQ_INT(32, heap.GetTaggedLiveSize(core::memory::MEMORY_TAG_GAME));
+  ASSERT_EQ_INT(32, heap.GetTaggedLiveSize(core::memory::MEMORY_TAG_TEXTURE));
+
+  heap.Free(first);
+  heap.Free(second);
+  ASSERT_EQ_INT(0, heap.GetHandleCount());
+  ASSERT_EQ_INT(0, heap.GetLiveSize());
+
+  return FeTrue;
+}
+
+uchar TestRelocatableHeapStaleHandle_Fails() {
+  memory::RelocatableHeap heap(1024, 4);
+
+  memory::MemoryHandle handle =
+      heap.Allocate(16, core::memory::MEMORY_TAG_GAME);
+  heap.Free(handle);
+  ASSERT_FALSE(heap.IsValid(handle));
+  ASSERT_EQ_PTR(nullptr, heap.Resolve(handle));
+  ASSERT_FALSE(heap.IsValid(memory::INVALID_MEMORY_HANDLE));
+
+  // The entry is reused with a new generation, the old handle stays stale
+  memory::MemoryHandle reused =
+      heap.Allocate(16, core::memory::MEMORY_TAG_GAME);
+  ASSERT_EQ_INT(handle.index, reused.index);
+  ASSERT_FALSE(heap.IsValid(handle));
+  ASSERT_TRUE(heap.IsValid(reused));
+
+  // Out of memory and out of handles both hand back invalid handles
+  ASSERT_FALSE(heap.Allocate(4096, core::memory::MEMORY_TAG_GAME).IsValid());
+  for (uint32 i = 0; i < 3; i++) {
+    ASSERT_TRUE(heap.Allocate(16, core::memory::MEMORY_TAG_GAME).IsValid());
+  }
+  ASSERT_FALSE(heap.Allocate(16, core::memory::MEMORY_TAG_GAME).IsValid());
+
+  return FeTrue;
+}
+
+uchar TestRelocatableHeapDefragment_Success() {
+  memory::RelocatableHeap heap(4096, 16);
+
+  memory::MemoryHandle handles[8];
+  for (uint32 i = 0; i < 8; i++) {
+    handles[i] = heap.Allocate(48, core::memory::MEMORY_TAG_GAME);
+    core::memory::MemoryManager::SetMemory(heap.Resolve(handles[i]), i + 1,
+                                           48);
+  }
+
+  // 64B per block with its header
+  ASSERT_EQ_INT(512, heap.GetUsedSize());
+  for (uint32 i = 0; i < 8; i += 2) {
+    heap.Free(handles[i]);
+  }
+  ASSERT_EQ_INT(512, heap.GetUsedSize());
+  ASSERT_EQ_INT(256, heap.GetFragmentedSize());
+
+  ASSERT_EQ_INT(256, heap.Defragment(1.0));
+  ASSERT_FALSE(heap.IsDefragmenting());
+  ASSERT_EQ_INT(256, heap.GetUsedSize());
+  ASSERT_EQ_INT(0, heap.GetFragmentedSize());
+
+  // Survivors are packed in order and kept their contents
+  uchar *previous = nullptr;
+  for (uint32 i = 1; i < 8; i += 2) {
+    uchar *block = static_cast<uchar *>(heap.Resolve(handles[i]));
+    ASSERT_NEQ_PTR(nullptr, block);
+    ASSERT_EQ_INT(i + 1, block[0]);
+    ASSERT_EQ_INT(i + 1, block[47]);
+    if (previous) {
+      ASSERT_EQ_INT(64, block - previous);
+    }
+    previous = block;
+  }
+
+  // Nothing left to do
+  ASSERT_EQ_INT(0, heap.Defragment(1.0));
+
+  return FeTrue;
+}
+
+uchar TestRelocatableHeapIncrementalDefragment_Success() {
+  memory::RelocatableHeap heap(4096, 32);
+
+  memory::MemoryHandle handles[16];
+  for (uint32 i = 0; i < 16; i++) {
+    handles[i] = heap.Allocate(16, core::memory::MEMORY_TAG_GAME);
+    *static_cast<uint32 *>(heap.Resolve(handles[i])) = i;
+  }
+  heap.Free(handles[0]);
+
+  // A zero budget still moves one block per call
+  uint64 reclaimed = heap.Defragment(0.0);
+  ASSERT_EQ_INT(32, reclaimed);
+  ASSERT_TRUE(heap.IsDefragmenting());
+
+  uint32 calls = 1;
+  while (heap.IsDefragmenting()) {
+    // Handles resolve and new blocks can be allocated in between
+    ASSERT_EQ_INT(calls, *static_cast<uint32 *>(heap.Resolve(handles[calls])));
+    heap.Defragment(0.0);
+    calls++;
+  }
+  ASSERT_EQ_INT(16, calls);
+  ASSERT_EQ_INT(15 * 32, heap.GetUsedSize());
+
+  for (uint32 i = 1; i < 16; i++) {
+    ASSERT_EQ_INT(i, *static_cast<uint32 *>(heap.Resolve(handles[i])));
+  }
+
+  return FeTrue;
+}
+
+uchar TestRelocatableHeapReclaimedByTag_Success() {
+  core::memory::MemoryBlock before = core::memory::MemoryManager::GetStats();
+
+  memory::RelocatableHeap heap(2048, 8);
+  memory::MemoryHandle texture =
+      heap.Allocate(100, core::memory::MEMORY_TAG_TEXTURE);
+  memory::MemoryHandle game = heap.Allocate(64, core::memory::MEMORY_TAG_GAME);
+  memory::MemoryHandle kept = heap.Allocate(8, core::memory::MEMORY_TAG_GAME);
+  heap.Free(texture);
+  heap.Free(game);
+
+  heap.Defragment(1.0);
+  ASSERT_EQ_INT(128, heap.GetTaggedReclaimedSize(
+                         core::memory::MEMORY_TAG_TEXTURE));
+  ASSERT_EQ_INT(80,
+                heap.GetTaggedReclaimedSize(core::memory::MEMORY_TAG_GAME));
+
+  core::memory::MemoryBlock after = core::memory::MemoryManager::GetStats();
+  ASSERT_EQ_INT(
+      128, after.taggedReclaimed[core::memory::MEMORY_TAG_TEXTURE] -
+               before.taggedReclaimed[core::memory::MEMORY_TAG_TEXTURE]);
+  ASSERT_EQ_INT(80, after.taggedReclaimed[core::memory::MEMORY_TAG_GAME] -
+                        before.taggedReclaimed[core::memory::MEMORY_TAG_GAME]);
+
+  heap.Free(kept);
+  return FeTrue;
+}
+
+void RelocatableHeapRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestRelocatableHeapAllocateAndResolve_Success,
+                  "Relocatable heap should allocate and resolve handles");
+  tm.RegisterTest(TestRelocatableHeapStaleHandle_Fails,
+                  "Relocatable heap must reject stale handles");
+  tm.RegisterTest(TestRelocatableHeapDefragment_Success,
+                  "Relocatable heap should compact live blocks");
+  tm.RegisterTest(TestRelocatableHeapIncrementalDefragment_Success,
+                  "Relocatable heap should compact within a time budget");
+  tm.RegisterTest(TestRelocatableHeapReclaimedByTag_Success,
+                  "Relocatable heap should report reclaimed bytes per tag");
+}
+
+} // namespace tests
+} // namespace flatearth
@@ -0,0 +1,14 @@
+#ifndef _FLATEARTH_TESTS_RELOCATABLE_HEAP_HPP
+#define _FLATEARTH_TESTS_RELOCATABLE_HEAP_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void RelocatableHeapRegisterTests(TestManager &tm);
+
+}
+} // namespace flatearth
+
+#endif // _FLATEARTH_TESTS_RELOCATABLE_HEAP_HPP
@@ -0,0 +1,103 @@
+#include "StackAllocatorTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Memory/StackAllocator.hpp>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestStackAllocatorFreeToMarker_Success() {
+  memory::StackAllocator alloc(1024, nullptr);
+
+  void *level = alloc.Allocate(128);
+  ASSERT_NEQ_PTR(nullptr, level);
+  memory::StackMarker marker = alloc.GetMarker();
+  ASSERT_EQ_INT(128, marker);
+
+  uchar *scratch = reinterpret_cast<uchar *>(alloc.Allocate(256, 64));
+  ASSERT_NEQ_PTR(nullptr, scratch);
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(scratch) % 64);
+  scratch[0] = 0xAB;
+
+  alloc.FreeToMarker(marker);
+  ASSERT_EQ_INT(128, alloc.GetAllocatedSize());
+  ASSERT_EQ_INT(0, scratch[0]);
+
+  // Next allocation reuses the released space
+  ASSERT_EQ_PTR(scratch, alloc.Allocate(256, 64));
+
+  alloc.FreeAll();
+  ASSERT_EQ_INT(0, alloc.GetAllocatedSize());
+
+  return FeTrue;
+}
+
+uchar TestStackAllocatorInvalidMarker_Fails() {
+  memory::StackAllocator alloc(256, nullptr);
+
+  alloc.Allocate(64);
+  alloc.FreeToMarker(128);
+  ASSERT_EQ_INT(64, alloc.GetAllocatedSize());
+  ASSERT_EQ_PTR(nullptr, alloc.Allocate(512));
+
+  return FeTrue;
+}
+
+uchar TestDoubleEndedStackAllocatorBothEnds_Success() {
+  memory::DoubleEndedStackAllocator alloc(1024, nullptr);
+  uchar *base = reinterpret_cast<uchar *>(alloc.GetMemory());
+
+  uchar *lower = reinterpret_cast<uchar *>(alloc.AllocateLower(100));
+  uchar *upper = reinterpret_cast<uchar *>(alloc.AllocateUpper(100, 16));
+  ASSERT_EQ_PTR(base, lower);
+  ASSERT_NEQ_PTR(nullptr, upper);
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(upper) % 16);
+  ASSERT_TRUE(upper + 100 <= base + 1024);
+  ASSERT_TRUE(upper >= lower + 100);
+
+  ASSERT_EQ_INT(100, alloc.GetLowerAllocatedSize());
+  ASSERT_TRUE(alloc.GetUpperAllocatedSize() >= 100);
+
+  // Scratch at the top can be dropped without touching the lower end
+  memory::StackMarker marker = alloc.GetUpperMarker();
+  ASSERT_NEQ_PTR(nullptr, alloc.AllocateUpper(200));
+  alloc.FreeToUpperMarker(marker);
+  ASSERT_EQ_INT(marker, alloc.GetUpperMarker());
+
+  alloc.FreeUpper();
+  ASSERT_EQ_INT(0, alloc.GetUpperAllocatedSize());
+  ASSERT_EQ_INT(100, alloc.GetLowerAllocatedSize());
+
+  alloc.FreeAll();
+  ASSERT_EQ_INT(1024, alloc.GetFreeSize());
+
+  return FeTrue;
+}
+
+uchar TestDoubleEndedStackAllocatorCollision_Fails() {
+  memory::DoubleEndedStackAllocator alloc(256, nullptr);
+
+  ASSERT_NEQ_PTR(nullptr, alloc.AllocateLower(128));
+  ASSERT_NEQ_PTR(nullptr, alloc.AllocateUpper(96));
+  ASSERT_EQ_PTR(nullptr, alloc.AllocateLower(64));
+  ASSERT_EQ_PTR(nullptr, alloc.AllocateUpper(64));
+  ASSERT_NEQ_PTR(nullptr, alloc.AllocateUpper(32));
+  ASSERT_EQ_INT(0, alloc.GetFreeSize());
+
+  return FeTrue;
+}
+
+void StackAllocatorRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestStackAllocatorFreeToMarker_Success,
+                  "Stack allocator should roll back to a marker");
+  tm.RegisterTest(TestStackAllocatorInvalidMarker_Fails,
+                  "Stack allocator must reject markers above the top");
+  tm.RegisterTest(TestDoubleEndedStackAllocatorBothEnds_Success,
+                  "Double ended stack allocator should allocate from both ends");
+  tm.RegisterTest(TestDoubleEndedStackAllocatorCollision_Fails,
+                  "Double ended stack allocator must fail when ends meet");
+}
+
+} // namespace tests
+} // namespace flatearth
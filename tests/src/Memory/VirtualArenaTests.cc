@@ -0,0 +1,114 @@
+#include "VirtualArenaTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Math/FeMath.hpp>
+#include <Memory/VirtualArena.hpp>
+
+namespace flatearth {
+namespace tests {
+
+constexpr uint64 VIRTUAL_ARENA_TEST_RESERVE = 256ull * 1024 * 1024;
+constexpr uint64 VIRTUAL_ARENA_TEST_COMMIT = 64 * 1024;
+
+uchar TestVirtualArenaCommitsOnDemand_Success() {
+  memory::VirtualArena arena(VIRTUAL_ARENA_TEST_RESERVE,
+                             VIRTUAL_ARENA_TEST_COMMIT);
+
+  ASSERT_NEQ_PTR(nullptr, arena.GetMemory());
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_RESERVE, arena.GetReservedSize());
+  ASSERT_EQ_INT(0, arena.GetCommittedSize());
+
+  uchar *block = reinterpret_cast<uchar *>(arena.Allocate(100));
+  ASSERT_EQ_PTR(arena.GetMemory(), block);
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_COMMIT, arena.GetCommittedSize());
+  block[99] = 1;
+
+  // Crossing the committed boundary commits just enough to fit
+  uchar *big = reinterpret_cast<uchar *>(
+      arena.Allocate(VIRTUAL_ARENA_TEST_COMMIT * 3, 16));
+  ASSERT_NEQ_PTR(nullptr, big);
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_COMMIT * 4, arena.GetCommittedSize());
+  big[VIRTUAL_ARENA_TEST_COMMIT * 3 - 1] = 1;
+
+  // Earlier pointers are untouched by the growth
+  ASSERT_EQ_INT(1, block[99]);
+
+  return FeTrue;
+}
+
+uchar TestVirtualArenaDecommit_Success() {
+  memory::VirtualArena arena(VIRTUAL_ARENA_TEST_RESERVE,
+                             VIRTUAL_ARENA_TEST_COMMIT);
+
+  uchar *block = reinterpret_cast<uchar *>(
+      arena.Allocate(VIRTUAL_ARENA_TEST_COMMIT * 8));
+  core::memory::MemoryManager::SetMemory(block, 0xAB,
+                                         VIRTUAL_ARENA_TEST_COMMIT * 8);
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_COMMIT * 8, arena.GetCommittedSize());
+
+  arena.FreeAll();
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_COMMIT * 8, arena.GetPeakSize());
+
+  // Keep two commit steps around, the rest goes back to the system
+  arena.Decommit(VIRTUAL_ARENA_TEST_COMMIT * 2);
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_COMMIT * 2, arena.GetCommittedSize());
+
+  // Recommitted pages read as zero
+  uchar *again = reinterpret_cast<uchar *>(
+      arena.Allocate(VIRTUAL_ARENA_TEST_COMMIT * 8));
+  ASSERT_EQ_PTR(block, again);
+  ASSERT_EQ_INT(0, again[0]);
+  ASSERT_EQ_INT(0, again[VIRTUAL_ARENA_TEST_COMMIT * 8 - 1]);
+
+  return FeTrue;
+}
+
+uchar TestVirtualArenaExhausted_Fails() {
+  memory::VirtualArena arena(VIRTUAL_ARENA_TEST_COMMIT * 2,
+                             VIRTUAL_ARENA_TEST_COMMIT);
+
+  ASSERT_NEQ_PTR(nullptr, arena.Allocate(VIRTUAL_ARENA_TEST_COMMIT));
+  ASSERT_EQ_PTR(nullptr, arena.Allocate(VIRTUAL_ARENA_TEST_COMMIT * 2));
+  ASSERT_EQ_PTR(nullptr, arena.Allocate(16, 24));
+  // Would wrap the allocated size back under the reservation
+  ASSERT_EQ_PTR(nullptr, arena.Allocate(UINT64_MAX - 8));
+  ASSERT_EQ_INT(VIRTUAL_ARENA_TEST_COMMIT, arena.GetAllocatedSize());
+
+  return FeTrue;
+}
+
+uchar TestVirtualArenaLargePages_Success() {
+  memory::VirtualArena arena(VIRTUAL_ARENA_TEST_RESERVE,
+                             VIRTUAL_ARENA_TEST_COMMIT,
+                             core::memory::ALLOCATION_FLAG_ZEROED |
+                                 core::memory::ALLOCATION_FLAG_LARGE_PAGES);
+  uint64 largePageSize = platform::Platform::PGetLargePageSize();
+  ASSERT_TRUE(math::IsPowerOf2(largePageSize));
+  ASSERT_EQ_INT(0, largePageSize % platform::Platform::PGetPageSize());
+
+  ASSERT_EQ_INT(0,
+                reinterpret_cast<uintptr_t>(arena.GetMemory()) % largePageSize);
+
+  // Commits happen in whole huge pages
+  uchar *block = reinterpret_cast<uchar *>(arena.Allocate(100));
+  ASSERT_NEQ_PTR(nullptr, block);
+  ASSERT_EQ_INT(largePageSize, arena.GetCommittedSize());
+  block[largePageSize - 1] = 1;
+
+  return FeTrue;
+}
+
+void VirtualArenaRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestVirtualArenaCommitsOnDemand_Success,
+                  "Virtual arena should commit pages on demand");
+  tm.RegisterTest(TestVirtualArenaDecommit_Success,
+                  "Virtual arena should decommit above the high-water mark");
+  tm.RegisterTest(TestVirtualArenaExhausted_Fails,
+                  "Virtual arena must fail past its reservation");
+  tm.RegisterTest(TestVirtualArenaLargePages_Success,
+                  "Virtual arena should align and commit in huge pages");
+}
+
+} // namespace tests
+} // namespace flatearth
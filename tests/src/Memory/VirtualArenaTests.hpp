@@ -0,0 +1,14 @@
+#ifndef _FLATEARTH_TESTS_VIRTUAL_ARENA_HPP
+#define _FLATEARTH_TESTS_VIRTUAL_ARENA_HPP
+
+#include "../TestManager.hpp"
+
+namespace flatearth {
+namespace tests {
+
+void VirtualArenaRegisterTests(TestManager &tm);
+
+}
+} // namespace flatearth
+
+#endif // _FLATEARTH_TESTS_VIRTUAL_ARENA_HPP
@@ -0,0 +1,103 @@
+#include "VulkanAllocatorTests.hpp"
+#include "../Expect.hpp"
+#include "../TestManager.hpp"
+
+#include <Core/FeMemory.hpp>
+#include <Renderer/Vulkan/VulkanAllocator.hpp>
+
+#include <cstdint>
+
+namespace flatearth {
+namespace tests {
+
+uchar TestVulkanAllocatorTracksScopes_Success() {
+  renderer::vulkan::VulkanAllocator allocator;
+  VkAllocationCallbacks *callbacks = allocator.GetCallbacks();
+  uint64 before = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_RENDERER];
+
+  void *object = callbacks->pfnAllocation(callbacks->pUserData, 200, 64,
+                                          VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+  ASSERT_NEQ_PTR(nullptr, object);
+  ASSERT_EQ_INT(0, reinterpret_cast<uintptr_t>(object) % 64);
+  ASSERT_EQ_INT(200, allocator.GetAllocatedSize(
+                         VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+  ASSERT_EQ_INT(1, allocator.GetAllocationCount(
+                       VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+
+  uint64 during = core::memory::MemoryManager::GetStats()
+                      .taggedAllocations[core::memory::MEMORY_TAG_RENDERER];
+  ASSERT_TRUE(during >= before + 200);
+
+  core::memory::MemoryManager::SetMemory(object, 7, 200);
+  void *grown = callbacks->pfnReallocation(
+      callbacks->pUserData, object, 4000, 64, VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);
+  ASSERT_NEQ_PTR(nullptr, grown);
+  ASSERT_EQ_INT(7, static_cast<uchar *>(grown)[199]);
+  ASSERT_EQ_INT(4000, allocator.GetAllocatedSize(
+                          VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+
+  callbacks->pfnFree(callbacks->pUserData, grown);
+  callbacks->pfnFree(callbacks->pUserData, nullptr);
+  ASSERT_EQ_INT(0, allocator.GetAllocatedSize(
+                       VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+
+  callbacks->pfnInternalAllocation(callbacks->pUserData, 512,
+                                   VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE,
+                                   VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+  ASSERT_EQ_INT(512, allocator.GetInternalAllocatedSize());
+  callbacks->pfnInternalFree(callbacks->pUserData, 512,
+                             VK_INTERNAL_ALLOCATION_TYPE_EXECUTABLE,
+                             VK_SYSTEM_ALLOCATION_SCOPE_DEVICE);
+  ASSERT_EQ_INT(0, allocator.GetInternalAllocatedSize());
+
+  uint64 after = core::memory::MemoryManager::GetStats()
+                     .taggedAllocations[core::memory::MEMORY_TAG_RENDERER];
+  ASSERT_EQ_INT(before, after);
+
+  return FeTrue;
+}
+
+uchar TestVulkanAllocatorCommandArena_Success() {
+  constexpr uint64 arenaSize = 4096;
+  renderer::vulkan::VulkanAllocator allocator(arenaSize);
+  VkAllocationCallbacks *callbacks = allocator.GetCallbacks();
+
+  void *first = callbacks->pfnAllocation(callbacks->pUserData, 100, 8,
+                                         VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+  void *second = callbacks->pfnAllocation(callbacks->pUserData, 100, 8,
+                                          VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+  ASSERT_NEQ_PTR(nullptr, first);
+  ASSERT_NEQ_PTR(nullptr, second);
+  ASSERT_EQ_INT(0, allocator.GetCommandArenaFallbackCount());
+
+  // Too big for the arena, served by the MemoryManager instead
+  void *large = callbacks->pfnAllocation(callbacks->pUserData, arenaSize * 2,
+                                         8, VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+  ASSERT_NEQ_PTR(nullptr, large);
+  ASSERT_EQ_INT(1, allocator.GetCommandArenaFallbackCount());
+  callbacks->pfnFree(callbacks->pUserData, large);
+
+  // The arena rewinds once every command block is gone
+  callbacks->pfnFree(callbacks->pUserData, second);
+  callbacks->pfnFree(callbacks->pUserData, first);
+  ASSERT_EQ_INT(0, allocator.GetAllocatedSize(
+                       VK_SYSTEM_ALLOCATION_SCOPE_COMMAND));
+
+  void *reused = callbacks->pfnAllocation(callbacks->pUserData, 100, 8,
+                                          VK_SYSTEM_ALLOCATION_SCOPE_COMMAND);
+  ASSERT_EQ_PTR(first, reused);
+  callbacks->pfnFree(callbacks->pUserData, reused);
+
+  return FeTrue;
+}
+
+void VulkanAllocatorRegisterTests(TestManager &tm) {
+  tm.RegisterTest(TestVulkanAllocatorTracksScopes_Success,
+                  "Vulkan allocator should track allocations per scope");
+  tm.RegisterTest(TestVulkanAllocatorCommandArena_Success,
+                  "Vulkan allocator should serve command scope from an arena");
+}
+
+} // namespace tests
+} // namespace flatearth
@@ -1,7 +1,24 @@
 #include "Core/FeMemory.hpp"
+#include "Containers/BitSetTests.hpp"
 #include "Containers/DArrayTests.hpp"
+#include "Containers/HashMapTests.hpp"
+#include "Containers/RingQueueTests.hpp"
+#include "Containers/SArrayTests.hpp"
+#include "Containers/SlotMapTests.hpp"
+#include "Containers/SmallVectorTests.hpp"
+#include "Core/FeStringTests.hpp"
+#include "Core/StringIdTests.hpp"
 #include "TestManager.hpp"
+#include "Memory/AllocationTracerTests.hpp"
+#include "Memory/FrameAllocatorTests.hpp"
+#include "Memory/FreeListAllocatorTests.hpp"
 #include "Memory/LinearAllocatorTests.hpp"
+#include "Memory/MemoryManagerTests.hpp"
+#include "Memory/PoolAllocatorTests.hpp"
+#include "Memory/RelocatableHeapTests.hpp"
+#include "Memory/StackAllocatorTests.hpp"
+#include "Memory/VirtualArenaTests.hpp"
+#include "Renderer/VulkanAllocatorTests.hpp"
 
 #include <Core/Logger.hpp>
 
@@ -10,8 +27,25 @@ using namespace flatearth;
 int main() {
   tests::TestManager tm;
   core::memory::MemoryManager::TestPreload();
+  tests::MemoryManagerRegisterTests(tm);
   tests::LinearAllocatorRegisterTests(tm);
+  tests::FreeListAllocatorRegisterTests(tm);
+  tests::PoolAllocatorRegisterTests(tm);
+  tests::StackAllocatorRegisterTests(tm);
+  tests::FrameAllocatorRegisterTests(tm);
+  tests::VirtualArenaRegisterTests(tm);
+  tests::RelocatableHeapRegisterTests(tm);
+  tests::AllocationTracerRegisterTests(tm);
+  tests::VulkanAllocatorRegisterTests(tm);
   tests::DArrayRegisterTests(tm);
+  tests::SArrayRegisterTests(tm);
+  tests::SmallVectorRegisterTests(tm);
+  tests::HashMapRegisterTests(tm);
+  tests::RingQueueRegisterTests(tm);
+  tests::SlotMapRegisterTests(tm);
+  tests::BitSetRegisterTests(tm);
+  tests::StringIdRegisterTests(tm);
+  tests::FeStringRegisterTests(tm);
   FDEBUG("Starting tests...");
   tm.RunTests();
   return 0;
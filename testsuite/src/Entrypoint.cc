@@ -9,6 +9,7 @@ bool CreateGame(flatearth::gametypes::Game *gameOut) {
   gameOut->appConfig.startWidth = 1280;
   gameOut->appConfig.startHeight = 720;
   gameOut->appConfig.name = "Flatearth Engine Testsuite";
+  gameOut->appConfig.heapSize = 256 * 1024 * 1024;
 
   // Assign the function pointers
   gameOut->Initialize = flatearth::testsuite::GameTest::GameInitialize;
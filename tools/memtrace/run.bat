@@ -0,0 +1,37 @@
+@echo on
+
+:: ----------------------------------------------------------------------------
+::  Setup
+:: ----------------------------------------------------------------------------
+
+set buildDir=.\build
+
+rmdir /s /q %buildDir%
+
+echo ########################### BUILDING MEMTRACE TOOL ############################
+echo ###################### Checking if build directory exists #####################
+
+if not exist %buildDir% (
+    echo Making build directory...
+    mkdir %buildDir%
+) else (
+    echo Build directory exists!
+)
+
+echo Running "cmake .."
+pushd %buildDir%
+cmake -G "Visual Studio 17 2022" -DCMAKE_BUILD_TYPE=Debug ..
+popd
+
+echo ############################# CMAKE STEP ######################################
+
+echo Running CMake build...
+cmake --build build --config Debug
+
+:: Move the final tool executable into ../../bin
+echo Moving flatearth_memtrace.exe into ../../bin
+move /Y ".\build\Debug\flatearth_memtrace.exe" "..\..\bin\flatearth_memtrace.exe"
+
+echo ############################# FINISHED ########################################
+echo Memtrace executable created!
+
@@ -0,0 +1,287 @@
+// Offline viewer for the allocation traces written by
+// MemoryManager::StartTracing(). Prints a per-tag summary and the top
+// allocation sites, and optionally writes a per-tag timeline of live bytes
+// as CSV.
+//
+// usage: flatearth_memtrace <trace> [--timeline <out.csv>] [--bucket-ms <n>]
+//                           [--top <n>]
+
+#include <Memory/AllocationTracer.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <print>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace flatearth::memory;
+
+struct TraceFile {
+  std::vector<string> tagNames;
+  std::vector<AllocationTraceEvent> events;
+};
+
+struct TagSummary {
+  uint64 allocCount = 0;
+  uint64 freeCount = 0;
+  uint64 allocatedBytes = 0;
+  sint64 liveBytes = 0;
+  sint64 peakBytes = 0;
+};
+
+struct SiteSummary {
+  uint64 callsite = 0;
+  uchar tag = 0;
+  uint64 allocCount = 0;
+  uint64 allocatedBytes = 0;
+  // Allocated from this site and not freed by the end of the trace
+  uint64 liveBytes = 0;
+};
+
+struct LiveBlock {
+  uint64 size;
+  uint64 site;
+};
+
+struct Options {
+  string tracePath;
+  string timelinePath;
+  uint64 bucketMs = 10;
+  uint64 top = 20;
+};
+
+static bool ReadTrace(const string &path, TraceFile *trace) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    std::println(stderr, "could not open '{}'", path);
+    return FeFalse;
+  }
+
+  AllocationTraceHeader header = {};
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  if (!file || std::memcmp(header.magic, ALLOCATION_TRACE_MAGIC,
+                           sizeof(header.magic)) != 0) {
+    std::println(stderr, "'{}' is not an allocation trace", path);
+    return FeFalse;
+  }
+
+  if (header.version != ALLOCATION_TRACE_VERSION ||
+      header.eventSize != sizeof(AllocationTraceEvent)) {
+    std::println(stderr, "unsupported trace version {} (event size {})",
+                 header.version, header.eventSize);
+    return FeFalse;
+  }
+
+  std::vector<char> name(header.tagNameSize + 1, '\0');
+  for (uint32 i = 0; i < header.tagCount; i++) {
+    file.read(name.data(), header.tagNameSize);
+    trace->tagNames.emplace_back(name.data());
+  }
+
+  AllocationTraceEvent event;
+  while (file.read(reinterpret_cast<char *>(&event), sizeof(event))) {
+    trace->events.push_back(event);
+  }
+
+  if (!file.eof() || file.gcount() != 0) {
+    std::println(stderr, "trailing partial event ignored");
+  }
+
+  // Rings are flushed one after the other, restore the global order
+  std::stable_sort(trace->events.begin(), trace->events.end(),
+                   [](const AllocationTraceEvent &a,
+                      const AllocationTraceEvent &b) {
+                     return a.timestamp < b.timestamp;
+                   });
+  return FeTrue;
+}
+
+static const string &TagName(const TraceFile &trace, uchar tag) {
+  static const string unknown = "?";
+  return tag < trace.tagNames.size() ? trace.tagNames[tag] : unknown;
+}
+
+static bool WriteTimeline(const TraceFile &trace,
+                          const std::vector<TagSummary> &tags,
+                          const Options &options) {
+  std::ofstream file(options.timelinePath, std::ios::out | std::ios::trunc);
+  if (!file) {
+    std::println(stderr, "could not open '{}'", options.timelinePath);
+    return FeFalse;
+  }
+
+  // Only tags that saw any traffic get a column
+  std::vector<uchar> columns;
+  for (uint64 i = 0; i < tags.size(); i++) {
+    if (tags[i].allocCount > 0 || tags[i].freeCount > 0) {
+      columns.push_back((uchar)i);
+    }
+  }
+
+  file << "time_ms";
+  for (uchar tag : columns) {
+    file << "," << TagName(trace, tag);
+  }
+  file << "\n";
+
+  const uint64 bucketNs = std::max<uint64>(options.bucketMs, 1) * 1000000;
+  std::vector<sint64> live(tags.size(), 0);
+  uint64 bucketEnd = bucketNs;
+
+  auto writeRow = [&](uint64 end) {
+    file << end / 1000000;
+    for (uchar tag : columns) {
+      file << "," << live[tag];
+    }
+    file << "\n";
+  };
+
+  for (const AllocationTraceEvent &event : trace.events) {
+    while (event.timestamp >= bucketEnd) {
+      writeRow(bucketEnd);
+      bucketEnd += bucketNs;
+    }
+
+    if (event.tag >= live.size()) {
+      continue;
+    }
+
+    if (event.type == ALLOCATION_TRACE_ALLOCATE) {
+      live[event.tag] += event.size;
+    } else {
+      live[event.tag] -= event.size;
+    }
+  }
+  writeRow(bucketEnd);
+
+  return file.good();
+}
+
+static bool ParseOptions(int argc, char **argv, Options *options) {
+  for (int i = 1; i < argc; i++) {
+    string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--timeline" && hasValue) {
+      options->timelinePath = argv[++i];
+    } else if (arg == "--bucket-ms" && hasValue) {
+      options->bucketMs = std::stoull(argv[++i]);
+    } else if (arg == "--top" && hasValue) {
+      options->top = std::stoull(argv[++i]);
+    } else if (options->tracePath.empty() && arg[0] != '-') {
+      options->tracePath = arg;
+    } else {
+      return FeFalse;
+    }
+  }
+
+  return !options->tracePath.empty();
+}
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    std::println(stderr,
+                 "usage: {} <trace> [--timeline <out.csv>] [--bucket-ms <n>] "
+                 "[--top <n>]",
+                 argv[0]);
+    return 1;
+  }
+
+  TraceFile trace;
+  if (!ReadTrace(options.tracePath, &trace)) {
+    return 1;
+  }
+
+  std::vector<TagSummary> tags(std::max<uint64>(trace.tagNames.size(), 256));
+  std::unordered_map<uint64, SiteSummary> sites;
+  std::unordered_map<uint64, LiveBlock> liveBlocks;
+  std::unordered_set<uint32> threads;
+
+  for (const AllocationTraceEvent &event : trace.events) {
+    TagSummary &tag = tags[event.tag];
+    threads.insert(event.threadId);
+
+    if (event.type == ALLOCATION_TRACE_ALLOCATE) {
+      tag.allocCount++;
+      tag.allocatedBytes += event.size;
+      tag.liveBytes += event.size;
+      tag.peakBytes = std::max(tag.peakBytes, tag.liveBytes);
+
+      // Sites are told apart by tag as well, a shared helper such as a
+      // container serves several of them
+      uint64 key = event.callsite ^ ((uint64)event.tag << 56);
+      SiteSummary &site = sites[key];
+      site.callsite = event.callsite;
+      site.tag = event.tag;
+      site.allocCount++;
+      site.allocatedBytes += event.size;
+      site.liveBytes += event.size;
+
+      // Memory tracked without an address, e.g. committed pages
+      if (event.address != 0) {
+        liveBlocks[event.address] = {event.size, key};
+      }
+      continue;
+    }
+
+    tag.freeCount++;
+    tag.liveBytes -= event.size;
+
+    auto block = liveBlocks.find(event.address);
+    if (block != liveBlocks.end()) {
+      sites[block->second.site].liveBytes -= block->second.size;
+      liveBlocks.erase(block);
+    }
+  }
+
+  uint64 duration = trace.events.empty() ? 0 : trace.events.back().timestamp;
+  std::println("{} events from {} threads over {:.3f} ms", trace.events.size(),
+               threads.size(), duration / 1e6);
+
+  std::println("\n{:<17} {:>10} {:>10} {:>14} {:>14} {:>14}", "tag", "allocs",
+               "frees", "allocated", "peak", "live");
+  for (uint64 i = 0; i < tags.size(); i++) {
+    const TagSummary &tag = tags[i];
+    if (tag.allocCount == 0 && tag.freeCount == 0) {
+      continue;
+    }
+
+    std::println("{:<17} {:>10} {:>10} {:>14} {:>14} {:>14}",
+                 TagName(trace, (uchar)i), tag.allocCount, tag.freeCount,
+                 tag.allocatedBytes, tag.peakBytes, tag.liveBytes);
+  }
+
+  std::vector<SiteSummary> topSites;
+  for (const auto &[key, site] : sites) {
+    topSites.push_back(site);
+  }
+  std::sort(topSites.begin(), topSites.end(),
+            [](const SiteSummary &a, const SiteSummary &b) {
+              return a.allocatedBytes > b.allocatedBytes;
+            });
+  if (topSites.size() > options.top) {
+    topSites.resize(options.top);
+  }
+
+  std::println("\n{:<20} {:<17} {:>10} {:>14} {:>14}", "callsite", "tag",
+               "allocs", "allocated", "live");
+  for (const SiteSummary &site : topSites) {
+    string callsite =
+        site.callsite ? std::format("{:#018x}", site.callsite) : "(none)";
+    std::println("{:<20} {:<17} {:>10} {:>14} {:>14}", callsite,
+                 TagName(trace, site.tag), site.allocCount,
+                 site.allocatedBytes, site.liveBytes);
+  }
+
+  if (!options.timelinePath.empty()) {
+    if (!WriteTimeline(trace, tags, options)) {
+      return 1;
+    }
+    std::println("\ntimeline written to '{}'", options.timelinePath);
+  }
+
+  return 0;
+}